@@ -1,195 +1,2031 @@
 #include "crypto.h"
-#include <sodium.h>
+#include "crypto_backend.h"
 #include <string.h>
 #include <stdlib.h>
 
 #ifdef ESP32
 #include "esp_random.h"
+#elif defined(__linux__)
+#include <sys/random.h>
+#include <errno.h>
+#elif defined(__unix__)
+#include <stdio.h>
+#endif
+
+// Helper macro for min
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+// ============================================================================
+// Base58 implementation
+// ============================================================================
+// Numbers are converted through 32-bit limbs: base 58^5 on the text side
+// (five digits per limb) and base 2^32 on the binary side (four bytes per
+// limb), so every inner step is one 32x32->64 multiply-add instead of a
+// division per byte. Scratch space lives on the stack, never the heap.
+// 32- and 64-byte inputs (pubkeys, blockhashes, signatures, keypairs) take
+// fixed-size paths driven by precomputed radix tables.
+
+static const char base58_chars[] = BASE58_ALPHABET;
+
+#define BASE58_R5 656356768ULL   // 58^5, the text-side limb radix
+
+// Digit value of every byte, or -1 if it is not in the alphabet
+static const int8_t base58_map[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1,
+    -1,  9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+    -1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// Radix tables for the fixed-size paths. enc_table_N[i][j] is base-58^5
+// limb j of 2^(32*(words-1-i)); dec_table_N[i][j] is base-2^32 word j of
+// 58^(5*(limbs-1-i)). Both are most significant limb first.
+static const uint32_t base58_enc_table_32[8][9] = {
+    {          0U,     513735U,   77223048U,  437087610U,  300156666U,  605448490U,  214625350U,  141436834U,  379377856U },
+    {          0U,          0U,      78508U,  646269101U,  118408823U,   91512303U,  209184527U,  413102373U,  153715680U },
+    {          0U,          0U,          0U,      11997U,  486083817U,    3737691U,  294005210U,  247894721U,  289024608U },
+    {          0U,          0U,          0U,          0U,       1833U,  324463681U,  385795061U,  551597588U,   21339008U },
+    {          0U,          0U,          0U,          0U,          0U,        280U,  127692781U,  389432875U,  357132832U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,         42U,  537767569U,  410450016U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          6U,  356826688U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          1U }
+};
+
+static const uint32_t base58_enc_table_64[16][18] = {
+    {          0U,       2631U,  149457141U,  577092685U,  632289089U,   81912456U,  221591423U,  502967496U,  403284731U,
+       377738089U,  492128779U,     746799U,  366351977U,  190199623U,   38066284U,  526403762U,  650603058U,  454901440U },
+    {          0U,          0U,        402U,   68350375U,   30641941U,  266024478U,  208884256U,  571208415U,  337765723U,
+       215140626U,  129419325U,  480359048U,  398051646U,  635841659U,  214020719U,  136986618U,  626219915U,   49699360U },
+    {          0U,          0U,          0U,         61U,  295059608U,  141201404U,  517024870U,  239296485U,  527697587U,
+       212906911U,  453637228U,  467589845U,  144614682U,   45134568U,  184514320U,  644355351U,  104784612U,  308625792U },
+    {          0U,          0U,          0U,          0U,          9U,  256449755U,  500124311U,  479690581U,  372802935U,
+       413254725U,  487877412U,  520263169U,  176791855U,   78190744U,  291820402U,   74998585U,  496097732U,   59100544U },
+    {          0U,          0U,          0U,          0U,          0U,          1U,  285573662U,  455976778U,  379818553U,
+       100001224U,  448949512U,  109507367U,  117185012U,  347328982U,  522665809U,   36908802U,  577276849U,   64504928U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,  143945778U,  651677945U,
+       281429047U,  535878743U,  264290972U,  526964023U,  199595821U,  597442702U,  499113091U,  424550935U,  458949280U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,   21997789U,
+       294590275U,  148640294U,  595017589U,  210481832U,  404203788U,  574729546U,  160126051U,  430102516U,   44963712U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+         3361701U,  325788598U,   30977630U,  513969330U,  194569730U,  164019635U,  136596846U,  626087230U,  503769920U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,     513735U,   77223048U,  437087610U,  300156666U,  605448490U,  214625350U,  141436834U,  379377856U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,      78508U,  646269101U,  118408823U,   91512303U,  209184527U,  413102373U,  153715680U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,      11997U,  486083817U,    3737691U,  294005210U,  247894721U,  289024608U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,       1833U,  324463681U,  385795061U,  551597588U,   21339008U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,        280U,  127692781U,  389432875U,  357132832U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,          0U,         42U,  537767569U,  410450016U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,          0U,          0U,          6U,  356826688U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          1U }
+};
+
+static const uint32_t base58_dec_table_32[9][8] = {
+    {       1277U, 2650397687U, 3801011509U, 2074386530U, 3248244966U,  687255411U, 2959155456U,          0U },
+    {          0U,       8360U, 1184754854U, 3047609191U, 3418394749U,  132556120U, 1199103528U,          0U },
+    {          0U,          0U,      54706U, 2996985344U, 1834629191U, 3964963911U,  485140318U, 1073741824U },
+    {          0U,          0U,          0U,     357981U, 1476998812U, 3337178590U, 1483338760U, 4194304000U },
+    {          0U,          0U,          0U,          0U,    2342503U, 3052466824U, 2595180627U,   17825792U },
+    {          0U,          0U,          0U,          0U,          0U,   15328518U, 1933902296U, 4063920128U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,  100304420U, 3355157504U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,  656356768U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          1U }
+};
+
+static const uint32_t base58_dec_table_64[18][16] = {
+    {     249448U, 3719864065U,  173911550U, 4021557284U, 3115810883U, 2498525019U, 1035889824U,  627529458U, 3840888383U,
+      3728167192U, 2901437456U, 3863405776U, 1540739182U, 1570766848U,          0U,          0U },
+    {          0U,    1632305U, 1882780341U, 4128706713U, 1023671068U, 2618421812U, 2005415586U, 1062993857U, 3577221846U,
+      3960476767U, 1695615427U, 2597060712U,  669472826U,  104923136U,          0U,          0U },
+    {          0U,          0U,   10681231U, 1422956801U, 2406345166U, 4058671871U, 2143913881U, 4169135587U, 2414104418U,
+      2549553452U,  997594232U,  713340517U, 2290070198U, 1103833088U,          0U,          0U },
+    {          0U,          0U,          0U,   69894212U, 1038812943U, 1785020643U, 1285619000U, 2301468615U, 3492037905U,
+       314610629U, 2761740102U, 3410618104U, 1699516363U,  910779968U,          0U,          0U },
+    {          0U,          0U,          0U,          0U,  457363084U,  927569770U, 3976106370U, 1389513021U, 2107865525U,
+      3716679421U, 1828091393U, 2088408376U,  439156799U, 2579227194U,          0U,          0U },
+    {          0U,          0U,          0U,          0U,          0U, 2992822783U,  383623235U, 3862831115U,  112778334U,
+       339767049U, 1447250220U,  486575164U, 3495303162U, 2209946163U,  268435456U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          4U, 2404108010U, 2962826229U, 3998086794U,
+      1893006839U, 2266258239U, 1429430446U,  307953032U, 2361423716U,  176160768U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,         29U, 3596590989U, 3044036677U,
+      1332209423U, 1014420882U,  868688145U, 4264082837U, 3688771808U, 2485387264U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,        195U, 1054003707U,
+      3711696540U,  582574436U, 3549229270U, 1088536814U, 2338440092U, 1468637184U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,       1277U,
+      2650397687U, 3801011509U, 2074386530U, 3248244966U,  687255411U, 2959155456U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+            8360U, 1184754854U, 3047609191U, 3418394749U,  132556120U, 1199103528U,          0U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,      54706U, 2996985344U, 1834629191U, 3964963911U,  485140318U, 1073741824U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,     357981U, 1476998812U, 3337178590U, 1483338760U, 4194304000U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,    2342503U, 3052466824U, 2595180627U,   17825792U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,   15328518U, 1933902296U, 4063920128U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,  100304420U, 3355157504U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,          0U,  656356768U },
+    {          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,          0U,
+               0U,          0U,          0U,          0U,          0U,          0U,          1U }
+};
+
+// 2^512 in base 58^5, least significant limb first: the per-block
+// multiplier of the large-input engine (base58EncodeLarge)
+static const uint32_t base58_block_radix[18] = {
+    114698272U, 475011419U, 135769242U, 494394213U, 526051483U, 437394159U,
+     19598664U, 243715433U, 337219057U, 222507322U, 211243284U, 450400380U,
+    416249884U, 213548060U,  82779834U, 283734095U, 542475966U,     17217U
+};
+
+// Generic-path scratch sizes, derived from SOLDUINO_BASE58_MAX_BYTES.
+// log(256)/log(58) ~= 1.366 digits per byte, five digits per limb.
+#define BASE58_ENC_LIMBS ((SOLDUINO_BASE58_MAX_BYTES * 28) / 100 + 2)
+#define BASE58_DEC_LIMBS (SOLDUINO_BASE58_MAX_BYTES / 4 + 2)
+
+// Inputs longer than this go through the 64-byte block engine
+#define BASE58_LARGE_THRESHOLD 128
+
+// Write the five Base58 digits of a base-58^5 limb, most significant first
+static inline void base58EmitLimb(uint32_t limb, char* out) {
+    for (int k = 4; k >= 0; k--) {
+        out[k] = base58_chars[limb % 58];
+        limb /= 58;
+    }
+}
+
+// Write `zeros` literal '1's followed by the digits of `used` normalized,
+// least-significant-first base-58^5 limbs (top limb non-zero or used == 0).
+static size_t base58EmitLimbs(const uint32_t* limbs, size_t used, size_t zeros,
+                              char* output, size_t outputLen) {
+    // The top limb carries 1..5 significant digits, every other limb five
+    size_t topDigits = 0;
+    if (used > 0) {
+        for (uint32_t top = limbs[used - 1]; top != 0; top /= 58) {
+            topDigits++;
+        }
+    }
+    size_t outLen = zeros + topDigits + (used > 0 ? 5 * (used - 1) : 0);
+    if (outLen + 1 > outputLen) {
+        return 0;
+    }
+
+    memset(output, '1', zeros);
+    char* p = output + zeros;
+    if (used > 0) {
+        uint32_t top = limbs[used - 1];
+        for (size_t k = topDigits; k > 0; k--) {
+            p[k - 1] = base58_chars[top % 58];
+            top /= 58;
+        }
+        p += topDigits;
+        for (size_t j = used - 1; j > 0; j--) {
+            base58EmitLimb(limbs[j - 1], p);
+            p += 5;
+        }
+    }
+    output[outLen] = '\0';
+    return outLen;
+}
+
+// Shared tail of the fixed-size encoders: `raw` holds rawLen zero-padded
+// digits; drop the padding and restore one '1' per leading zero byte.
+static size_t base58FinishFixed(const char* raw, size_t rawLen, size_t zeros,
+                                char* output, size_t outputLen) {
+    size_t skip = 0;
+    while (skip < rawLen && raw[skip] == '1') {
+        skip++;
+    }
+    size_t len = zeros + (rawLen - skip);
+    if (len + 1 > outputLen) {
+        return 0;
+    }
+    memset(output, '1', zeros);
+    memcpy(output + zeros, raw + skip, rawLen - skip);
+    output[len] = '\0';
+    return len;
+}
+
+size_t base58Encode32(const uint8_t* data, char* output, size_t outputLen) {
+    if (!data || !output || outputLen == 0) {
+        return 0;
+    }
+
+    size_t zeros = 0;
+    while (zeros < 32 && data[zeros] == 0) {
+        zeros++;
+    }
+
+    uint32_t binary[8];
+    for (int i = 0; i < 8; i++) {
+        binary[i] = ((uint32_t)data[4 * i] << 24) | ((uint32_t)data[4 * i + 1] << 16) |
+                    ((uint32_t)data[4 * i + 2] << 8) | (uint32_t)data[4 * i + 3];
+    }
+
+    // Column sums stay below 2^64 for this table (checked offline), so the
+    // whole number is accumulated before a single carry pass.
+    uint64_t intermediate[9] = {0};
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 9; j++) {
+            intermediate[j] += (uint64_t)binary[i] * base58_enc_table_32[i][j];
+        }
+    }
+    for (int j = 8; j > 0; j--) {
+        intermediate[j - 1] += intermediate[j] / BASE58_R5;
+        intermediate[j] %= BASE58_R5;
+    }
+
+    char raw[45];
+    for (int j = 0; j < 9; j++) {
+        base58EmitLimb((uint32_t)intermediate[j], raw + 5 * j);
+    }
+    return base58FinishFixed(raw, sizeof(raw), zeros, output, outputLen);
+}
+
+// Convert one 64-byte big-endian value into 18 normalized base-58^5 limbs,
+// most significant first. Shared by base58Encode64 and the block engine.
+static void base58Limbs64(const uint8_t* data, uint64_t intermediate[18]) {
+    uint32_t binary[16];
+    for (int i = 0; i < 16; i++) {
+        binary[i] = ((uint32_t)data[4 * i] << 24) | ((uint32_t)data[4 * i + 1] << 16) |
+                    ((uint32_t)data[4 * i + 2] << 8) | (uint32_t)data[4 * i + 3];
+    }
+
+    // Sixteen words would overflow the 64-bit column sums, so the upper and
+    // lower halves are accumulated separately with a carry pass in between.
+    memset(intermediate, 0, 18 * sizeof(uint64_t));
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 18; j++) {
+            intermediate[j] += (uint64_t)binary[i] * base58_enc_table_64[i][j];
+        }
+    }
+    for (int j = 17; j > 0; j--) {
+        intermediate[j - 1] += intermediate[j] / BASE58_R5;
+        intermediate[j] %= BASE58_R5;
+    }
+    for (int i = 8; i < 16; i++) {
+        for (int j = 0; j < 18; j++) {
+            intermediate[j] += (uint64_t)binary[i] * base58_enc_table_64[i][j];
+        }
+    }
+    for (int j = 17; j > 0; j--) {
+        intermediate[j - 1] += intermediate[j] / BASE58_R5;
+        intermediate[j] %= BASE58_R5;
+    }
+}
+
+size_t base58Encode64(const uint8_t* data, char* output, size_t outputLen) {
+    if (!data || !output || outputLen == 0) {
+        return 0;
+    }
+
+    size_t zeros = 0;
+    while (zeros < 64 && data[zeros] == 0) {
+        zeros++;
+    }
+
+    uint64_t intermediate[18];
+    base58Limbs64(data, intermediate);
+
+    char raw[90];
+    for (int j = 0; j < 18; j++) {
+        base58EmitLimb((uint32_t)intermediate[j], raw + 5 * j);
+    }
+    return base58FinishFixed(raw, sizeof(raw), zeros, output, outputLen);
+}
+
+// Shared front half of the fixed-size decoders: validate the string and
+// pack it, left-padded with zero digits, into `limbCount` base-58^5 limbs.
+static bool base58PackFixed(const char* input, size_t maxChars, uint32_t* limbs, size_t limbCount,
+                            size_t& inputLen, size_t& ones) {
+    inputLen = 0;
+    while (input[inputLen] != '\0') {
+        if (inputLen >= maxChars || base58_map[(uint8_t)input[inputLen]] < 0) {
+            return false;
+        }
+        inputLen++;
+    }
+    if (inputLen == 0) {
+        return false;
+    }
+
+    ones = 0;
+    while (ones < inputLen && input[ones] == '1') {
+        ones++;
+    }
+
+    size_t pad = limbCount * 5 - inputLen;
+    for (size_t j = 0; j < limbCount; j++) {
+        uint32_t limb = 0;
+        for (size_t k = 0; k < 5; k++) {
+            size_t pos = j * 5 + k;
+            limb = limb * 58 + (pos < pad ? 0 : (uint32_t)base58_map[(uint8_t)input[pos - pad]]);
+        }
+        limbs[j] = limb;
+    }
+    return true;
+}
+
+// Shared tail of the fixed-size decoders: emit big-endian bytes and require
+// the leading zero bytes to match the leading '1's exactly.
+static bool base58UnpackFixed(const uint64_t* binary, size_t words, size_t ones, uint8_t* output) {
+    size_t zeros = 0;
+    for (size_t i = 0; i < words; i++) {
+        uint32_t w = (uint32_t)binary[i];
+        output[4 * i] = (uint8_t)(w >> 24);
+        output[4 * i + 1] = (uint8_t)(w >> 16);
+        output[4 * i + 2] = (uint8_t)(w >> 8);
+        output[4 * i + 3] = (uint8_t)w;
+    }
+    while (zeros < words * 4 && output[zeros] == 0) {
+        zeros++;
+    }
+    return zeros == ones;
+}
+
+bool base58Decode32(const char* input, uint8_t* output) {
+    if (!input || !output) {
+        return false;
+    }
+
+    uint32_t intermediate[9];
+    size_t inputLen, ones;
+    if (!base58PackFixed(input, BASE58_ENCODED_32_LEN, intermediate, 9, inputLen, ones)) {
+        return false;
+    }
+
+    uint64_t binary[8] = {0};
+    for (int i = 0; i < 9; i++) {
+        for (int j = 0; j < 8; j++) {
+            binary[j] += (uint64_t)intermediate[i] * base58_dec_table_32[i][j];
+        }
+    }
+    for (int j = 7; j > 0; j--) {
+        binary[j - 1] += binary[j] >> 32;
+        binary[j] &= 0xFFFFFFFFULL;
+    }
+    // Anything left above the top word means the value exceeds 2^256
+    if (binary[0] > 0xFFFFFFFFULL) {
+        return false;
+    }
+
+    uint8_t decoded[32];
+    if (!base58UnpackFixed(binary, 8, ones, decoded)) {
+        return false;
+    }
+    memcpy(output, decoded, 32);
+    return true;
+}
+
+bool base58Decode64(const char* input, uint8_t* output) {
+    if (!input || !output) {
+        return false;
+    }
+
+    uint32_t intermediate[18];
+    size_t inputLen, ones;
+    if (!base58PackFixed(input, BASE58_ENCODED_64_LEN, intermediate, 18, inputLen, ones)) {
+        return false;
+    }
+
+    uint64_t binary[16] = {0};
+    for (int i = 0; i < 18; i++) {
+        for (int j = 0; j < 16; j++) {
+            binary[j] += (uint64_t)intermediate[i] * base58_dec_table_64[i][j];
+        }
+    }
+    for (int j = 15; j > 0; j--) {
+        binary[j - 1] += binary[j] >> 32;
+        binary[j] &= 0xFFFFFFFFULL;
+    }
+    if (binary[0] > 0xFFFFFFFFULL) {
+        return false;
+    }
+
+    uint8_t decoded[64];
+    if (!base58UnpackFixed(binary, 16, ones, decoded)) {
+        return false;
+    }
+    memcpy(output, decoded, 64);
+    return true;
+}
+
+size_t base58Encode(const uint8_t* data, size_t len, char* output, size_t outputLen) {
+    if (!data || !output || len == 0 || outputLen == 0) {
+        return 0;
+    }
+    if (len == 32) {
+        return base58Encode32(data, output, outputLen);
+    }
+    if (len == 64) {
+        return base58Encode64(data, output, outputLen);
+    }
+    if (len > BASE58_LARGE_THRESHOLD) {
+        return base58EncodeLarge(data, len, output, outputLen);
+    }
+
+    // Count leading zeros; each becomes a literal '1'
+    size_t zeros = 0;
+    while (zeros < len && data[zeros] == 0) {
+        zeros++;
+    }
+    if (len - zeros > SOLDUINO_BASE58_MAX_BYTES) {
+        return 0;
+    }
+
+    // Fold the input into little-endian base-58^5 limbs, up to four bytes
+    // per step (the first step takes the (len - zeros) % 4 leftover bytes).
+    uint32_t limbs[BASE58_ENC_LIMBS];
+    size_t used = 0;
+    size_t i = zeros;
+    size_t take = (len - zeros) % 4;
+    if (take == 0) take = 4;
+    while (i < len) {
+        uint64_t carry = 0;
+        for (size_t k = 0; k < take; k++) {
+            carry = (carry << 8) | data[i++];
+        }
+        uint64_t radix = (uint64_t)1 << (8 * take);
+        for (size_t j = 0; j < used; j++) {
+            uint64_t t = (uint64_t)limbs[j] * radix + carry;
+            limbs[j] = (uint32_t)(t % BASE58_R5);
+            carry = t / BASE58_R5;
+        }
+        while (carry != 0) {
+            if (used >= BASE58_ENC_LIMBS) return 0;
+            limbs[used++] = (uint32_t)(carry % BASE58_R5);
+            carry /= BASE58_R5;
+        }
+        take = 4;
+    }
+
+    return base58EmitLimbs(limbs, used, zeros, output, outputLen);
+}
+
+size_t base58EncodeLarge(const uint8_t* data, size_t len, char* output, size_t outputLen) {
+    if (!data || !output || len == 0 || outputLen == 0) {
+        return 0;
+    }
+
+    size_t zeros = 0;
+    while (zeros < len && data[zeros] == 0) {
+        zeros++;
+    }
+    size_t rest = len - zeros;
+    if (rest > SOLDUINO_BASE58_MAX_BYTES) {
+        return 0;
+    }
+
+    // Horner's rule over 64-byte blocks: acc = acc * 2^512 + block. Each
+    // block costs 18 multiply-adds per limb but only one division, and the
+    // block itself is converted by the fixed 64-byte path. The multiply runs
+    // in place, bottom-up; `window` keeps the last 18 pre-multiply limbs
+    // twice over so column k reads them as one contiguous run.
+    uint32_t limbs[BASE58_ENC_LIMBS + 18];
+    uint32_t window[36];
+    size_t used = 0;
+    const uint8_t* p = data + zeros;
+    size_t take = rest % 64;
+    if (take == 0) take = 64;
+
+    while (rest > 0) {
+        uint8_t block[64];
+        memset(block, 0, 64 - take);
+        memcpy(block + 64 - take, p, take);
+        p += take;
+        rest -= take;
+        take = 64;
+
+        uint64_t blockLimbs[18];
+        base58Limbs64(block, blockLimbs);
+
+        // The product fits in used + 18 limbs because 2^512 < 58^90
+        size_t outUsed = used + 18;
+        uint64_t carry = 0;
+        for (size_t k = 0; k < outUsed; k++) {
+            size_t slot = k % 18;
+            window[slot] = window[slot + 18] = (k < used) ? limbs[k] : 0;
+
+            uint64_t col = carry + (k < 18 ? blockLimbs[17 - k] : 0);
+            const uint32_t* w = window + slot + 18;
+            size_t terms = (k < 17) ? k + 1 : 18;
+            for (size_t j = 0; j < terms; j++) {
+                col += (uint64_t)*(w - j) * base58_block_radix[j];
+            }
+            limbs[k] = (uint32_t)(col % BASE58_R5);
+            carry = col / BASE58_R5;
+        }
+        used = outUsed;
+        while (used > 0 && limbs[used - 1] == 0) {
+            used--;
+        }
+    }
+
+    return base58EmitLimbs(limbs, used, zeros, output, outputLen);
+}
+
+size_t base58Decode(const char* input, uint8_t* output, size_t outputLen) {
+    if (!input || !output || outputLen == 0) {
+        return 0;
+    }
+
+    size_t inputLen = strlen(input);
+    if (inputLen == 0) return 0;
+
+    // Count leading ones; each decodes to a literal zero byte
+    size_t zeros = 0;
+    while (zeros < inputLen && input[zeros] == '1') {
+        zeros++;
+    }
+
+    // Fold the digits into little-endian base-2^32 limbs, up to five digits
+    // per step (the first step takes the (inputLen - zeros) % 5 leftovers).
+    uint32_t limbs[BASE58_DEC_LIMBS];
+    size_t used = 0;
+    size_t i = zeros;
+    size_t take = (inputLen - zeros) % 5;
+    if (take == 0) take = 5;
+    while (i < inputLen) {
+        uint64_t carry = 0;
+        uint64_t radix = 1;
+        for (size_t k = 0; k < take; k++) {
+            int8_t digit = base58_map[(uint8_t)input[i++]];
+            if (digit < 0) return 0;
+            carry = carry * 58 + (uint64_t)digit;
+            radix *= 58;
+        }
+        for (size_t j = 0; j < used; j++) {
+            uint64_t t = (uint64_t)limbs[j] * radix + carry;
+            limbs[j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        while (carry != 0) {
+            if (used >= BASE58_DEC_LIMBS) return 0;
+            limbs[used++] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        take = 5;
+    }
+
+    size_t topBytes = 0;
+    if (used > 0) {
+        for (uint32_t top = limbs[used - 1]; top != 0; top >>= 8) {
+            topBytes++;
+        }
+    }
+    size_t resultLen = zeros + topBytes + (used > 0 ? 4 * (used - 1) : 0);
+    if (resultLen > outputLen) {
+        return 0;
+    }
+
+    memset(output, 0, outputLen);
+    uint8_t* p = output + resultLen;
+    for (size_t j = 0; j < used; j++) {
+        uint32_t limb = limbs[j];
+        size_t n = (j + 1 == used) ? topBytes : 4;
+        for (size_t k = 0; k < n; k++) {
+            *--p = (uint8_t)limb;
+            limb >>= 8;
+        }
+    }
+    return resultLen;
+}
+
+// ============================================================================
+// Ed25519 curve membership
+// ============================================================================
+// Field elements mod p = 2^255 - 19 in signed limbs. Hosts with 128-bit
+// integers use five 51-bit limbs; everything else uses ten limbs of
+// alternating 26/25 bits (the ref10 layout), so every product is a
+// 32x32->64 multiply on 32-bit targets. isOnCurve() needs only the field;
+// batch verification below adds point arithmetic on top.
+
+#if defined(__SIZEOF_INT128__)
+
+#define FE_LIMBS 5
+typedef int64_t fe25519[FE_LIMBS];
+typedef __int128 feWide;
+
+static const uint8_t FE_BITS[FE_LIMBS] = {51, 51, 51, 51, 51};
+
+// Edwards curve constant d = -121665/121666 mod p
+static const fe25519 FE_D = {
+    929955233495203, 466365720129213, 1662059464998953, 2033849074728123, 1442794654840575
+};
+
 #else
-#include <time.h>
+
+#define FE_LIMBS 10
+typedef int32_t fe25519[FE_LIMBS];
+typedef int64_t feWide;
+
+static const uint8_t FE_BITS[FE_LIMBS] = {26, 25, 26, 25, 26, 25, 26, 25, 26, 25};
+
+// Edwards curve constant d = -121665/121666 mod p
+static const fe25519 FE_D = {
+    56195235, 13857412, 51736253, 6949390, 114729,
+    24766616, 60832955, 30306712, 48412415, 21499315
+};
+
 #endif
 
-// Helper macro for min
-#ifndef min
-#define min(a, b) ((a) < (b) ? (a) : (b))
-#endif
+// Load 255 little-endian bits; like curve25519-dalek, the top bit is
+// ignored and values >= p are accepted (they reduce naturally).
+static void feFromBytes(fe25519 h, const uint8_t* s) {
+    uint32_t offset = 0;
+    for (int k = 0; k < FE_LIMBS; k++) {
+        uint64_t window = 0;
+        for (uint32_t b = 0; b < 8 && offset / 8 + b < 32; b++) {
+            window |= (uint64_t)s[offset / 8 + b] << (8 * b);
+        }
+        h[k] = (window >> (offset % 8)) & (((uint64_t)1 << FE_BITS[k]) - 1);
+        offset += FE_BITS[k];
+    }
+}
+
+// Move the excess of limb k into limb k+1 (the top limb wraps into limb 0
+// times 19, since 2^255 = 19 mod p), leaving limb k centered around zero.
+static inline void feCarry(feWide* t, int k) {
+    int bits = FE_BITS[k];
+    feWide c = (t[k] + ((feWide)1 << (bits - 1))) >> bits;
+    t[k] -= c * ((feWide)1 << bits);
+    if (k == FE_LIMBS - 1) {
+        t[0] += c * 19;
+    } else {
+        t[k + 1] += c;
+    }
+}
+
+#if defined(__SIZEOF_INT128__)
+
+static inline void feCarryProduct(fe25519 h, feWide t[FE_LIMBS]) {
+    feCarry(t, 0); feCarry(t, 1); feCarry(t, 2);
+    feCarry(t, 3); feCarry(t, 4); feCarry(t, 0);
+    for (int k = 0; k < FE_LIMBS; k++) {
+        h[k] = (int64_t)t[k];
+    }
+}
+
+static void feMul(fe25519 h, const fe25519 f, const fe25519 g) {
+    int64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    int64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+    int64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    feWide t[FE_LIMBS];
+    t[0] = (feWide)f0 * g0 + (feWide)f1 * g4_19 + (feWide)f2 * g3_19 + (feWide)f3 * g2_19 + (feWide)f4 * g1_19;
+    t[1] = (feWide)f0 * g1 + (feWide)f1 * g0 + (feWide)f2 * g4_19 + (feWide)f3 * g3_19 + (feWide)f4 * g2_19;
+    t[2] = (feWide)f0 * g2 + (feWide)f1 * g1 + (feWide)f2 * g0 + (feWide)f3 * g4_19 + (feWide)f4 * g3_19;
+    t[3] = (feWide)f0 * g3 + (feWide)f1 * g2 + (feWide)f2 * g1 + (feWide)f3 * g0 + (feWide)f4 * g4_19;
+    t[4] = (feWide)f0 * g4 + (feWide)f1 * g3 + (feWide)f2 * g2 + (feWide)f3 * g1 + (feWide)f4 * g0;
+
+    feCarryProduct(h, t);
+}
+
+static void feSq(fe25519 h, const fe25519 f) {
+    int64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    int64_t f0_2 = 2 * f0, f1_2 = 2 * f1, f2_2 = 2 * f2;
+    int64_t f3_19 = 19 * f3, f4_19 = 19 * f4;
+
+    feWide t[FE_LIMBS];
+    t[0] = (feWide)f0 * f0 + (feWide)f1_2 * f4_19 + (feWide)f2_2 * f3_19;
+    t[1] = (feWide)f0_2 * f1 + (feWide)f2_2 * f4_19 + (feWide)f3 * f3_19;
+    t[2] = (feWide)f0_2 * f2 + (feWide)f1 * f1 + (feWide)(2 * f3) * f4_19;
+    t[3] = (feWide)f0_2 * f3 + (feWide)f1_2 * f2 + (feWide)f4 * f4_19;
+    t[4] = (feWide)f0_2 * f4 + (feWide)f1_2 * f3 + (feWide)f2 * f2;
+
+    feCarryProduct(h, t);
+}
+
+#else
+
+// Interleaved carry order from ref10 keeps every step within 64 bits.
+// Written out so each feCarry() sees a constant limb index.
+static inline void feCarryProduct(fe25519 h, int64_t t[10]) {
+    feCarry(t, 0); feCarry(t, 4);
+    feCarry(t, 1); feCarry(t, 5);
+    feCarry(t, 2); feCarry(t, 6);
+    feCarry(t, 3); feCarry(t, 7);
+    feCarry(t, 4); feCarry(t, 8);
+    feCarry(t, 9); feCarry(t, 0);
+    for (int k = 0; k < 10; k++) {
+        h[k] = (int32_t)t[k];
+    }
+}
+
+static void feMul(fe25519 h, const fe25519 f, const fe25519 g) {
+    int32_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    int32_t f5 = f[5], f6 = f[6], f7 = f[7], f8 = f[8], f9 = f[9];
+    int32_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+    int32_t g5 = g[5], g6 = g[6], g7 = g[7], g8 = g[8], g9 = g[9];
+    // Two odd (25-bit) positions meet at half a bit too low: double;
+    // anything past limb 9 wraps around times 19
+    int32_t f1_2 = 2 * f1, f3_2 = 2 * f3, f5_2 = 2 * f5, f7_2 = 2 * f7, f9_2 = 2 * f9;
+    int32_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4, g5_19 = 19 * g5;
+    int32_t g6_19 = 19 * g6, g7_19 = 19 * g7, g8_19 = 19 * g8, g9_19 = 19 * g9;
+
+    int64_t t[10];
+    t[0] = (int64_t)f0 * g0 + (int64_t)f1_2 * g9_19 + (int64_t)f2 * g8_19 + (int64_t)f3_2 * g7_19
+           + (int64_t)f4 * g6_19 + (int64_t)f5_2 * g5_19 + (int64_t)f6 * g4_19 + (int64_t)f7_2 * g3_19
+           + (int64_t)f8 * g2_19 + (int64_t)f9_2 * g1_19;
+    t[1] = (int64_t)f0 * g1 + (int64_t)f1 * g0 + (int64_t)f2 * g9_19 + (int64_t)f3 * g8_19
+           + (int64_t)f4 * g7_19 + (int64_t)f5 * g6_19 + (int64_t)f6 * g5_19 + (int64_t)f7 * g4_19
+           + (int64_t)f8 * g3_19 + (int64_t)f9 * g2_19;
+    t[2] = (int64_t)f0 * g2 + (int64_t)f1_2 * g1 + (int64_t)f2 * g0 + (int64_t)f3_2 * g9_19
+           + (int64_t)f4 * g8_19 + (int64_t)f5_2 * g7_19 + (int64_t)f6 * g6_19 + (int64_t)f7_2 * g5_19
+           + (int64_t)f8 * g4_19 + (int64_t)f9_2 * g3_19;
+    t[3] = (int64_t)f0 * g3 + (int64_t)f1 * g2 + (int64_t)f2 * g1 + (int64_t)f3 * g0
+           + (int64_t)f4 * g9_19 + (int64_t)f5 * g8_19 + (int64_t)f6 * g7_19 + (int64_t)f7 * g6_19
+           + (int64_t)f8 * g5_19 + (int64_t)f9 * g4_19;
+    t[4] = (int64_t)f0 * g4 + (int64_t)f1_2 * g3 + (int64_t)f2 * g2 + (int64_t)f3_2 * g1
+           + (int64_t)f4 * g0 + (int64_t)f5_2 * g9_19 + (int64_t)f6 * g8_19 + (int64_t)f7_2 * g7_19
+           + (int64_t)f8 * g6_19 + (int64_t)f9_2 * g5_19;
+    t[5] = (int64_t)f0 * g5 + (int64_t)f1 * g4 + (int64_t)f2 * g3 + (int64_t)f3 * g2
+           + (int64_t)f4 * g1 + (int64_t)f5 * g0 + (int64_t)f6 * g9_19 + (int64_t)f7 * g8_19
+           + (int64_t)f8 * g7_19 + (int64_t)f9 * g6_19;
+    t[6] = (int64_t)f0 * g6 + (int64_t)f1_2 * g5 + (int64_t)f2 * g4 + (int64_t)f3_2 * g3
+           + (int64_t)f4 * g2 + (int64_t)f5_2 * g1 + (int64_t)f6 * g0 + (int64_t)f7_2 * g9_19
+           + (int64_t)f8 * g8_19 + (int64_t)f9_2 * g7_19;
+    t[7] = (int64_t)f0 * g7 + (int64_t)f1 * g6 + (int64_t)f2 * g5 + (int64_t)f3 * g4
+           + (int64_t)f4 * g3 + (int64_t)f5 * g2 + (int64_t)f6 * g1 + (int64_t)f7 * g0
+           + (int64_t)f8 * g9_19 + (int64_t)f9 * g8_19;
+    t[8] = (int64_t)f0 * g8 + (int64_t)f1_2 * g7 + (int64_t)f2 * g6 + (int64_t)f3_2 * g5
+           + (int64_t)f4 * g4 + (int64_t)f5_2 * g3 + (int64_t)f6 * g2 + (int64_t)f7_2 * g1
+           + (int64_t)f8 * g0 + (int64_t)f9_2 * g9_19;
+    t[9] = (int64_t)f0 * g9 + (int64_t)f1 * g8 + (int64_t)f2 * g7 + (int64_t)f3 * g6
+           + (int64_t)f4 * g5 + (int64_t)f5 * g4 + (int64_t)f6 * g3 + (int64_t)f7 * g2
+           + (int64_t)f8 * g1 + (int64_t)f9 * g0;
+
+    feCarryProduct(h, t);
+}
+
+// Squaring: each cross product appears twice, so only 55 multiplies
+static void feSq(fe25519 h, const fe25519 f) {
+    int32_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+    int32_t f5 = f[5], f6 = f[6], f7 = f[7], f8 = f[8], f9 = f[9];
+    int32_t f0_2 = 2 * f0, f1_2 = 2 * f1, f2_2 = 2 * f2, f3_2 = 2 * f3, f4_2 = 2 * f4, f5_2 = 2 * f5, f6_2 = 2 * f6, f7_2 = 2 * f7, f8_2 = 2 * f8, f9_2 = 2 * f9;
+    int32_t f1_4 = 4 * f1, f3_4 = 4 * f3, f5_4 = 4 * f5, f7_4 = 4 * f7;
+    int32_t f5_19 = 19 * f5, f6_19 = 19 * f6, f7_19 = 19 * f7, f8_19 = 19 * f8, f9_19 = 19 * f9;
+
+    int64_t t[10];
+    t[0] = (int64_t)f0 * f0 + (int64_t)f1_4 * f9_19 + (int64_t)f2_2 * f8_19 + (int64_t)f3_4 * f7_19
+           + (int64_t)f4_2 * f6_19 + (int64_t)f5_2 * f5_19;
+    t[1] = (int64_t)f0_2 * f1 + (int64_t)f2_2 * f9_19 + (int64_t)f3_2 * f8_19 + (int64_t)f4_2 * f7_19
+           + (int64_t)f5_2 * f6_19;
+    t[2] = (int64_t)f0_2 * f2 + (int64_t)f1_2 * f1 + (int64_t)f3_4 * f9_19 + (int64_t)f4_2 * f8_19
+           + (int64_t)f5_4 * f7_19 + (int64_t)f6 * f6_19;
+    t[3] = (int64_t)f0_2 * f3 + (int64_t)f1_2 * f2 + (int64_t)f4_2 * f9_19 + (int64_t)f5_2 * f8_19
+           + (int64_t)f6_2 * f7_19;
+    t[4] = (int64_t)f0_2 * f4 + (int64_t)f1_4 * f3 + (int64_t)f2 * f2 + (int64_t)f5_4 * f9_19
+           + (int64_t)f6_2 * f8_19 + (int64_t)f7_2 * f7_19;
+    t[5] = (int64_t)f0_2 * f5 + (int64_t)f1_2 * f4 + (int64_t)f2_2 * f3 + (int64_t)f6_2 * f9_19
+           + (int64_t)f7_2 * f8_19;
+    t[6] = (int64_t)f0_2 * f6 + (int64_t)f1_4 * f5 + (int64_t)f2_2 * f4 + (int64_t)f3_2 * f3
+           + (int64_t)f7_4 * f9_19 + (int64_t)f8 * f8_19;
+    t[7] = (int64_t)f0_2 * f7 + (int64_t)f1_2 * f6 + (int64_t)f2_2 * f5 + (int64_t)f3_2 * f4
+           + (int64_t)f8_2 * f9_19;
+    t[8] = (int64_t)f0_2 * f8 + (int64_t)f1_4 * f7 + (int64_t)f2_2 * f6 + (int64_t)f3_4 * f5
+           + (int64_t)f4 * f4 + (int64_t)f9_2 * f9_19;
+    t[9] = (int64_t)f0_2 * f9 + (int64_t)f1_2 * f8 + (int64_t)f2_2 * f7 + (int64_t)f3_2 * f6
+           + (int64_t)f4_2 * f5;
+
+    feCarryProduct(h, t);
+}
+
+#endif
+
+static void feSqN(fe25519 h, const fe25519 f, int n) {
+    feSq(h, f);
+    for (int i = 1; i < n; i++) {
+        feSq(h, h);
+    }
+}
+
+// z^(2^252 - 3), the standard ed25519 addition chain
+static void fePow22523(fe25519 out, const fe25519 z) {
+    fe25519 t0, t1, t2;
+    feSq(t0, z);                // 2
+    feSqN(t1, t0, 2);           // 8
+    feMul(t1, z, t1);           // 9
+    feMul(t0, t0, t1);          // 11
+    feSq(t0, t0);               // 22
+    feMul(t0, t1, t0);          // 2^5 - 1
+    feSqN(t1, t0, 5);
+    feMul(t0, t1, t0);          // 2^10 - 1
+    feSqN(t1, t0, 10);
+    feMul(t1, t1, t0);          // 2^20 - 1
+    feSqN(t2, t1, 20);
+    feMul(t1, t2, t1);          // 2^40 - 1
+    feSqN(t1, t1, 10);
+    feMul(t0, t1, t0);          // 2^50 - 1
+    feSqN(t1, t0, 50);
+    feMul(t1, t1, t0);          // 2^100 - 1
+    feSqN(t2, t1, 100);
+    feMul(t1, t2, t1);          // 2^200 - 1
+    feSqN(t1, t1, 50);
+    feMul(t0, t1, t0);          // 2^250 - 1
+    feSqN(t0, t0, 2);           // 2^252 - 4
+    feMul(out, t0, z);          // 2^252 - 3
+}
+
+// Fully reduce a carried element and write its canonical 32-byte encoding
+static void feToBytes(uint8_t* s, const fe25519 f) {
+    int64_t h[FE_LIMBS];
+    for (int k = 0; k < FE_LIMBS; k++) {
+        h[k] = f[k];
+    }
+
+    // q = 1 exactly when the value is >= p: fold 19q in and drop bit 255
+    const int top = FE_LIMBS - 1;
+    int64_t q = (19 * h[top] + ((int64_t)1 << (FE_BITS[top] - 1))) >> FE_BITS[top];
+    for (int k = 0; k < FE_LIMBS; k++) {
+        q = (h[k] + q) >> FE_BITS[k];
+    }
+    h[0] += 19 * q;
+    for (int k = 0; k < FE_LIMBS; k++) {
+        int64_t c = h[k] >> FE_BITS[k];
+        h[k] -= c * ((int64_t)1 << FE_BITS[k]);
+        if (k < top) {
+            h[k + 1] += c;
+        }
+    }
+
+    uint64_t acc = 0;
+    int accBits = 0;
+    size_t pos = 0;
+    for (int k = 0; k < FE_LIMBS; k++) {
+        acc |= (uint64_t)h[k] << accBits;
+        accBits += FE_BITS[k];
+        while (accBits >= 8) {
+            s[pos++] = (uint8_t)acc;
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+    s[pos] = (uint8_t)acc;   // last 7 bits; bit 255 is always clear
+}
+
+bool isOnCurve(const uint8_t* point) {
+    if (!point) {
+        return false;
+    }
+
+    // x^2 = u / v with u = y^2 - 1, v = d*y^2 + 1 (v is never zero since d
+    // is a non-square). A point exists iff u/v is a square or zero, i.e.
+    // the Legendre symbol of u*v is not -1.
+    fe25519 y, yy, u, v, w;
+    feFromBytes(y, point);
+    feSq(yy, y);
+    memcpy(u, yy, sizeof(fe25519));
+    u[0] -= 1;
+    feMul(v, FE_D, yy);
+    v[0] += 1;
+    feMul(w, u, v);
+
+    // chi = w^((p-1)/2) = (w^(2^252-3))^4 * w^2
+    fe25519 chi, w2;
+    fePow22523(chi, w);
+    feSqN(chi, chi, 2);
+    feSq(w2, w);
+    feMul(chi, chi, w2);
+
+    uint8_t bytes[32];
+    feToBytes(bytes, chi);
+    uint8_t rest = 0;
+    for (int i = 1; i < 32; i++) {
+        rest |= bytes[i];
+    }
+    return rest == 0 && bytes[0] <= 1;
+}
+
+// ============================================================================
+// Ed25519 batch verification
+// ============================================================================
+// Points in extended coordinates (X:Y:Z:T, x = X/Z, y = Y/Z, xy = T/Z) on
+// top of the field code above. Table entries are kept in the "cached" form
+// (Y+X, Y-X, Z, 2dT) so each addition costs eight multiplications.
+
+struct gePoint {
+    fe25519 X, Y, Z, T;
+};
+
+struct geCached {
+    fe25519 YplusX, YminusX, Z, T2d;
+};
+
+#if defined(__SIZEOF_INT128__)
+
+// 2d mod p
+static const fe25519 FE_D2 = {
+    1859910466990425, 932731440258426, 1072319116312658, 1815898335770999, 633789495995903
+};
+
+// sqrt(-1) mod p
+static const fe25519 FE_SQRTM1 = {
+    1718705420411056, 234908883556509, 2233514472574048, 2117202627021982, 765476049583133
+};
+
+#else
+
+// 2d mod p
+static const fe25519 FE_D2 = {
+    45281625, 27714825, 36363642, 13898781, 229458,
+    15978800, 54557047, 27058993, 29715967, 9444199
+};
+
+// sqrt(-1) mod p
+static const fe25519 FE_SQRTM1 = {
+    34513072, 25610706, 9377949, 3500415, 12389472,
+    33281959, 41962654, 31548777, 326685, 11406482
+};
+
+#endif
+
+// Compressed Ed25519 base point
+static const uint8_t ED25519_BASE[32] = {
+    0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+    0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
+};
+
+// Odd multiples P, 3P, ..., 15P per point, indexed by |digit| / 2
+#define GE_TABLE_SIZE 8
+
+static inline void feAdd(fe25519 h, const fe25519 f, const fe25519 g) {
+    for (int k = 0; k < FE_LIMBS; k++) h[k] = f[k] + g[k];
+}
+
+static inline void feSub(fe25519 h, const fe25519 f, const fe25519 g) {
+    for (int k = 0; k < FE_LIMBS; k++) h[k] = f[k] - g[k];
+}
+
+static inline void feNeg(fe25519 h, const fe25519 f) {
+    for (int k = 0; k < FE_LIMBS; k++) h[k] = -f[k];
+}
+
+// Bring limbs of a short sum back to carried size before a multiplication
+static void feReduce(fe25519 h) {
+    feWide t[FE_LIMBS];
+    for (int k = 0; k < FE_LIMBS; k++) t[k] = h[k];
+    for (int k = 0; k < FE_LIMBS; k++) feCarry(t, k);
+    feCarry(t, 0);
+    for (int k = 0; k < FE_LIMBS; k++) h[k] = t[k];
+}
+
+static bool feIsZero(const fe25519 f) {
+    fe25519 t;
+    memcpy(t, f, sizeof(fe25519));
+    feReduce(t);
+    uint8_t s[32];
+    feToBytes(s, t);
+    uint8_t acc = 0;
+    for (int i = 0; i < 32; i++) acc |= s[i];
+    return acc == 0;
+}
+
+static void geIdentity(gePoint* p) {
+    memset(p, 0, sizeof(*p));
+    p->Y[0] = 1;
+    p->Z[0] = 1;
+}
+
+static bool geIsIdentity(const gePoint* p) {
+    fe25519 t;
+    feSub(t, p->Y, p->Z);
+    return feIsZero(p->X) && feIsZero(t);
+}
+
+// dbl-2008-hwcd with a = -1
+static void geDouble(gePoint* r, const gePoint* p) {
+    fe25519 a, b, c, e, f, g, h;
+    feSq(a, p->X);
+    feSq(b, p->Y);
+    feSq(c, p->Z);
+    feAdd(c, c, c);
+    feAdd(e, p->X, p->Y);
+    feSq(e, e);
+    feSub(e, e, a);
+    feSub(e, e, b);
+    feReduce(e);
+    feSub(g, b, a);
+    feSub(f, g, c);
+    feReduce(f);
+    feAdd(h, a, b);
+    feNeg(h, h);
+    feMul(r->X, e, f);
+    feMul(r->Y, g, h);
+    feMul(r->T, e, h);
+    feMul(r->Z, f, g);
+}
+
+// add-2008-hwcd-3 with a = -1; subtracts q instead when `negate` is set
+static void geAdd(gePoint* r, const gePoint* p, const geCached* q, bool negate) {
+    fe25519 a, b, c, d, e, f, g, h;
+    feSub(a, p->Y, p->X);
+    feMul(a, a, negate ? q->YplusX : q->YminusX);
+    feAdd(b, p->Y, p->X);
+    feMul(b, b, negate ? q->YminusX : q->YplusX);
+    feMul(c, p->T, q->T2d);
+    feMul(d, p->Z, q->Z);
+    feAdd(d, d, d);
+    feSub(e, b, a);
+    feAdd(h, b, a);
+    if (negate) {
+        feAdd(f, d, c);
+        feSub(g, d, c);
+    } else {
+        feSub(f, d, c);
+        feAdd(g, d, c);
+    }
+    feMul(r->X, e, f);
+    feMul(r->Y, g, h);
+    feMul(r->T, e, h);
+    feMul(r->Z, f, g);
+}
+
+static void geToCached(geCached* c, const gePoint* p) {
+    feAdd(c->YplusX, p->Y, p->X);
+    feSub(c->YminusX, p->Y, p->X);
+    memcpy(c->Z, p->Z, sizeof(fe25519));
+    feMul(c->T2d, p->T, FE_D2);
+}
+
+/**
+ * Decompress a point. Only canonical encodings are accepted (y < p, and
+ * no sign bit on x = 0); anything else is left to verifySignature().
+ */
+static bool geFromBytes(gePoint* h, const uint8_t* s) {
+    feFromBytes(h->Y, s);
+    uint8_t check[32];
+    feToBytes(check, h->Y);
+    check[31] |= s[31] & 0x80;
+    if (memcmp(check, s, 32) != 0) {
+        return false;
+    }
+
+    // x = u v^3 (u v^7)^((p-5)/8) with u = y^2 - 1, v = d y^2 + 1
+    fe25519 u, v, v3, vxx, t;
+    feSq(u, h->Y);
+    feMul(v, u, FE_D);
+    u[0] -= 1;
+    v[0] += 1;
+    feSq(v3, v);
+    feMul(v3, v3, v);
+    feSq(h->X, v3);
+    feMul(h->X, h->X, v);
+    feMul(h->X, h->X, u);
+    fePow22523(h->X, h->X);
+    feMul(h->X, h->X, v3);
+    feMul(h->X, h->X, u);
+
+    // v x^2 is u (x is the root) or -u (x needs a factor sqrt(-1))
+    feSq(vxx, h->X);
+    feMul(vxx, vxx, v);
+    feSub(t, vxx, u);
+    if (!feIsZero(t)) {
+        feAdd(t, vxx, u);
+        if (!feIsZero(t)) {
+            return false;
+        }
+        feMul(h->X, h->X, FE_SQRTM1);
+    }
+
+    feToBytes(check, h->X);
+    bool xIsZero = true;
+    for (int i = 0; i < 32; i++) {
+        if (check[i]) xIsZero = false;
+    }
+    uint8_t sign = s[31] >> 7;
+    if (xIsZero && sign) {
+        return false;
+    }
+    if ((check[0] & 1) != sign) {
+        feNeg(h->X, h->X);
+    }
+
+    memset(h->Z, 0, sizeof(fe25519));
+    h->Z[0] = 1;
+    feMul(h->T, h->X, h->Y);
+    return true;
+}
 
-// Base58 implementation
-static const char base58_chars[] = BASE58_ALPHABET;
+// Small-order points vanish under the cofactored equation: 8P = identity
+static bool geHasSmallOrder(const gePoint* p) {
+    gePoint q;
+    geDouble(&q, p);
+    geDouble(&q, &q);
+    geDouble(&q, &q);
+    return geIsIdentity(&q);
+}
 
-size_t base58Encode(const uint8_t* data, size_t len, char* output, size_t outputLen) {
-    if (!data || !output || len == 0 || outputLen == 0) {
-        return 0;
+static void geBuildTable(geCached table[GE_TABLE_SIZE], const gePoint* p) {
+    gePoint p2, cur = *p;
+    geDouble(&p2, p);
+    geCached c2;
+    geToCached(&c2, &p2);
+    geToCached(&table[0], &cur);
+    for (int i = 1; i < GE_TABLE_SIZE; i++) {
+        geAdd(&cur, &cur, &c2, false);
+        geToCached(&table[i], &cur);
     }
-    
-    // Count leading zeros
-    size_t zeros = 0;
-    while (zeros < len && data[zeros] == 0) {
-        zeros++;
+}
+
+// Width-5 signed sliding window (ref10 "slide"): odd digits in [-15, 15].
+// The scalar must be below 2^255.
+static void scalarSlide(int8_t r[256], const uint8_t a[32]) {
+    for (int i = 0; i < 256; i++) {
+        r[i] = 1 & (a[i >> 3] >> (i & 7));
     }
-    
-    // Convert to base58
-    uint8_t* buffer = (uint8_t*)malloc(len * 2);
-    if (!buffer) return 0;
-    
-    memcpy(buffer, data, len);
-    
-    size_t output_idx = 0;
-    for (size_t i = 0; i < zeros && output_idx < outputLen - 1; i++) {
-        output[output_idx++] = '1';
+    for (int i = 0; i < 256; i++) {
+        if (!r[i]) continue;
+        for (int b = 1; b <= 6 && i + b < 256; b++) {
+            if (!r[i + b]) continue;
+            if (r[i] + (r[i + b] << b) <= 15) {
+                r[i] += r[i + b] << b;
+                r[i + b] = 0;
+            } else if (r[i] - (r[i + b] << b) >= -15) {
+                r[i] -= r[i + b] << b;
+                for (int k = i + b; k < 256; k++) {
+                    if (!r[k]) {
+                        r[k] = 1;
+                        break;
+                    }
+                    r[k] = 0;
+                }
+            } else {
+                break;
+            }
+        }
     }
-    
-    size_t start = zeros;
-    while (start < len) {
-        uint32_t remainder = 0;
-        bool leading_zero = true;
-        
-        for (size_t i = start; i < len; i++) {
-            remainder = remainder * 256 + buffer[i];
-            buffer[i] = remainder / 58;
-            remainder %= 58;
-            if (buffer[i] != 0) leading_zero = false;
-        }
-        
-        if (output_idx >= outputLen - 1) break;
-        output[output_idx++] = base58_chars[remainder];
-        
-        while (start < len && buffer[start] == 0) {
-            start++;
+}
+
+// One point of the multi-scalar multiplication
+struct MsmTerm {
+    geCached table[GE_TABLE_SIZE];
+    int8_t digits[256];
+};
+
+static void msmTermInit(MsmTerm* term, const gePoint* p, const uint8_t scalar[32]) {
+    geBuildTable(term->table, p);
+    scalarSlide(term->digits, scalar);
+}
+
+// Straus: one shared doubling chain, one table addition per nonzero digit
+static void msmEvaluate(gePoint* acc, const MsmTerm* terms, size_t count) {
+    int top = 255;
+    while (top >= 0) {
+        bool any = false;
+        for (size_t j = 0; j < count && !any; j++) {
+            any = terms[j].digits[top] != 0;
         }
+        if (any) break;
+        top--;
     }
-    
-    // Reverse the string
-    for (size_t i = 0; i < output_idx / 2; i++) {
-        char temp = output[i];
-        output[i] = output[output_idx - 1 - i];
-        output[output_idx - 1 - i] = temp;
+
+    geIdentity(acc);
+    for (int i = top; i >= 0; i--) {
+        geDouble(acc, acc);
+        for (size_t j = 0; j < count; j++) {
+            int8_t digit = terms[j].digits[i];
+            if (digit > 0) {
+                geAdd(acc, acc, &terms[j].table[digit / 2], false);
+            } else if (digit < 0) {
+                geAdd(acc, acc, &terms[j].table[-digit / 2], true);
+            }
+        }
     }
-    
-    output[output_idx] = '\0';
-    free(buffer);
-    return output_idx;
 }
 
-size_t base58Decode(const char* input, uint8_t* output, size_t outputLen) {
-    if (!input || !output || outputLen == 0) {
-        return 0;
+static bool msmIsIdentityTimesCofactor(const MsmTerm* terms, size_t count) {
+    gePoint acc;
+    msmEvaluate(&acc, terms, count);
+    geDouble(&acc, &acc);
+    geDouble(&acc, &acc);
+    geDouble(&acc, &acc);
+    return geIsIdentity(&acc);
+}
+
+// ----------------------------------------------------------------------------
+// Scalars mod L = 2^252 + 27742317777372353535851937790883648493
+// ----------------------------------------------------------------------------
+// Reduction works on signed 21-bit limbs, as in ref10: a limb at bit 252
+// or above folds into the six limbs below it via 2^252 = -c (mod L), with
+// c split into the signed limbs below. Every step is data independent, so
+// this stays constant time for the secret scalars of signing.
+
+static const uint32_t SC_L[8] = {
+    0x5cf5d3ed, 0x5812631a, 0xa2f79cd6, 0x14def9de, 0, 0, 0, 0x10000000
+};
+
+static void scLoad(uint32_t* w, const uint8_t* s, size_t words) {
+    for (size_t i = 0; i < words; i++) {
+        w[i] = (uint32_t)s[4 * i] | ((uint32_t)s[4 * i + 1] << 8) |
+               ((uint32_t)s[4 * i + 2] << 16) | ((uint32_t)s[4 * i + 3] << 24);
     }
-    
-    size_t inputLen = strlen(input);
-    if (inputLen == 0) return 0;
-    
-    // Count leading ones
-    size_t zeros = 0;
-    while (zeros < inputLen && input[zeros] == '1') {
-        zeros++;
+}
+
+// Split len bytes into count 21-bit limbs; the last limb takes every bit left
+static void scLoadLimbs(int64_t* limbs, size_t count, const uint8_t* s, size_t len) {
+    for (size_t i = 0; i < count; i++) {
+        size_t bit = 21 * i;
+        uint64_t v = 0;
+        for (size_t k = 0; k < 5 && bit / 8 + k < len; k++) {
+            v |= (uint64_t)s[bit / 8 + k] << (8 * k);
+        }
+        v >>= bit % 8;
+        limbs[i] = (int64_t)(i + 1 < count ? v & 0x1fffff : v);
     }
-    
-    uint8_t* buffer = (uint8_t*)malloc(inputLen * 2);
-    if (!buffer) return 0;
-    
-    memset(buffer, 0, inputLen * 2);
-    
-    // Convert from base58
-    for (size_t i = zeros; i < inputLen; i++) {
-        const char* pos = strchr(base58_chars, input[i]);
-        if (!pos) {
-            free(buffer);
-            return 0;
-        }
-        
-        uint8_t value = pos - base58_chars;
-        uint32_t carry = value;
-        
-        for (size_t j = 0; j < inputLen * 2; j++) {
-            carry += buffer[j] * 58;
-            buffer[j] = carry & 0xFF;
-            carry >>= 8;
+}
+
+// Limb i (weight 2^(21 i), i >= 12) into limbs i - 12 .. i - 7
+static inline void scFold(int64_t* s, int i) {
+    s[i - 12] += s[i] * 666643;
+    s[i - 11] += s[i] * 470296;
+    s[i - 10] += s[i] * 654183;
+    s[i - 9] -= s[i] * 997805;
+    s[i - 8] += s[i] * 136657;
+    s[i - 7] -= s[i] * 683901;
+    s[i] = 0;
+}
+
+// Move the excess of limb i into limb i + 1, rounding (limb ends in
+// [-2^20, 2^20)) or flooring (limb ends in [0, 2^21))
+static inline void scCarry(int64_t* s, int i, bool round) {
+    int64_t carry = (s[i] + (round ? (int64_t)1 << 20 : 0)) >> 21;
+    s[i + 1] += carry;
+    s[i] -= carry * ((int64_t)1 << 21);
+}
+
+// out = s mod L for 24 limbs, the top one up to 29 bits (ref10's order of
+// folds and carries, which keeps every limb within int64_t)
+static void scReduceLimbs(uint8_t out[32], int64_t s[24]) {
+    for (int i = 23; i >= 18; i--) scFold(s, i);
+    for (int i = 6; i <= 16; i += 2) scCarry(s, i, true);
+    for (int i = 7; i <= 15; i += 2) scCarry(s, i, true);
+    for (int i = 17; i >= 12; i--) scFold(s, i);
+    for (int i = 0; i <= 10; i += 2) scCarry(s, i, true);
+    for (int i = 1; i <= 11; i += 2) scCarry(s, i, true);
+    scFold(s, 12);
+    for (int i = 0; i <= 11; i++) scCarry(s, i, false);
+    scFold(s, 12);
+    for (int i = 0; i <= 10; i++) scCarry(s, i, false);
+
+    uint64_t acc = 0;
+    int bits = 0;
+    size_t n = 0;
+    for (int i = 0; i < 12; i++) {
+        acc |= (uint64_t)s[i] << bits;
+        for (bits += 21; bits >= 8; bits -= 8) {
+            out[n++] = (uint8_t)acc;
+            acc >>= 8;
         }
     }
-    
-    // Find the actual length
-    size_t resultLen = 0;
-    for (size_t i = inputLen * 2; i > 0; i--) {
-        if (buffer[i - 1] != 0) {
-            resultLen = i;
-            break;
+    while (n < 32) {
+        out[n++] = (uint8_t)acc;
+        acc >>= 8;
+    }
+}
+
+// out = in mod L for a 32- or 64-byte little-endian input
+static void scReduce(uint8_t out[32], const uint8_t* in, size_t len) {
+    int64_t s[24] = {0};
+    scLoadLimbs(s, len == 64 ? 24 : 12, in, len);
+    scReduceLimbs(out, s);
+}
+
+// s = a * b + c mod L; all inputs below 2^256
+static void scMulAdd(uint8_t s[32], const uint8_t a[32], const uint8_t b[32], const uint8_t c[32]) {
+    int64_t al[12], bl[12], t[24] = {0};
+    scLoadLimbs(al, 12, a, 32);
+    scLoadLimbs(bl, 12, b, 32);
+    scLoadLimbs(t, 12, c, 32);
+    for (int i = 0; i < 12; i++) {
+        for (int j = 0; j < 12; j++) {
+            t[i + j] += al[i] * bl[j];
         }
     }
-    
-    resultLen += zeros;
-    if (resultLen > outputLen) {
-        free(buffer);
-        return 0;
+    for (int i = 0; i <= 22; i += 2) scCarry(t, i, true);
+    for (int i = 1; i <= 21; i += 2) scCarry(t, i, true);
+    scReduceLimbs(s, t);
+}
+
+static const uint8_t SC_ZERO[32] = {0};
+
+// out = -a mod L for a reduced a
+static void scNegate(uint8_t out[32], const uint8_t a[32]) {
+    uint32_t aw[8];
+    uint8_t d[32];
+    scLoad(aw, a, 8);
+    uint64_t borrow = 0;
+    for (int i = 0; i < 8; i++) {
+        uint64_t w = (uint64_t)SC_L[i] - aw[i] - borrow;
+        d[4 * i] = (uint8_t)w;
+        d[4 * i + 1] = (uint8_t)(w >> 8);
+        d[4 * i + 2] = (uint8_t)(w >> 16);
+        d[4 * i + 3] = (uint8_t)(w >> 24);
+        borrow = (w >> 32) & 1;
     }
-    
-    // Copy result
-    memset(output, 0, outputLen);
-    for (size_t i = 0; i < zeros; i++) {
-        output[i] = 0;
+    scReduce(out, d, 32);   // a = 0 gives L, which reduces to 0
+}
+
+// S must be reduced mod L, like verifySignature() requires
+static bool scalarIsCanonical(const uint8_t s[32]) {
+    uint32_t w[8];
+    scLoad(w, s, 8);
+    for (int i = 7; i >= 0; i--) {
+        if (w[i] != SC_L[i]) return w[i] < SC_L[i];
     }
-    
-    for (size_t i = 0; i < resultLen - zeros; i++) {
-        output[zeros + i] = buffer[resultLen - zeros - 1 - i];
+    return false;
+}
+
+/**
+ * Verify up to SOLDUINO_VERIFY_BATCH_MAX entries. Entries that cannot join
+ * the batch, and all entries of a failed batch, use verifySignature().
+ */
+static bool verifyBatchChunk(const SignatureBatchEntry* entries, size_t count, bool* results) {
+    // Terms: the base point, then R_i and A_i per batched signature. A lone
+    // signature is cheaper to check directly.
+    MsmTerm* terms = nullptr;
+    if (count > 1) {
+        terms = (MsmTerm*)malloc((2 * count + 1) * sizeof(MsmTerm));
     }
-    
-    free(buffer);
-    return resultLen;
+    const CryptoBackend* backend = cryptoBackend();
+    bool batched[SOLDUINO_VERIFY_BATCH_MAX];
+    size_t termCount = 1;
+    uint8_t sumS[32] = {0};
+
+    for (size_t i = 0; i < count; i++) {
+        const SignatureBatchEntry& e = entries[i];
+        batched[i] = false;
+        if (!terms || !e.message || !e.signature || !e.publicKey) {
+            continue;
+        }
+
+        gePoint R, A;
+        if (!scalarIsCanonical(e.signature + 32) ||
+            !geFromBytes(&R, e.signature) || geHasSmallOrder(&R) ||
+            !geFromBytes(&A, e.publicKey) || geHasSmallOrder(&A)) {
+            continue;
+        }
+
+        // Random 128-bit weight z; the terms are z R, (z k) A and -(sum z S) B
+        uint8_t z[32] = {0};
+        if (!backend->randomBytes(z, 16)) {
+            continue;
+        }
+
+        uint8_t digest[64];
+        uint8_t k[32];
+        CryptoSlice parts[3] = {{e.signature, 32}, {e.publicKey, 32}, {e.message, e.messageLen}};
+        backend->sha512(parts, 3, digest);
+        scReduce(k, digest, 64);
+        scMulAdd(k, k, z, SC_ZERO);
+        scMulAdd(sumS, z, e.signature + 32, sumS);
+
+        msmTermInit(&terms[termCount++], &R, z);
+        msmTermInit(&terms[termCount++], &A, k);
+        batched[i] = true;
+    }
+
+    bool batchOk = false;
+    if (termCount > 3) {
+        gePoint B;
+        uint8_t negS[32];
+        geFromBytes(&B, ED25519_BASE);
+        scNegate(negS, sumS);
+        msmTermInit(&terms[0], &B, negS);
+        batchOk = msmIsIdentityTimesCofactor(terms, termCount);
+    }
+    free(terms);
+
+    bool allOk = true;
+    for (size_t i = 0; i < count; i++) {
+        bool ok;
+        if (batched[i] && batchOk) {
+            ok = true;
+        } else if (!results && !allOk) {
+            // Nobody asked which ones failed
+            return false;
+        } else {
+            const SignatureBatchEntry& e = entries[i];
+            ok = verifySignature(e.message, e.messageLen, e.signature, e.publicKey);
+        }
+        if (results) results[i] = ok;
+        allOk = allOk && ok;
+    }
+    return allOk;
 }
 
-bool generateRandomSeed(uint8_t* seed) {
-    if (!seed) return false;
-    
-#ifdef ESP32
-    // Use ESP32 hardware random number generator
-    for (size_t i = 0; i < SOLDUINO_SEED_SIZE; i += 4) {
-        uint32_t rand = esp_random();
-        memcpy(seed + i, &rand, min(4, (int)(SOLDUINO_SEED_SIZE - i)));
+bool verifySignaturesBatch(const SignatureBatchEntry* entries, size_t count, bool* results) {
+    if (!entries) return false;
+
+    bool allOk = true;
+    for (size_t start = 0; start < count; start += SOLDUINO_VERIFY_BATCH_MAX) {
+        size_t n = min(count - start, (size_t)SOLDUINO_VERIFY_BATCH_MAX);
+        if (!verifyBatchChunk(entries + start, n, results ? results + start : nullptr)) {
+            allOk = false;
+            if (!results) break;
+        }
+    }
+    return allOk;
+}
+
+// ============================================================================
+// Multi-lane SHA-256
+// ============================================================================
+// One round function, instantiated for a single uint32_t (prefix blocks)
+// and for a vector of SOLDUINO_SHA256_LANES words (lane-parallel finish).
+
+typedef uint32_t sha256_lanes __attribute__((vector_size(4 * SOLDUINO_SHA256_LANES)));
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+template <typename W>
+static inline W sha256Rotr(W x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+// Compress one block per lane: state += rounds(state, w)
+template <typename W>
+static void sha256Rounds(W state[8], W w[16]) {
+    W a = state[0], b = state[1], c = state[2], d = state[3];
+    W e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; t++) {
+        if (t >= 16) {
+            W w15 = w[(t + 1) & 15];
+            W w2 = w[(t + 14) & 15];
+            W s0 = sha256Rotr(w15, 7) ^ sha256Rotr(w15, 18) ^ (w15 >> 3);
+            W s1 = sha256Rotr(w2, 17) ^ sha256Rotr(w2, 19) ^ (w2 >> 10);
+            w[t & 15] += s0 + s1 + w[(t + 9) & 15];
+        }
+        W t1 = h + (sha256Rotr(e, 6) ^ sha256Rotr(e, 11) ^ sha256Rotr(e, 25)) +
+               ((e & f) ^ (~e & g)) + SHA256_K[t] + w[t & 15];
+        W t2 = (sha256Rotr(a, 2) ^ sha256Rotr(a, 13) ^ sha256Rotr(a, 22)) +
+               ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static inline uint32_t sha256LoadBE(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void sha256CompressBlock(uint32_t state[8], const uint8_t block[64]) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++) {
+        w[i] = sha256LoadBE(block + 4 * i);
+    }
+    sha256Rounds(state, w);
+}
+
+void sha256MidstateInit(Sha256Midstate* mid) {
+    memcpy(mid->h, SHA256_IV, sizeof(SHA256_IV));
+    mid->length = 0;
+    mid->tailLen = 0;
+}
+
+void sha256MidstateUpdate(Sha256Midstate* mid, const uint8_t* data, size_t len) {
+    mid->length += len;
+    while (len > 0) {
+        size_t take = min(len, (size_t)(64 - mid->tailLen));
+        memcpy(mid->tail + mid->tailLen, data, take);
+        mid->tailLen += take;
+        data += take;
+        len -= take;
+        if (mid->tailLen == 64) {
+            sha256CompressBlock(mid->h, mid->tail);
+            mid->tailLen = 0;
+        }
+    }
+}
+
+// Block `index` of the padded remainder tail | suffix | 0x80 | 0.. | bitlen
+static void sha256RemainderBlock(uint8_t block[64], size_t index,
+                                 const uint8_t* tail, size_t tailLen,
+                                 const uint8_t* suffix, size_t suffixLen,
+                                 size_t paddedLen, uint64_t bitLen) {
+    size_t start = index * 64;
+    for (size_t i = 0; i < 64; i++) {
+        size_t pos = start + i;
+        uint8_t byte;
+        if (pos < tailLen) {
+            byte = tail[pos];
+        } else if (pos < tailLen + suffixLen) {
+            byte = suffix[pos - tailLen];
+        } else if (pos == tailLen + suffixLen) {
+            byte = 0x80;
+        } else if (pos >= paddedLen - 8) {
+            byte = (uint8_t)(bitLen >> (8 * (paddedLen - 1 - pos)));
+        } else {
+            byte = 0;
+        }
+        block[i] = byte;
+    }
+}
+
+void sha256Finish(const Sha256Midstate* mid, const uint8_t* suffix, size_t len, uint8_t digest[32]) {
+    Sha256Midstate m = *mid;
+    sha256MidstateUpdate(&m, suffix, len);
+
+    uint64_t bitLen = m.length * 8;
+    uint8_t block[64];
+    memcpy(block, m.tail, m.tailLen);
+    block[m.tailLen] = 0x80;
+    size_t pos = m.tailLen + 1;
+    if (pos > 56) {
+        memset(block + pos, 0, 64 - pos);
+        sha256CompressBlock(m.h, block);
+        pos = 0;
+    }
+    memset(block + pos, 0, 56 - pos);
+    for (int i = 0; i < 8; i++) {
+        block[56 + i] = (uint8_t)(bitLen >> (56 - 8 * i));
+    }
+    sha256CompressBlock(m.h, block);
+
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = (uint8_t)(m.h[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(m.h[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(m.h[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)m.h[i];
+    }
+}
+
+void sha256FinishLanes(const Sha256Midstate* mid,
+                       const uint8_t* const suffixes[SOLDUINO_SHA256_LANES],
+                       size_t suffixLen,
+                       uint8_t digests[SOLDUINO_SHA256_LANES][32]) {
+    uint64_t bitLen = (mid->length + suffixLen) * 8;
+    size_t paddedLen = ((mid->tailLen + suffixLen + 9 + 63) / 64) * 64;
+
+    sha256_lanes state[8];
+    for (int i = 0; i < 8; i++) {
+        for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+            state[i][l] = mid->h[i];
+        }
+    }
+
+    for (size_t b = 0; b < paddedLen / 64; b++) {
+        sha256_lanes w[16];
+        for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+            uint8_t block[64];
+            sha256RemainderBlock(block, b, mid->tail, mid->tailLen,
+                                 suffixes[l], suffixLen, paddedLen, bitLen);
+            for (int i = 0; i < 16; i++) {
+                w[i][l] = sha256LoadBE(block + 4 * i);
+            }
+        }
+        sha256Rounds(state, w);
+    }
+
+    for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+        for (int i = 0; i < 8; i++) {
+            uint32_t v = state[i][l];
+            digests[l][4 * i] = (uint8_t)(v >> 24);
+            digests[l][4 * i + 1] = (uint8_t)(v >> 16);
+            digests[l][4 * i + 2] = (uint8_t)(v >> 8);
+            digests[l][4 * i + 3] = (uint8_t)v;
+        }
+    }
+}
+
+// ============================================================================
+// Reference crypto backend
+// ============================================================================
+// Portable C++ SHA-256/SHA-512 and Ed25519 built on the field and point code
+// above, for targets without libsodium (SOLDUINO_HAS_SODIUM 0) or for
+// checking a backend against.
+// Signing uses a fixed-window base multiplication with masked table lookups
+// so its timing does not depend on the secret scalar.
+
+static const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+static const uint64_t SHA512_IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static inline uint64_t sha512Rotr(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+static void sha512CompressBlock(uint64_t state[8], const uint8_t block[128]) {
+    uint64_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = 0;
+        for (int b = 0; b < 8; b++) {
+            w[i] = (w[i] << 8) | block[8 * i + b];
+        }
+    }
+    for (int i = 16; i < 80; i++) {
+        uint64_t s0 = sha512Rotr(w[i - 15], 1) ^ sha512Rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = sha512Rotr(w[i - 2], 19) ^ sha512Rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 80; i++) {
+        uint64_t t1 = h + (sha512Rotr(e, 14) ^ sha512Rotr(e, 18) ^ sha512Rotr(e, 41)) +
+                      ((e & f) ^ (~e & g)) + SHA512_K[i] + w[i];
+        uint64_t t2 = (sha512Rotr(a, 28) ^ sha512Rotr(a, 34) ^ sha512Rotr(a, 39)) +
+                      ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static void refSha512(const CryptoSlice* parts, size_t count, uint8_t digest[64]) {
+    uint64_t state[8];
+    memcpy(state, SHA512_IV, sizeof(SHA512_IV));
+    uint8_t block[128];
+    size_t fill = 0;
+    uint64_t length = 0;
+
+    for (size_t p = 0; p < count; p++) {
+        const uint8_t* data = parts[p].data;
+        size_t len = parts[p].len;
+        length += len;
+        while (len > 0) {
+            size_t take = min(len, (size_t)(128 - fill));
+            memcpy(block + fill, data, take);
+            fill += take;
+            data += take;
+            len -= take;
+            if (fill == 128) {
+                sha512CompressBlock(state, block);
+                fill = 0;
+            }
+        }
+    }
+
+    // Messages here are far below 2^61 bytes: the upper 64 length bits are zero
+    block[fill++] = 0x80;
+    if (fill > 112) {
+        memset(block + fill, 0, 128 - fill);
+        sha512CompressBlock(state, block);
+        fill = 0;
+    }
+    memset(block + fill, 0, 120 - fill);
+    uint64_t bitLen = length * 8;
+    for (int i = 0; i < 8; i++) {
+        block[120 + i] = (uint8_t)(bitLen >> (56 - 8 * i));
+    }
+    sha512CompressBlock(state, block);
+
+    for (int i = 0; i < 8; i++) {
+        for (int b = 0; b < 8; b++) {
+            digest[8 * i + b] = (uint8_t)(state[i] >> (56 - 8 * b));
+        }
+    }
+}
+
+static void refSha256(const CryptoSlice* parts, size_t count, uint8_t digest[32]) {
+    Sha256Midstate mid;
+    sha256MidstateInit(&mid);
+    for (size_t i = 0; i < count; i++) {
+        sha256MidstateUpdate(&mid, parts[i].data, parts[i].len);
+    }
+    sha256Finish(&mid, nullptr, 0, digest);
+}
+
+// memset() that the compiler may not drop for dead stores
+static void secureZero(void* buf, size_t len) {
+    volatile uint8_t* p = (volatile uint8_t*)buf;
+    while (len--) {
+        *p++ = 0;
+    }
+}
+
+// f = g where mask is all ones, unchanged where it is zero
+static inline void feCmov(fe25519 f, const fe25519 g, int64_t mask) {
+    for (int k = 0; k < FE_LIMBS; k++) {
+        f[k] ^= (f[k] ^ g[k]) & mask;
+    }
+}
+
+// z^(p-2) = (z^(2^252-3))^8 * z^3
+static void feInvert(fe25519 out, const fe25519 z) {
+    fe25519 t, z3;
+    fePow22523(t, z);
+    feSqN(t, t, 3);
+    feSq(z3, z);
+    feMul(z3, z3, z);
+    feMul(out, t, z3);
+}
+
+static void geToBytes(uint8_t s[32], const gePoint* p) {
+    fe25519 zi, x, y;
+    uint8_t xb[32];
+    feInvert(zi, p->Z);
+    feMul(x, p->X, zi);
+    feMul(y, p->Y, zi);
+    feToBytes(s, y);
+    feToBytes(xb, x);
+    s[31] |= (xb[0] & 1) << 7;
+}
+
+// 0..15 times the base point, built by the backend's init()
+static geCached REF_BASE_TABLE[16];
+static gePoint REF_BASE_POINT;
+
+/**
+ * r = scalar * B for a secret scalar below 2^255: 4-bit windows, each
+ * table entry read through a mask so every window touches all 16.
+ */
+static void geScalarMultBase(gePoint* r, const uint8_t scalar[32]) {
+    geIdentity(r);
+    for (int i = 63; i >= 0; i--) {
+        geDouble(r, r);
+        geDouble(r, r);
+        geDouble(r, r);
+        geDouble(r, r);
+
+        uint32_t nibble = (scalar[i / 2] >> (4 * (i & 1))) & 15;
+        geCached sel = REF_BASE_TABLE[0];
+        for (uint32_t j = 1; j < 16; j++) {
+            int64_t mask = -(int64_t)(((j ^ nibble) - 1) >> 31);
+            feCmov(sel.YplusX, REF_BASE_TABLE[j].YplusX, mask);
+            feCmov(sel.YminusX, REF_BASE_TABLE[j].YminusX, mask);
+            feCmov(sel.Z, REF_BASE_TABLE[j].Z, mask);
+            feCmov(sel.T2d, REF_BASE_TABLE[j].T2d, mask);
+        }
+        geAdd(r, r, &sel, false);
+    }
+}
+
+static bool refInit() {
+    if (!geFromBytes(&REF_BASE_POINT, ED25519_BASE)) {
+        return false;
+    }
+    gePoint cur;
+    geCached base;
+    geIdentity(&cur);
+    geToCached(&base, &REF_BASE_POINT);
+    for (int j = 0; j < 16; j++) {
+        geToCached(&REF_BASE_TABLE[j], &cur);
+        geAdd(&cur, &cur, &base, false);
     }
     return true;
-#else
-    // Fallback for other platforms
-    srand(time(NULL));
-    for (size_t i = 0; i < SOLDUINO_SEED_SIZE; i++) {
-        seed[i] = rand() % 256;
+}
+
+// Platform entropy, shared with generateRandomSeed(). Only a CSPRNG will
+// do: keys, vanity seeds and batch-verification weights all come from
+// here. Platforms without one get false rather than a guessable stream.
+static bool platformRandomBytes(uint8_t* buf, size_t len) {
+#if defined(ESP32)
+    // Hardware RNG; cryptographically secure once Wi-Fi/BT (or the
+    // bootloader entropy source) is running
+    esp_fill_random(buf, len);
+    return true;
+#elif defined(__linux__)
+    while (len > 0) {
+        ssize_t n = getrandom(buf, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buf += n;
+        len -= (size_t)n;
     }
     return true;
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    arc4random_buf(buf, len);
+    return true;
+#elif defined(__unix__)
+    FILE* f = fopen("/dev/urandom", "rb");
+    if (!f) return false;
+    size_t n = fread(buf, 1, len, f);
+    fclose(f);
+    return n == len;
+#else
+    (void)buf;
+    (void)len;
+    return false;
 #endif
 }
 
+static bool refExpandKey(const uint8_t* privateKey, Ed25519SigningKey* key) {
+    uint8_t h[64];
+    CryptoSlice seed = {privateKey, SOLDUINO_SEED_SIZE};
+    refSha512(&seed, 1, h);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+    scReduce(key->scalar, h, 32);
+    memcpy(key->prefix, h + 32, 32);
+
+    gePoint A;
+    geScalarMultBase(&A, key->scalar);
+    geToBytes(key->publicKey, &A);
+    secureZero(h, sizeof(h));
+    return true;
+}
+
+static bool refSignExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature) {
+    // r = SHA-512(prefix | M) mod L, R = rB
+    uint8_t digest[64];
+    uint8_t r[32];
+    CryptoSlice nonceParts[2] = {{key->prefix, 32}, {message, messageLen}};
+    refSha512(nonceParts, 2, digest);
+    scReduce(r, digest, 64);
+    gePoint R;
+    geScalarMultBase(&R, r);
+    geToBytes(signature, &R);
+
+    // k = SHA-512(R | A | M) mod L, S = k * scalar + r mod L
+    uint8_t k[32];
+    CryptoSlice challengeParts[3] = {{signature, 32}, {key->publicKey, SOLDUINO_PUBKEY_SIZE}, {message, messageLen}};
+    refSha512(challengeParts, 3, digest);
+    scReduce(k, digest, 64);
+    scMulAdd(signature + 32, k, key->scalar, r);
+
+    secureZero(digest, sizeof(digest));
+    secureZero(r, sizeof(r));
+    secureZero(&R, sizeof(R));
+    return true;
+}
+
+// Unlike libsodium, the public key is recomputed from the seed rather than
+// read from privateKey[32..64], so a mismatched half cannot leak the key.
+static bool refSign(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature) {
+    Ed25519SigningKey key;
+    bool ok = refExpandKey(privateKey, &key) &&
+              refSignExpanded(message, messageLen, &key, signature);
+    clearSigningKey(&key);
+    return ok;
+}
+
+static bool refSeedKeypair(const uint8_t* seed, uint8_t* publicKey, uint8_t* privateKey) {
+    Ed25519SigningKey key;
+    if (!refExpandKey(seed, &key)) {
+        return false;
+    }
+    memcpy(publicKey, key.publicKey, SOLDUINO_PUBKEY_SIZE);
+    memcpy(privateKey, seed, SOLDUINO_SEED_SIZE);
+    memcpy(privateKey + SOLDUINO_SEED_SIZE, key.publicKey, SOLDUINO_PUBKEY_SIZE);
+    clearSigningKey(&key);
+    return true;
+}
+
+/**
+ * Same acceptance rules as libsodium: canonical S, canonical A and R of
+ * large order, and the encoding of S B - k A equal to R byte for byte.
+ */
+static bool refVerify(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey) {
+    gePoint R, A;
+    if (!scalarIsCanonical(signature + 32) ||
+        !geFromBytes(&R, signature) || geHasSmallOrder(&R) ||
+        !geFromBytes(&A, publicKey) || geHasSmallOrder(&A)) {
+        return false;
+    }
+
+    uint8_t digest[64];
+    uint8_t k[32];
+    CryptoSlice parts[3] = {{signature, 32}, {publicKey, SOLDUINO_PUBKEY_SIZE}, {message, messageLen}};
+    refSha512(parts, 3, digest);
+    scReduce(k, digest, 64);
+
+    feNeg(A.X, A.X);
+    feNeg(A.T, A.T);
+    MsmTerm terms[2];
+    msmTermInit(&terms[0], &REF_BASE_POINT, signature + 32);
+    msmTermInit(&terms[1], &A, k);
+
+    gePoint check;
+    uint8_t encoded[32];
+    msmEvaluate(&check, terms, 2);
+    geToBytes(encoded, &check);
+    return memcmp(encoded, signature, 32) == 0;
+}
+
+const CryptoBackend CRYPTO_BACKEND_REFERENCE = {
+    "reference",
+    refInit,
+    refSha256,
+    refSha512,
+    platformRandomBytes,
+    refSeedKeypair,
+    refSign,
+    refExpandKey,
+    refSignExpanded,
+    refVerify,
+    isOnCurve
+};
+
+// ============================================================================
+// Public key and signature API
+// ============================================================================
+
+bool generateRandomSeed(uint8_t* seed) {
+    if (!seed) return false;
+    return platformRandomBytes(seed, SOLDUINO_SEED_SIZE);
+}
+
 bool generateKeypairFromSeed(const uint8_t* seed, uint8_t* publicKey, uint8_t* privateKey) {
     if (!seed || !publicKey || !privateKey) return false;
-    if (sodium_init() < 0) return false;
-    // libsodium: generate Ed25519 keypair from 32-byte seed
-    int result = crypto_sign_ed25519_seed_keypair(publicKey, privateKey, seed);
-    return result == 0;
+    return cryptoBackend()->seedKeypair(seed, publicKey, privateKey);
 }
 
 bool generateKeypair(uint8_t* publicKey, uint8_t* privateKey) {
     if (!publicKey || !privateKey) return false;
-    if (sodium_init() < 0) return false;
-    int result = crypto_sign_ed25519_keypair(publicKey, privateKey);
-    return result == 0;
+    const CryptoBackend* backend = cryptoBackend();
+    uint8_t seed[SOLDUINO_SEED_SIZE];
+    bool ok = backend->randomBytes(seed, sizeof(seed)) &&
+              backend->seedKeypair(seed, publicKey, privateKey);
+    secureZero(seed, sizeof(seed));
+    return ok;
 }
 
 bool signMessage(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature) {
     if (!message || !privateKey || !signature) {
         return false;
     }
-    if (sodium_init() < 0) return false;
-    // Detached Ed25519 signature
-    unsigned long long siglen = 0;
-    int result = crypto_sign_ed25519_detached(signature, &siglen, message, (unsigned long long)messageLen, privateKey);
-    return result == 0 && siglen == SOLDUINO_SIGNATURE_SIZE;
+    return cryptoBackend()->sign(message, messageLen, privateKey, signature);
+}
+
+bool expandSigningKey(const uint8_t* privateKey, Ed25519SigningKey* key) {
+    if (!privateKey || !key) return false;
+    return cryptoBackend()->expandKey(privateKey, key);
+}
+
+bool signMessageExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature) {
+    if (!message || !key || !signature) {
+        return false;
+    }
+    return cryptoBackend()->signExpanded(message, messageLen, key, signature);
+}
+
+void clearSigningKey(Ed25519SigningKey* key) {
+    if (!key) return;
+    secureZero(key, sizeof(*key));
 }
 
 bool verifySignature(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey) {
     if (!message || !signature || !publicKey) {
         return false;
     }
-    if (sodium_init() < 0) return false;
-    int result = crypto_sign_ed25519_verify_detached(signature, message, (unsigned long long)messageLen, publicKey);
-    return result == 0;
+    return cryptoBackend()->verify(message, messageLen, signature, publicKey);
 }
 
 bool publicKeyToAddress(const uint8_t* publicKey, char* address, size_t addressLen) {
@@ -197,7 +2033,7 @@ bool publicKeyToAddress(const uint8_t* publicKey, char* address, size_t addressL
         return false;
     }
     
-    return base58Encode(publicKey, SOLDUINO_PUBKEY_SIZE, address, addressLen) > 0;
+    return base58Encode32(publicKey, address, addressLen) > 0;
 }
 
 bool addressToPublicKey(const char* address, uint8_t* publicKey) {
@@ -205,8 +2041,7 @@ bool addressToPublicKey(const char* address, uint8_t* publicKey) {
         return false;
     }
     
-    size_t decodedLen = base58Decode(address, publicKey, SOLDUINO_PUBKEY_SIZE);
-    return decodedLen == SOLDUINO_PUBKEY_SIZE;
+    return base58Decode32(address, publicKey);
 }
 
 bool privateKeyToBase58(const uint8_t* privateKey, char* output, size_t outputLen) {
@@ -215,7 +2050,7 @@ bool privateKeyToBase58(const uint8_t* privateKey, char* output, size_t outputLe
     }
     
     // Encode only the first 32 bytes (the seed) for Solana private keys
-    return base58Encode(privateKey, 32, output, outputLen) > 0;
+    return base58Encode32(privateKey, output, outputLen) > 0;
 }
 
 bool base58ToPrivateKey(const char* input, uint8_t* privateKey) {
@@ -223,33 +2058,26 @@ bool base58ToPrivateKey(const char* input, uint8_t* privateKey) {
         return false;
     }
     
-    uint8_t decoded[64];
-    size_t decodedLen = base58Decode(input, decoded, 64);
-    
-    if (decodedLen != 32 && decodedLen != 64) {
-        return false;
-    }
-    
-    // If decoded is 32 bytes, we need to derive the public key
-    if (decodedLen == 32) {
-        uint8_t publicKey[32];
-        if (!generateKeypairFromSeed(decoded, publicKey, privateKey)) {
-            return false;
-        }
-    } else {
-        memcpy(privateKey, decoded, 64);
+    // Full 64-byte keypair (seed || pubkey)
+    if (base58Decode64(input, privateKey)) {
+        return true;
     }
     
-    return true;
+    // Bare 32-byte seed: derive the public key
+    uint8_t seed[32];
+    uint8_t publicKey[32];
+    bool ok = base58Decode32(input, seed) && generateKeypairFromSeed(seed, publicKey, privateKey);
+    memset(seed, 0, sizeof(seed));
+    return ok;
 }
 
 bool getPublicKeyFromPrivate(const uint8_t* privateKey, uint8_t* publicKey) {
     if (!privateKey || !publicKey) {
         return false;
     }
-    if (sodium_init() < 0) return false;
-    int result = crypto_sign_ed25519_sk_to_pk(publicKey, privateKey);
-    return result == 0;
+    // The second half of an Ed25519 private key is its public key
+    memcpy(publicKey, privateKey + SOLDUINO_SEED_SIZE, SOLDUINO_PUBKEY_SIZE);
+    return true;
 }
 
 // Test function to verify Ed25519 signing
@@ -326,6 +2154,18 @@ bool testEd25519() {
         return false;
     }
     
+    // The expanded-key path must produce the same deterministic signature
+    Ed25519SigningKey signingKey;
+    bool expandedOk = expandSigningKey(privateKey, &signingKey) &&
+                      memcmp(signingKey.publicKey, expected_pubkey, 32) == 0 &&
+                      signMessageExpanded(message, 0, &signingKey, signature) &&
+                      memcmp(signature, expected_signature, 64) == 0;
+    clearSigningKey(&signingKey);
+    if (!expandedOk) {
+        Serial.println("Expanded-key signature mismatch");
+        return false;
+    }
+    
     // Verify signature
     if (!verifySignature(message, 0, signature, publicKey)) {
         Serial.println("Verification failed");
@@ -22,10 +22,23 @@
 // Base58 alphabet for Solana
 #define BASE58_ALPHABET "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
 
+// Longest Base58 encodings of 32- and 64-byte values (excluding terminator)
+#define BASE58_ENCODED_32_LEN 44
+#define BASE58_ENCODED_64_LEN 88
+
+// Largest input (in bytes) the generic Base58 codec accepts. Its scratch
+// space is sized from this on the stack (~1.4 KB at the default, which
+// covers a full 1232-byte transaction). Override at compile time if needed.
+#ifndef SOLDUINO_BASE58_MAX_BYTES
+#define SOLDUINO_BASE58_MAX_BYTES 1280
+#endif
+
 /**
- * Generate a random seed for keypair generation
+ * Generate a random seed for keypair generation from the platform CSPRNG
+ * (esp_fill_random on ESP32, getrandom/arc4random_buf or /dev/urandom on
+ * hosts)
  * @param seed Output buffer (32 bytes)
- * @return true if successful, false otherwise
+ * @return true if successful, false if the platform has no secure source
  */
 bool generateRandomSeed(uint8_t* seed);
 
@@ -56,6 +69,43 @@ bool generateKeypair(uint8_t* publicKey, uint8_t* privateKey);
  */
 bool signMessage(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature);
 
+/**
+ * Ed25519 signing key expanded from its seed: SHA-512(seed) split into the
+ * clamped secret scalar (reduced mod L) and the nonce prefix, plus the
+ * public key. Signing from this skips the per-signature SHA-512 of the seed.
+ * Holds secret material; wipe with clearSigningKey().
+ */
+struct Ed25519SigningKey {
+    uint8_t scalar[32];
+    uint8_t prefix[32];
+    uint8_t publicKey[SOLDUINO_PUBKEY_SIZE];
+};
+
+/**
+ * Expand a 64-byte Ed25519 private key (seed | public key).
+ * The public key is re-derived from the seed, not copied.
+ * @param privateKey Private key (64 bytes)
+ * @param key Output expanded key
+ * @return true if successful, false otherwise
+ */
+bool expandSigningKey(const uint8_t* privateKey, Ed25519SigningKey* key);
+
+/**
+ * Sign a message with an expanded key. Produces the same signature as
+ * signMessage() with the private key it was expanded from.
+ * @param message Message to sign
+ * @param messageLen Length of message
+ * @param key Expanded signing key
+ * @param signature Output signature (64 bytes)
+ * @return true if successful, false otherwise
+ */
+bool signMessageExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature);
+
+/**
+ * Zero an expanded signing key.
+ */
+void clearSigningKey(Ed25519SigningKey* key);
+
 /**
  * Verify Ed25519 signature
  * @param message Original message
@@ -66,6 +116,49 @@ bool signMessage(const uint8_t* message, size_t messageLen, const uint8_t* priva
  */
 bool verifySignature(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey);
 
+// Signatures combined into one multi-scalar multiplication per chunk;
+// bounds the chunk workspace (about 3 KB per signature, on the heap)
+#ifndef SOLDUINO_VERIFY_BATCH_MAX
+#ifdef ARDUINO
+#define SOLDUINO_VERIFY_BATCH_MAX 16
+#else
+#define SOLDUINO_VERIFY_BATCH_MAX 64
+#endif
+#endif
+
+/**
+ * One signature for verifySignaturesBatch(). Pointers are borrowed.
+ */
+struct SignatureBatchEntry {
+    const uint8_t* message;
+    size_t messageLen;
+    const uint8_t* signature;   // 64 bytes
+    const uint8_t* publicKey;   // 32 bytes
+};
+
+/**
+ * Verify many Ed25519 signatures at once.
+ *
+ * Each chunk of up to SOLDUINO_VERIFY_BATCH_MAX signatures is checked with
+ * one randomized equation, sum z_i (S_i B - R_i - k_i A_i) = 0 times the
+ * cofactor, evaluated as a single multi-scalar multiplication. If a chunk
+ * fails, its signatures are re-checked one by one with verifySignature()
+ * to find the bad ones. Malformed keys or signatures (non-canonical
+ * encodings, small-order points) skip the batch and go straight to
+ * verifySignature().
+ *
+ * As with other cofactored batch verifiers, a deliberately crafted
+ * signature whose R or A carries a small-order component can pass the
+ * batch equation while verifySignature() rejects it. Honestly generated
+ * signatures always agree.
+ *
+ * @param entries Signatures to verify
+ * @param count   Number of entries
+ * @param results Optional output: one verdict per entry (may be nullptr)
+ * @return true if every signature is valid
+ */
+bool verifySignaturesBatch(const SignatureBatchEntry* entries, size_t count, bool* results);
+
 /**
  * Encode bytes to Base58 string (for Solana addresses)
  * @param data Input data
@@ -76,6 +169,21 @@ bool verifySignature(const uint8_t* message, size_t messageLen, const uint8_t* s
  */
 size_t base58Encode(const uint8_t* data, size_t len, char* output, size_t outputLen);
 
+/**
+ * Encode a large input (e.g. a serialized transaction) to Base58.
+ *
+ * Same output as base58Encode(), but converts in 64-byte blocks so each
+ * block costs one division per output limb instead of sixteen. Prefer it
+ * above ~128 bytes; base58Encode() dispatches to it automatically.
+ *
+ * @param data Input data (at most SOLDUINO_BASE58_MAX_BYTES after leading zeros)
+ * @param len Length of data
+ * @param output Output string buffer
+ * @param outputLen Maximum output length
+ * @return Length of encoded string, or 0 on error
+ */
+size_t base58EncodeLarge(const uint8_t* data, size_t len, char* output, size_t outputLen);
+
 /**
  * Decode Base58 string to bytes
  * @param input Base58 encoded string
@@ -85,6 +193,40 @@ size_t base58Encode(const uint8_t* data, size_t len, char* output, size_t output
  */
 size_t base58Decode(const char* input, uint8_t* output, size_t outputLen);
 
+/**
+ * Encode exactly 32 bytes (pubkey, blockhash, seed) to Base58
+ * @param data Input data (32 bytes)
+ * @param output Output string buffer (BASE58_ENCODED_32_LEN + 1 is always enough)
+ * @param outputLen Maximum output length
+ * @return Length of encoded string, or 0 on error
+ */
+size_t base58Encode32(const uint8_t* data, char* output, size_t outputLen);
+
+/**
+ * Encode exactly 64 bytes (signature, keypair) to Base58
+ * @param data Input data (64 bytes)
+ * @param output Output string buffer (BASE58_ENCODED_64_LEN + 1 is always enough)
+ * @param outputLen Maximum output length
+ * @return Length of encoded string, or 0 on error
+ */
+size_t base58Encode64(const uint8_t* data, char* output, size_t outputLen);
+
+/**
+ * Decode a Base58 string that must represent exactly 32 bytes
+ * @param input Base58 encoded string
+ * @param output Output buffer (32 bytes)
+ * @return true if the string is valid and decodes to 32 bytes
+ */
+bool base58Decode32(const char* input, uint8_t* output);
+
+/**
+ * Decode a Base58 string that must represent exactly 64 bytes
+ * @param input Base58 encoded string
+ * @param output Output buffer (64 bytes)
+ * @return true if the string is valid and decodes to 64 bytes
+ */
+bool base58Decode64(const char* input, uint8_t* output);
+
 /**
  * Convert public key bytes to Solana address (Base58)
  * @param publicKey Public key bytes (32 bytes)
@@ -127,6 +269,73 @@ bool base58ToPrivateKey(const char* input, uint8_t* privateKey);
  */
 bool getPublicKeyFromPrivate(const uint8_t* privateKey, uint8_t* publicKey);
 
+/**
+ * Check whether 32 bytes decompress to a point on the Ed25519 curve.
+ *
+ * Matches Solana's Pubkey::is_on_curve (curve25519-dalek decompression):
+ * only the curve equation is tested -- no canonical-encoding, small-order
+ * or prime-order subgroup checks. A valid PDA must fail this test.
+ *
+ * @param point 32-byte compressed Edwards point
+ * @return true if the bytes decode to a point on the curve
+ */
+bool isOnCurve(const uint8_t* point);
+
+// ============================================================================
+// Multi-lane SHA-256
+// ============================================================================
+// Hashes SOLDUINO_SHA256_LANES messages that share a prefix in one pass.
+// Each lane is a GCC vector element, so hosts with SSE2/AVX2 run the lanes
+// in SIMD registers and other targets get plain scalar code.
+
+#ifndef SOLDUINO_SHA256_LANES
+#if defined(__AVX2__)
+#define SOLDUINO_SHA256_LANES 8
+#else
+#define SOLDUINO_SHA256_LANES 4
+#endif
+#endif
+
+/**
+ * SHA-256 state after absorbing a message prefix: the chaining value for
+ * every complete 64-byte block plus the bytes of the unfinished block.
+ */
+struct Sha256Midstate {
+    uint32_t h[8];
+    uint64_t length;      // total bytes absorbed
+    uint8_t tail[64];
+    uint8_t tailLen;
+};
+
+/** Start an empty prefix. */
+void sha256MidstateInit(Sha256Midstate* mid);
+
+/** Append data to the prefix. */
+void sha256MidstateUpdate(Sha256Midstate* mid, const uint8_t* data, size_t len);
+
+/**
+ * Finish a single message prefix | suffix.
+ * @param mid    Prefix (not modified)
+ * @param suffix Remaining bytes
+ * @param len    Length of suffix
+ * @param digest Output 32-byte digest
+ */
+void sha256Finish(const Sha256Midstate* mid, const uint8_t* suffix, size_t len, uint8_t digest[32]);
+
+/**
+ * Finish SOLDUINO_SHA256_LANES messages of the form prefix | suffixes[i].
+ * All suffixes must have the same length; lanes are compressed together.
+ *
+ * @param mid       Shared prefix (not modified)
+ * @param suffixes  One suffix pointer per lane
+ * @param suffixLen Length of every suffix
+ * @param digests   Output: one 32-byte digest per lane
+ */
+void sha256FinishLanes(const Sha256Midstate* mid,
+                       const uint8_t* const suffixes[SOLDUINO_SHA256_LANES],
+                       size_t suffixLen,
+                       uint8_t digests[SOLDUINO_SHA256_LANES][32]);
+
 // Test function for Ed25519
 bool testEd25519();
 
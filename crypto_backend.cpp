@@ -0,0 +1,343 @@
+#include "crypto_backend.h"
+#include <string.h>
+
+#if SOLDUINO_HAS_SODIUM
+#include <sodium.h>
+#endif
+
+#if SOLDUINO_CRYPTO_ATOMIC
+#include <mutex>
+#endif
+
+#if SOLDUINO_HAS_MBEDTLS
+#include <mbedtls/version.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+#endif
+
+// ============================================================================
+// libsodium backend
+// ============================================================================
+
+#if SOLDUINO_HAS_SODIUM
+
+static bool sodiumInit() {
+    return sodium_init() >= 0;
+}
+
+static void sodiumSha256(const CryptoSlice* parts, size_t count, uint8_t digest[32]) {
+    crypto_hash_sha256_state state;
+    crypto_hash_sha256_init(&state);
+    for (size_t i = 0; i < count; i++) {
+        crypto_hash_sha256_update(&state, parts[i].data, (unsigned long long)parts[i].len);
+    }
+    crypto_hash_sha256_final(&state, digest);
+}
+
+static void sodiumSha512(const CryptoSlice* parts, size_t count, uint8_t digest[64]) {
+    crypto_hash_sha512_state state;
+    crypto_hash_sha512_init(&state);
+    for (size_t i = 0; i < count; i++) {
+        crypto_hash_sha512_update(&state, parts[i].data, (unsigned long long)parts[i].len);
+    }
+    crypto_hash_sha512_final(&state, digest);
+}
+
+static bool sodiumRandomBytes(uint8_t* buf, size_t len) {
+    randombytes_buf(buf, len);
+    return true;
+}
+
+static bool sodiumSeedKeypair(const uint8_t* seed, uint8_t* publicKey, uint8_t* privateKey) {
+    return crypto_sign_ed25519_seed_keypair(publicKey, privateKey, seed) == 0;
+}
+
+static bool sodiumSign(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature) {
+    unsigned long long siglen = 0;
+    int result = crypto_sign_ed25519_detached(signature, &siglen, message, (unsigned long long)messageLen, privateKey);
+    return result == 0 && siglen == SOLDUINO_SIGNATURE_SIZE;
+}
+
+static bool sodiumVerify(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey) {
+    return crypto_sign_ed25519_verify_detached(signature, message, (unsigned long long)messageLen, publicKey) == 0;
+}
+
+typedef void (*Sha512Fn)(const CryptoSlice* parts, size_t count, uint8_t digest[64]);
+
+/**
+ * RFC 8032 key expansion on libsodium's scalar helpers, hashing with the
+ * given SHA-512 so the mbedTLS backend can reuse it.
+ */
+static bool sodiumExpandKeyWith(Sha512Fn sha512, const uint8_t* privateKey, Ed25519SigningKey* key) {
+    // h = SHA-512(seed), scalar = clamp(h[0..32]), prefix = h[32..64]
+    uint8_t h[64];
+    CryptoSlice seed = {privateKey, SOLDUINO_SEED_SIZE};
+    sha512(&seed, 1, h);
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+
+    // Reduce the clamped scalar mod L once so signing works on canonical scalars
+    uint8_t wide[64];
+    memcpy(wide, h, 32);
+    memset(wide + 32, 0, 32);
+    crypto_core_ed25519_scalar_reduce(key->scalar, wide);
+    memcpy(key->prefix, h + 32, 32);
+
+    bool ok = crypto_scalarmult_ed25519_base_noclamp(key->publicKey, key->scalar) == 0;
+    sodium_memzero(h, sizeof(h));
+    sodium_memzero(wide, sizeof(wide));
+    if (!ok) {
+        clearSigningKey(key);
+    }
+    return ok;
+}
+
+static bool sodiumSignExpandedWith(Sha512Fn sha512, const uint8_t* message, size_t messageLen,
+                                   const Ed25519SigningKey* key, uint8_t* signature) {
+    // r = SHA-512(prefix | M) mod L, R = rB
+    uint8_t digest[64];
+    uint8_t r[32];
+    CryptoSlice nonceParts[2] = {{key->prefix, 32}, {message, messageLen}};
+    sha512(nonceParts, 2, digest);
+    crypto_core_ed25519_scalar_reduce(r, digest);
+    if (crypto_scalarmult_ed25519_base_noclamp(signature, r) != 0) {
+        sodium_memzero(digest, sizeof(digest));
+        sodium_memzero(r, sizeof(r));
+        return false;
+    }
+
+    // k = SHA-512(R | A | M) mod L, S = r + k * scalar mod L
+    uint8_t k[32];
+    CryptoSlice challengeParts[3] = {{signature, 32}, {key->publicKey, SOLDUINO_PUBKEY_SIZE}, {message, messageLen}};
+    sha512(challengeParts, 3, digest);
+    crypto_core_ed25519_scalar_reduce(k, digest);
+    crypto_core_ed25519_scalar_mul(k, k, key->scalar);
+    crypto_core_ed25519_scalar_add(signature + 32, k, r);
+
+    sodium_memzero(digest, sizeof(digest));
+    sodium_memzero(r, sizeof(r));
+    sodium_memzero(k, sizeof(k));
+    return true;
+}
+
+static bool sodiumExpandKey(const uint8_t* privateKey, Ed25519SigningKey* key) {
+    return sodiumExpandKeyWith(sodiumSha512, privateKey, key);
+}
+
+static bool sodiumSignExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature) {
+    return sodiumSignExpandedWith(sodiumSha512, message, messageLen, key, signature);
+}
+
+const CryptoBackend CRYPTO_BACKEND_LIBSODIUM = {
+    "libsodium",
+    sodiumInit,
+    sodiumSha256,
+    sodiumSha512,
+    sodiumRandomBytes,
+    sodiumSeedKeypair,
+    sodiumSign,
+    sodiumExpandKey,
+    sodiumSignExpanded,
+    sodiumVerify,
+    isOnCurve
+};
+
+#endif // SOLDUINO_HAS_SODIUM
+
+// ============================================================================
+// mbedTLS backend
+// ============================================================================
+// mbedTLS has no Ed25519, so only the hashes come from it. On ESP32 those
+// run on the SHA peripheral; signing hashes the message twice with
+// SHA-512, which is where the engine pays off.
+
+#if SOLDUINO_HAS_MBEDTLS
+
+// mbedTLS 2.x spells the int-returning hash calls with a _ret suffix
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define SOLDUINO_MBEDTLS_CALL(fn) fn
+#else
+#define SOLDUINO_MBEDTLS_CALL(fn) fn##_ret
+#endif
+
+static void mbedSha256(const CryptoSlice* parts, size_t count, uint8_t digest[32]) {
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    SOLDUINO_MBEDTLS_CALL(mbedtls_sha256_starts)(&ctx, 0);
+    for (size_t i = 0; i < count; i++) {
+        SOLDUINO_MBEDTLS_CALL(mbedtls_sha256_update)(&ctx, parts[i].data, parts[i].len);
+    }
+    SOLDUINO_MBEDTLS_CALL(mbedtls_sha256_finish)(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+}
+
+static void mbedSha512(const CryptoSlice* parts, size_t count, uint8_t digest[64]) {
+    mbedtls_sha512_context ctx;
+    mbedtls_sha512_init(&ctx);
+    SOLDUINO_MBEDTLS_CALL(mbedtls_sha512_starts)(&ctx, 0);
+    for (size_t i = 0; i < count; i++) {
+        SOLDUINO_MBEDTLS_CALL(mbedtls_sha512_update)(&ctx, parts[i].data, parts[i].len);
+    }
+    SOLDUINO_MBEDTLS_CALL(mbedtls_sha512_finish)(&ctx, digest);
+    mbedtls_sha512_free(&ctx);
+}
+
+static bool mbedExpandKey(const uint8_t* privateKey, Ed25519SigningKey* key) {
+    return sodiumExpandKeyWith(mbedSha512, privateKey, key);
+}
+
+static bool mbedSignExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature) {
+    return sodiumSignExpandedWith(mbedSha512, message, messageLen, key, signature);
+}
+
+static bool mbedSign(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature) {
+    Ed25519SigningKey key;
+    bool ok = mbedExpandKey(privateKey, &key) &&
+              mbedSignExpanded(message, messageLen, &key, signature);
+    clearSigningKey(&key);
+    return ok;
+}
+
+const CryptoBackend CRYPTO_BACKEND_MBEDTLS = {
+    "mbedtls",
+    sodiumInit,
+    mbedSha256,
+    mbedSha512,
+    sodiumRandomBytes,
+    sodiumSeedKeypair,
+    mbedSign,
+    mbedExpandKey,
+    mbedSignExpanded,
+    sodiumVerify,
+    isOnCurve
+};
+
+#endif // SOLDUINO_HAS_MBEDTLS
+
+// ============================================================================
+// Backend selection
+// ============================================================================
+
+static const CryptoBackend* defaultCryptoBackend() {
+#if SOLDUINO_CRYPTO_BACKEND == SOLDUINO_CRYPTO_REFERENCE
+    return &CRYPTO_BACKEND_REFERENCE;
+#elif SOLDUINO_CRYPTO_BACKEND == SOLDUINO_CRYPTO_MBEDTLS
+    return &CRYPTO_BACKEND_MBEDTLS;
+#else
+    return &CRYPTO_BACKEND_LIBSODIUM;
+#endif
+}
+
+// Bootstrap table: every entry starts the default backend, then forwards.
+// Only the first crypto call of a program that never called begin() lands
+// here; afterwards activeCryptoBackend points at the real table.
+
+extern const CryptoBackend CRYPTO_BACKEND_BOOTSTRAP;
+
+static const CryptoBackend* bootstrapBackend() {
+    if (!cryptoBegin()) {
+        return nullptr;
+    }
+    return cryptoBackend();
+}
+
+static bool bootInit() {
+    return cryptoBegin();
+}
+
+static void bootSha256(const CryptoSlice* parts, size_t count, uint8_t digest[32]) {
+    const CryptoBackend* b = bootstrapBackend();
+    (b ? b : defaultCryptoBackend())->sha256(parts, count, digest);
+}
+
+static void bootSha512(const CryptoSlice* parts, size_t count, uint8_t digest[64]) {
+    const CryptoBackend* b = bootstrapBackend();
+    (b ? b : defaultCryptoBackend())->sha512(parts, count, digest);
+}
+
+static bool bootRandomBytes(uint8_t* buf, size_t len) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->randomBytes(buf, len);
+}
+
+static bool bootSeedKeypair(const uint8_t* seed, uint8_t* publicKey, uint8_t* privateKey) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->seedKeypair(seed, publicKey, privateKey);
+}
+
+static bool bootSign(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->sign(message, messageLen, privateKey, signature);
+}
+
+static bool bootExpandKey(const uint8_t* privateKey, Ed25519SigningKey* key) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->expandKey(privateKey, key);
+}
+
+static bool bootSignExpanded(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->signExpanded(message, messageLen, key, signature);
+}
+
+static bool bootVerify(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey) {
+    const CryptoBackend* b = bootstrapBackend();
+    return b && b->verify(message, messageLen, signature, publicKey);
+}
+
+static bool bootIsOnCurve(const uint8_t* point) {
+    const CryptoBackend* b = bootstrapBackend();
+    return (b ? b : defaultCryptoBackend())->isOnCurve(point);
+}
+
+const CryptoBackend CRYPTO_BACKEND_BOOTSTRAP = {
+    "bootstrap",
+    bootInit,
+    bootSha256,
+    bootSha512,
+    bootRandomBytes,
+    bootSeedKeypair,
+    bootSign,
+    bootExpandKey,
+    bootSignExpanded,
+    bootVerify,
+    bootIsOnCurve
+};
+
+#if SOLDUINO_CRYPTO_ATOMIC
+std::atomic<const CryptoBackend*> activeCryptoBackend(&CRYPTO_BACKEND_BOOTSTRAP);
+
+// Serializes backend starts, so two threads' first crypto calls do not
+// run init() side by side
+static std::mutex cryptoBeginMutex;
+#else
+const CryptoBackend* activeCryptoBackend = &CRYPTO_BACKEND_BOOTSTRAP;
+#endif
+
+bool cryptoBegin(const CryptoBackend* backend) {
+    // Keep whatever is already running
+    if (!backend && cryptoBackend() != &CRYPTO_BACKEND_BOOTSTRAP) {
+        return true;
+    }
+
+#if SOLDUINO_CRYPTO_ATOMIC
+    std::lock_guard<std::mutex> lock(cryptoBeginMutex);
+#endif
+    if (!backend) {
+        // Another thread may have started it while this one waited
+        if (cryptoBackend() != &CRYPTO_BACKEND_BOOTSTRAP) {
+            return true;
+        }
+        backend = defaultCryptoBackend();
+    }
+    if (backend == &CRYPTO_BACKEND_BOOTSTRAP || !backend->init()) {
+        return false;
+    }
+#if SOLDUINO_CRYPTO_ATOMIC
+    activeCryptoBackend.store(backend, std::memory_order_release);
+#else
+    activeCryptoBackend = backend;
+#endif
+    return true;
+}
@@ -0,0 +1,182 @@
+#ifndef SOLDUINO_CRYPTO_BACKEND_H
+#define SOLDUINO_CRYPTO_BACKEND_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "crypto.h"
+
+// ============================================================================
+// Solduino Crypto Backends
+// ============================================================================
+// Every Ed25519 and curve operation, and every hash except program
+// address derivation, goes through the active CryptoBackend. PDA search
+// hashes from a saved SHA-256 midstate, several bumps per pass
+// (sha256Finish() / sha256FinishLanes() in crypto.h), which no backend
+// interface offers, so it always uses the in-tree SHA-256. Backends:
+// - CRYPTO_BACKEND_LIBSODIUM  libsodium for everything (default)
+// - CRYPTO_BACKEND_MBEDTLS    mbedTLS SHA-256/SHA-512 (the hardware SHA
+//                             engine on ESP32), libsodium for curve math
+// - CRYPTO_BACKEND_REFERENCE  portable in-tree C++ implementation
+//
+// Pick one at compile time with SOLDUINO_CRYPTO_BACKEND, or at run time
+// with Solduino::begin(&CRYPTO_BACKEND_...) / cryptoBegin(). Selecting a
+// backend also performs its one-time initialization and table warm-up, so
+// the operations themselves never check init state. Calls made before any
+// begin() initialize the compile-time default on first use; that lazy
+// start is safe from any thread. Switching to another backend is not:
+// call begin() before starting threaded work (sign(), findProgramAddresses(),
+// VanityGrinder) rather than while it runs.
+//
+// Only the libsodium and mbedTLS tables need libsodium. Without it
+// (SOLDUINO_HAS_SODIUM 0, detected from <sodium.h> where the compiler can)
+// they are left out and the reference backend is the default.
+// ============================================================================
+
+#define SOLDUINO_CRYPTO_LIBSODIUM 1
+#define SOLDUINO_CRYPTO_MBEDTLS 2
+#define SOLDUINO_CRYPTO_REFERENCE 3
+
+// libsodium ships with the ESP32 core
+#ifndef SOLDUINO_HAS_SODIUM
+#if defined(__has_include)
+#if __has_include(<sodium.h>)
+#define SOLDUINO_HAS_SODIUM 1
+#else
+#define SOLDUINO_HAS_SODIUM 0
+#endif
+#else
+#define SOLDUINO_HAS_SODIUM 1
+#endif
+#endif
+
+#ifndef SOLDUINO_CRYPTO_BACKEND
+#if SOLDUINO_HAS_SODIUM
+#define SOLDUINO_CRYPTO_BACKEND SOLDUINO_CRYPTO_LIBSODIUM
+#else
+#define SOLDUINO_CRYPTO_BACKEND SOLDUINO_CRYPTO_REFERENCE
+#endif
+#endif
+
+#if !SOLDUINO_HAS_SODIUM && SOLDUINO_CRYPTO_BACKEND != SOLDUINO_CRYPTO_REFERENCE
+#error "SOLDUINO_CRYPTO_BACKEND needs libsodium; use SOLDUINO_CRYPTO_REFERENCE without it"
+#endif
+
+// mbedTLS ships with the ESP32 core; elsewhere opt in explicitly. The
+// mbedTLS backend still takes its curve math from libsodium
+#ifndef SOLDUINO_HAS_MBEDTLS
+#if SOLDUINO_HAS_SODIUM && (defined(ESP32) || SOLDUINO_CRYPTO_BACKEND == SOLDUINO_CRYPTO_MBEDTLS)
+#define SOLDUINO_HAS_MBEDTLS 1
+#else
+#define SOLDUINO_HAS_MBEDTLS 0
+#endif
+#endif
+
+// The active backend is read by worker threads on ESP32 and hosted
+// builds, so there it is a std::atomic
+#ifndef SOLDUINO_CRYPTO_ATOMIC
+#if defined(ESP32) || !defined(ARDUINO)
+#define SOLDUINO_CRYPTO_ATOMIC 1
+#else
+#define SOLDUINO_CRYPTO_ATOMIC 0
+#endif
+#endif
+
+#if SOLDUINO_CRYPTO_ATOMIC
+#include <atomic>
+#endif
+
+/**
+ * A contiguous piece of a hash input. Hash operations take a list of
+ * slices so multi-part inputs (R | A | message) need no staging buffer.
+ */
+struct CryptoSlice {
+    const uint8_t* data;
+    size_t len;
+};
+
+/**
+ * Crypto backend operation table. Arguments are validated by the public
+ * wrappers in crypto.h; operations may assume non-null, correctly sized
+ * buffers.
+ */
+struct CryptoBackend {
+    const char* name;
+
+    /** One-time setup and table warm-up; false if the backend is unusable */
+    bool (*init)();
+
+    void (*sha256)(const CryptoSlice* parts, size_t count, uint8_t digest[32]);
+    void (*sha512)(const CryptoSlice* parts, size_t count, uint8_t digest[64]);
+
+    /** Fill buf with cryptographically secure random bytes */
+    bool (*randomBytes)(uint8_t* buf, size_t len);
+
+    /** Derive (public key, seed | public key) from a 32-byte seed */
+    bool (*seedKeypair)(const uint8_t* seed, uint8_t* publicKey, uint8_t* privateKey);
+
+    /** Sign with a 64-byte private key (seed | public key) */
+    bool (*sign)(const uint8_t* message, size_t messageLen, const uint8_t* privateKey, uint8_t* signature);
+
+    /** See expandSigningKey() / signMessageExpanded() */
+    bool (*expandKey)(const uint8_t* privateKey, Ed25519SigningKey* key);
+    bool (*signExpanded)(const uint8_t* message, size_t messageLen, const Ed25519SigningKey* key, uint8_t* signature);
+
+    /** Strict Ed25519 verification with libsodium's acceptance rules */
+    bool (*verify)(const uint8_t* message, size_t messageLen, const uint8_t* signature, const uint8_t* publicKey);
+
+    /** Solana's on-curve test (see isOnCurve()) */
+    bool (*isOnCurve)(const uint8_t* point);
+};
+
+#if SOLDUINO_HAS_SODIUM
+extern const CryptoBackend CRYPTO_BACKEND_LIBSODIUM;
+#endif
+#if SOLDUINO_HAS_MBEDTLS
+extern const CryptoBackend CRYPTO_BACKEND_MBEDTLS;
+#endif
+extern const CryptoBackend CRYPTO_BACKEND_REFERENCE;
+
+// Active backend. Starts on a bootstrap table that runs cryptoBegin() on
+// first use; read it through cryptoBackend().
+#if SOLDUINO_CRYPTO_ATOMIC
+extern std::atomic<const CryptoBackend*> activeCryptoBackend;
+#else
+extern const CryptoBackend* activeCryptoBackend;
+#endif
+
+/**
+ * Initialize and select a crypto backend.
+ * @param backend Backend to use, or nullptr to keep the running backend
+ *                (starting SOLDUINO_CRYPTO_BACKEND if none is running yet)
+ * @return true if the backend initialized; the previous one stays active otherwise
+ */
+bool cryptoBegin(const CryptoBackend* backend = nullptr);
+
+/**
+ * The backend every crypto call dispatches to.
+ */
+inline const CryptoBackend* cryptoBackend() {
+#if SOLDUINO_CRYPTO_ATOMIC
+    return activeCryptoBackend.load(std::memory_order_acquire);
+#else
+    return activeCryptoBackend;
+#endif
+}
+
+/**
+ * SHA-256 of a single buffer through the active backend.
+ */
+inline void cryptoSha256(const uint8_t* data, size_t len, uint8_t digest[32]) {
+    CryptoSlice part = {data, len};
+    cryptoBackend()->sha256(&part, 1, digest);
+}
+
+/**
+ * SHA-512 of a single buffer through the active backend.
+ */
+inline void cryptoSha512(const uint8_t* data, size_t len, uint8_t digest[64]) {
+    CryptoSlice part = {data, len};
+    cryptoBackend()->sha512(&part, 1, digest);
+}
+
+#endif // SOLDUINO_CRYPTO_BACKEND_H
@@ -0,0 +1,235 @@
+/**
+ * Solduino Base58 Benchmark
+ *
+ * Compares the limb-based Base58 codec against the original byte-at-a-time
+ * implementation (kept below as legacyBase58Encode/legacyBase58Decode) on
+ * the inputs the library actually sees:
+ *   - 32-byte pubkeys / blockhashes  (publicKeyToAddress, addressToPublicKey)
+ *   - 64-byte signatures / keypairs
+ *   - 200 / 600 / 1232-byte serialized transactions (encodeTransactionBase58),
+ *     with Base64 shown for reference
+ *
+ * Every round-trip is cross-checked against the legacy output before timing,
+ * so a mismatch is reported instead of a misleading number.
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const uint32_t ITERATIONS = 2000;
+const uint32_t LARGE_ITERATIONS = 20;   // legacy takes tens of ms per 1232-byte tx
+
+// ============================================================================
+// Legacy implementation (reference for comparison)
+// ============================================================================
+// Verbatim except for the final reversal, which now skips the leading '1's
+// (the original reversed them to the end of the string for inputs with
+// leading zero bytes).
+
+static const char legacyAlphabet[] = BASE58_ALPHABET;
+
+size_t legacyBase58Encode(const uint8_t* data, size_t len, char* output, size_t outputLen) {
+    size_t zeros = 0;
+    while (zeros < len && data[zeros] == 0) zeros++;
+
+    uint8_t* buffer = (uint8_t*)malloc(len * 2);
+    if (!buffer) return 0;
+    memcpy(buffer, data, len);
+
+    size_t idx = 0;
+    for (size_t i = 0; i < zeros && idx < outputLen - 1; i++) output[idx++] = '1';
+
+    size_t start = zeros;
+    while (start < len) {
+        uint32_t remainder = 0;
+        for (size_t i = start; i < len; i++) {
+            remainder = remainder * 256 + buffer[i];
+            buffer[i] = remainder / 58;
+            remainder %= 58;
+        }
+        if (idx >= outputLen - 1) break;
+        output[idx++] = legacyAlphabet[remainder];
+        while (start < len && buffer[start] == 0) start++;
+    }
+    for (size_t i = zeros; i < zeros + (idx - zeros) / 2; i++) {
+        char t = output[i];
+        output[i] = output[idx - 1 - (i - zeros)];
+        output[idx - 1 - (i - zeros)] = t;
+    }
+    output[idx] = '\0';
+    free(buffer);
+    return idx;
+}
+
+size_t legacyBase58Decode(const char* input, uint8_t* output, size_t outputLen) {
+    size_t inputLen = strlen(input);
+    size_t zeros = 0;
+    while (zeros < inputLen && input[zeros] == '1') zeros++;
+
+    uint8_t* buffer = (uint8_t*)malloc(inputLen * 2);
+    if (!buffer) return 0;
+    memset(buffer, 0, inputLen * 2);
+
+    for (size_t i = zeros; i < inputLen; i++) {
+        const char* pos = strchr(legacyAlphabet, input[i]);
+        if (!pos) { free(buffer); return 0; }
+        uint32_t carry = pos - legacyAlphabet;
+        for (size_t j = 0; j < inputLen * 2; j++) {
+            carry += buffer[j] * 58;
+            buffer[j] = carry & 0xFF;
+            carry >>= 8;
+        }
+    }
+
+    size_t resultLen = 0;
+    for (size_t i = inputLen * 2; i > 0; i--) {
+        if (buffer[i - 1] != 0) { resultLen = i; break; }
+    }
+    resultLen += zeros;
+    if (resultLen > outputLen) { free(buffer); return 0; }
+
+    memset(output, 0, outputLen);
+    for (size_t i = 0; i < resultLen - zeros; i++) {
+        output[zeros + i] = buffer[resultLen - zeros - 1 - i];
+    }
+    free(buffer);
+    return resultLen;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void fillRandom(uint8_t* buf, size_t len) {
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)random(256);
+}
+
+void printRate(const char* label, uint32_t elapsedUs) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / ITERATIONS, 2);
+    Serial.print(" us/op  (");
+    Serial.print(elapsedUs > 0 ? (uint32_t)((uint64_t)ITERATIONS * 1000000ULL / elapsedUs) : 0);
+    Serial.println(" ops/s)");
+}
+
+bool crossCheck(size_t len) {
+    uint8_t data[64];
+    char a[128], b[128];
+    uint8_t back[64];
+    for (int round = 0; round < 200; round++) {
+        fillRandom(data, len);
+        if (round % 10 == 0) data[0] = 0;   // exercise leading-zero handling
+        size_t na = legacyBase58Encode(data, len, a, sizeof(a));
+        size_t nb = base58Encode(data, len, b, sizeof(b));
+        if (na != nb || strcmp(a, b) != 0) return false;
+        if (base58Decode(b, back, len) != len || memcmp(back, data, len) != 0) return false;
+    }
+    return true;
+}
+
+void benchSize(size_t len) {
+    uint8_t data[64];
+    char text[128];
+    uint8_t back[64];
+    fillRandom(data, len);
+
+    Serial.print("\n--- ");
+    Serial.print(len);
+    Serial.println(" bytes ---");
+
+    if (!crossCheck(len)) {
+        Serial.println("  [ERROR] Output mismatch against legacy codec");
+        return;
+    }
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < ITERATIONS; i++) legacyBase58Encode(data, len, text, sizeof(text));
+    printRate("legacy encode", micros() - start);
+
+    start = micros();
+    for (uint32_t i = 0; i < ITERATIONS; i++) base58Encode(data, len, text, sizeof(text));
+    printRate("limb   encode", micros() - start);
+
+    start = micros();
+    for (uint32_t i = 0; i < ITERATIONS; i++) legacyBase58Decode(text, back, len);
+    printRate("legacy decode", micros() - start);
+
+    start = micros();
+    if (len == 32) {
+        for (uint32_t i = 0; i < ITERATIONS; i++) base58Decode32(text, back);
+    } else {
+        for (uint32_t i = 0; i < ITERATIONS; i++) base58Decode64(text, back);
+    }
+    printRate("limb   decode", micros() - start);
+}
+
+void printThroughput(const char* label, uint32_t elapsedUs, size_t len) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / LARGE_ITERATIONS / 1000.0f, 3);
+    Serial.print(" ms/op  (");
+    Serial.print(elapsedUs > 0 ? (uint32_t)((uint64_t)len * LARGE_ITERATIONS * 1000000ULL / elapsedUs / 1024) : 0);
+    Serial.println(" KiB/s)");
+}
+
+void benchLarge(size_t len) {
+    static uint8_t data[1232];
+    static char legacyText[1800];
+    static char text[1800];
+    fillRandom(data, len);
+
+    Serial.print("\n--- ");
+    Serial.print(len);
+    Serial.println(" bytes (transaction) ---");
+
+    legacyBase58Encode(data, len, legacyText, sizeof(legacyText));
+    base58EncodeLarge(data, len, text, sizeof(text));
+    if (strcmp(legacyText, text) != 0) {
+        Serial.println("  [ERROR] Output mismatch against legacy codec");
+        return;
+    }
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < LARGE_ITERATIONS; i++) legacyBase58Encode(data, len, text, sizeof(text));
+    printThroughput("legacy base58", micros() - start, len);
+
+    start = micros();
+    for (uint32_t i = 0; i < LARGE_ITERATIONS; i++) base58EncodeLarge(data, len, text, sizeof(text));
+    printThroughput("block  base58", micros() - start, len);
+
+    start = micros();
+    for (uint32_t i = 0; i < LARGE_ITERATIONS; i++) Base64::encode(data, len, text, sizeof(text));
+    printThroughput("base64       ", micros() - start, len);
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Base58 Benchmark ===");
+    Serial.print("Iterations per measurement: ");
+    Serial.println(ITERATIONS);
+
+    benchSize(32);
+    benchSize(64);
+    benchLarge(200);
+    benchLarge(600);
+    benchLarge(1232);
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
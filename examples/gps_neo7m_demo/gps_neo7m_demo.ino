@@ -63,6 +63,8 @@ uint8_t pdaBump;
 TinyGPSPlus gps;
 HardwareSerial gpsSerial(1);
 
+TransactionTemplate recordTemplate;
+
 static char g_txBuf[2048];
 
 // ============================================================================
@@ -99,28 +101,45 @@ bool readGpsFix(int64_t& latE7, int64_t& lngE7, int64_t& sats) {
 // Transaction Push
 // ============================================================================
 
-bool pushSensorData(int64_t latE7, int64_t lngE7, int64_t sats) {
-    int64_t timestamp = (int64_t)(millis() / 1000);
-
-    Instruction ix;
+// The accounts, program and data layout never change between readings, so
+// the transaction is serialized once here and only the blockhash and the
+// i64 fields are patched before each send.
+bool buildRecordTemplate() {
+    // Sized for this record: three keys and 40 data bytes
+    BasicInstruction<3, 40> ix;
     ix.setProgram(programId);
     ix.addKey(authorityPub, true, true);
     ix.addKey(dataAccountPda, false, true);
     ix.addKey(SystemProgram::PROGRAM_ID, false, false);
     ix.writeBytes(RECORD_DATA_DISCRIMINATOR, 8);
-    ix.writeI64LE(latE7);
-    ix.writeI64LE(lngE7);
-    ix.writeI64LE(sats);
-    ix.writeI64LE(timestamp);
+    ix.writeI64LE(0);   // latE7
+    ix.writeI64LE(0);   // lngE7
+    ix.writeI64LE(0);   // sats
+    ix.writeI64LE(0);   // timestamp
+
+    // Those keys plus the program ID, one instruction
+    BasicTransaction<4, 1, 40> tx;
+    if (!tx.add(ix)) return false;
+    if (!recordTemplate.compile(tx)) return false;
+    if (recordTemplate.addField("latE7", 0, 8, 8) < 0) return false;
+    if (recordTemplate.addField("lngE7", 0, 16, 8) < 0) return false;
+    if (recordTemplate.addField("sats", 0, 24, 8) < 0) return false;
+    if (recordTemplate.addField("timestamp", 0, 32, 8) < 0) return false;
+    return true;
+}
 
-    Transaction tx;
-    tx.add(ix);
+bool pushSensorData(int64_t latE7, int64_t lngE7, int64_t sats) {
+    int64_t timestamp = (int64_t)(millis() / 1000);
 
     uint8_t blockhash[BLOCKHASH_SIZE];
     if (!rpcClient.getLatestBlockhashBytes(blockhash)) return false;
-    if (!tx.setRecentBlockhash(blockhash)) return false;
-    if (!tx.sign(authorityKeypair)) return false;
-    if (!TransactionSerializer::encodeTransactionBase58(tx, g_txBuf, sizeof(g_txBuf))) return false;
+    if (!recordTemplate.setBlockhash(blockhash)) return false;
+    if (!recordTemplate.setI64("latE7", latE7)) return false;
+    if (!recordTemplate.setI64("lngE7", lngE7)) return false;
+    if (!recordTemplate.setI64("sats", sats)) return false;
+    if (!recordTemplate.setI64("timestamp", timestamp)) return false;
+    if (!recordTemplate.sign(authorityKeypair)) return false;
+    if (!recordTemplate.encode(g_txBuf, sizeof(g_txBuf), TX_ENCODING_BASE58)) return false;
 
     String sig = rpcClient.sendTransactionBase58(g_txBuf);
     if (sig.length() == 0) {
@@ -193,6 +212,11 @@ void setup() {
         while (true) delay(1000);
     }
 
+    if (!buildRecordTemplate()) {
+        Serial.println("[FATAL] Transaction template build failed -- halting.");
+        while (true) delay(1000);
+    }
+
     gpsSerial.begin(GPS_BAUD, SERIAL_8N1, GPS_RX_PIN, GPS_TX_PIN);
 
     Serial.println("Setup complete.\n");
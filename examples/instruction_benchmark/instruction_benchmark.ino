@@ -0,0 +1,183 @@
+/**
+ * Solduino Instruction Building Benchmark
+ *
+ * Builds the same 4-instruction transaction (two SOL transfers, a token
+ * transfer and a create-account) three ways and checks that all three
+ * serialize to the same message:
+ *   - helpers: tx.add(SystemProgram::transfer(...)), where every helper
+ *     returns an Instruction by value that add() then copies from
+ *   - InstructionRef: spans over account metas and data the sketch
+ *     already holds, read once by add()
+ *   - emplace: tx.emplace<SystemProgram::Transfer>(...), which encodes
+ *     keys and data straight into the transaction
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const uint32_t ITERATIONS = 2000;
+const uint64_t ACCOUNT_LAMPORTS = 2039280;
+const uint64_t TOKEN_ACCOUNT_SPACE = 165;
+
+static Transaction tx;
+static Transaction reference;
+static uint8_t payer[SOLDUINO_PUBKEY_SIZE];
+static uint8_t alice[SOLDUINO_PUBKEY_SIZE];
+static uint8_t bob[SOLDUINO_PUBKEY_SIZE];
+static uint8_t source[SOLDUINO_PUBKEY_SIZE];
+static uint8_t dest[SOLDUINO_PUBKEY_SIZE];
+static uint8_t newAccount[SOLDUINO_PUBKEY_SIZE];
+static uint8_t blockhash[BLOCKHASH_SIZE];
+
+// Pre-encoded parts for the InstructionRef path
+static AccountMeta aliceMetas[2];
+static AccountMeta bobMetas[2];
+static AccountMeta tokenMetas[3];
+static AccountMeta createMetas[2];
+static uint8_t aliceData[12];
+static uint8_t bobData[12];
+static uint8_t tokenData[9];
+static uint8_t createData[52];
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printRate(const char* label, uint32_t elapsedUs, uint32_t iterations) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / iterations, 2);
+    Serial.println(" us/tx");
+}
+
+void setMeta(AccountMeta& meta, const uint8_t* pubkey, bool isSigner, bool isWritable) {
+    memcpy(meta.pubkey, pubkey, SOLDUINO_PUBKEY_SIZE);
+    meta.isSigner = isSigner;
+    meta.isWritable = isWritable;
+}
+
+// Same layouts as SystemProgram::transfer() and friends
+void encodeParts() {
+    setMeta(aliceMetas[0], payer, true, true);
+    setMeta(aliceMetas[1], alice, false, true);
+    setMeta(bobMetas[0], payer, true, true);
+    setMeta(bobMetas[1], bob, false, true);
+    setMeta(tokenMetas[0], source, false, true);
+    setMeta(tokenMetas[1], dest, false, true);
+    setMeta(tokenMetas[2], payer, true, false);
+    setMeta(createMetas[0], payer, true, true);
+    setMeta(createMetas[1], newAccount, true, true);
+
+    BasicInstruction<3, 52> ix;
+    SystemProgram::Transfer::encode(ix, payer, alice, (uint64_t)1000);
+    memcpy(aliceData, ix.getData(), sizeof(aliceData));
+    ix.reset();
+    SystemProgram::Transfer::encode(ix, payer, bob, (uint64_t)2000);
+    memcpy(bobData, ix.getData(), sizeof(bobData));
+    ix.reset();
+    TokenProgram::Transfer::encode(ix, source, dest, payer, (uint64_t)500);
+    memcpy(tokenData, ix.getData(), sizeof(tokenData));
+    ix.reset();
+    SystemProgram::CreateAccount::encode(ix, payer, newAccount, ACCOUNT_LAMPORTS, TOKEN_ACCOUNT_SPACE,
+                                         TokenProgram::PROGRAM_ID);
+    memcpy(createData, ix.getData(), sizeof(createData));
+}
+
+bool buildWithHelpers(TransactionBase& t) {
+    t.reset();
+    return t.add(SystemProgram::transfer(payer, alice, 1000)) &&
+           t.add(SystemProgram::transfer(payer, bob, 2000)) &&
+           t.add(TokenProgram::transfer(source, dest, payer, 500)) &&
+           t.add(SystemProgram::createAccount(payer, newAccount, ACCOUNT_LAMPORTS, TOKEN_ACCOUNT_SPACE,
+                                              TokenProgram::PROGRAM_ID)) &&
+           t.setRecentBlockhash(blockhash);
+}
+
+bool buildWithRefs(TransactionBase& t) {
+    InstructionRef aliceIx = { SystemProgram::PROGRAM_ID, aliceMetas, 2, aliceData, sizeof(aliceData) };
+    InstructionRef bobIx = { SystemProgram::PROGRAM_ID, bobMetas, 2, bobData, sizeof(bobData) };
+    InstructionRef tokenIx = { TokenProgram::PROGRAM_ID, tokenMetas, 3, tokenData, sizeof(tokenData) };
+    InstructionRef createIx = { SystemProgram::PROGRAM_ID, createMetas, 2, createData, sizeof(createData) };
+
+    t.reset();
+    return t.add(aliceIx) && t.add(bobIx) && t.add(tokenIx) && t.add(createIx) &&
+           t.setRecentBlockhash(blockhash);
+}
+
+bool buildWithEmplace(TransactionBase& t) {
+    t.reset();
+    return t.emplace<SystemProgram::Transfer>(payer, alice, (uint64_t)1000) &&
+           t.emplace<SystemProgram::Transfer>(payer, bob, (uint64_t)2000) &&
+           t.emplace<TokenProgram::Transfer>(source, dest, payer, (uint64_t)500) &&
+           t.emplace<SystemProgram::CreateAccount>(payer, newAccount, ACCOUNT_LAMPORTS, TOKEN_ACCOUNT_SPACE,
+                                                   TokenProgram::PROGRAM_ID) &&
+           t.setRecentBlockhash(blockhash);
+}
+
+bool sameMessage(const TransactionBase& a, const TransactionBase& b) {
+    uint16_t lengthA;
+    uint16_t lengthB;
+    const uint8_t* bytesA = a.getMessage().serialize(lengthA);
+    const uint8_t* bytesB = b.getMessage().serialize(lengthB);
+    return bytesA && bytesB && lengthA == lengthB && memcmp(bytesA, bytesB, lengthA) == 0;
+}
+
+void bench(const char* label, bool (*build)(TransactionBase&)) {
+    bool ok = true;
+    uint32_t start = micros();
+    for (uint32_t it = 0; it < ITERATIONS; it++) {
+        ok &= build(tx);
+    }
+    printRate(label, micros() - start, ITERATIONS);
+
+    if (!ok) {
+        Serial.println("  [ERROR] could not build transaction");
+    } else if (!sameMessage(tx, reference)) {
+        Serial.println("  [ERROR] message differs from the helper-built one");
+    }
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Instruction Building Benchmark ===");
+
+    memset(payer, 1, sizeof(payer));
+    memset(alice, 2, sizeof(alice));
+    memset(bob, 3, sizeof(bob));
+    memset(source, 4, sizeof(source));
+    memset(dest, 5, sizeof(dest));
+    memset(newAccount, 6, sizeof(newAccount));
+    memset(blockhash, 7, sizeof(blockhash));
+    encodeParts();
+
+    if (!buildWithHelpers(reference)) {
+        Serial.println("[ERROR] could not build the reference transaction");
+        return;
+    }
+
+    Serial.print("\nEach helper returns an Instruction of ");
+    Serial.print(sizeof(Instruction));
+    Serial.println(" bytes\n");
+    Serial.println("--- 4 instructions: 2 SOL transfers, token transfer, create account ---");
+
+    bench("helpers + add()", buildWithHelpers);
+    bench("InstructionRef  ", buildWithRefs);
+    bench("emplace()       ", buildWithEmplace);
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
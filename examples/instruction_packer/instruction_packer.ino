@@ -0,0 +1,157 @@
+/**
+ * Solduino Instruction Packer
+ *
+ * Queues READING_COUNT Memo instructions of varying length (stand-ins for
+ * buffered sensor readings) and packs them three ways:
+ *   - one transaction per reading, which is what sending each reading as
+ *     it arrives costs
+ *   - in order (next fit), which keeps readings in submission order
+ *   - pack() (first fit decreasing), which needs the fewest transactions
+ * For each it prints the transaction count and the average fill of the
+ * 1232-byte packet, then signs every packed transaction and checks that
+ * the serialized size matches the packer's exact accounting.
+ *
+ * Readings and transactions are declared at the capacity they need
+ * (one key and 48 data bytes per reading; the payer and the Memo program
+ * per transaction) rather than as Instruction and Transaction, whose
+ * default capacity would cost several times the RAM and stop at 8
+ * instructions per transaction before the packet fills up.
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const uint16_t READING_COUNT = 200;
+const uint8_t MAX_TRANSACTIONS = 32;
+const char* MEMO_PROGRAM_ID = "MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr";
+
+typedef BasicInstruction<1, 48> Reading;               // payer key, memo text
+typedef BasicTransaction<2, 48, 1232> ReadingBatch;    // payer and Memo program
+
+Solduino solduino;
+Keypair payer;
+static Reading readings[READING_COUNT];
+static ReadingBatch transactions[MAX_TRANSACTIONS];
+static uint8_t wire[SOLDUINO_MAX_TRANSACTION_SIZE];
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+bool queueReadings() {
+    uint8_t memoProgram[SOLDUINO_PUBKEY_SIZE];
+    uint8_t payerPub[SOLDUINO_PUBKEY_SIZE];
+    if (!addressToPublicKey(MEMO_PROGRAM_ID, memoProgram) || !payer.getPublicKey(payerPub)) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < READING_COUNT; i++) {
+        char memo[64];
+        int len = snprintf(memo, sizeof(memo), "t=%u temp=%d.%02u", i, 20 + (i % 7), (i * 37) % 100);
+        if (i % 5 == 0) {
+            len += snprintf(memo + len, sizeof(memo) - len, " note=calibrated");
+        }
+
+        Reading& ix = readings[i];
+        ix.reset();
+        ix.setProgram(memoProgram);
+        ix.addKey(payerPub, true, true);
+        ix.writeBytes((const uint8_t*)memo, len);
+    }
+    return true;
+}
+
+void report(const char* label, InstructionPacker& packer, bool ok) {
+    uint32_t bytes = 0;
+    for (uint8_t t = 0; t < packer.getTransactionCount(); t++) {
+        bytes += packer.getTransactionSize(t);
+    }
+
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    if (!ok) {
+        Serial.println("[ERROR] ran out of transactions");
+        return;
+    }
+    Serial.print(packer.getTransactionCount());
+    Serial.print(" tx, ");
+    Serial.print(100.0f * bytes / (packer.getTransactionCount() * SOLDUINO_MAX_TRANSACTION_SIZE), 1);
+    Serial.println("% packet fill");
+}
+
+bool signAndCheck(InstructionPacker& packer) {
+    for (uint8_t t = 0; t < packer.getTransactionCount(); t++) {
+        uint16_t len = 0;
+        if (!transactions[t].sign(payer) ||
+            !TransactionSerializer::serializeTransaction(transactions[t], wire, sizeof(wire), len) ||
+            len != packer.getTransactionSize(t)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Instruction Packer ===");
+
+    if (!solduino.begin() || !payer.generate() || !queueReadings()) {
+        Serial.println("[ERROR] Setup failed");
+        return;
+    }
+
+    uint8_t payerPub[SOLDUINO_PUBKEY_SIZE];
+    uint8_t blockhash[BLOCKHASH_SIZE];
+    payer.getPublicKey(payerPub);
+    memset(blockhash, 0x42, sizeof(blockhash));   // fetch a real one before sending
+
+    Serial.print("\n--- ");
+    Serial.print(READING_COUNT);
+    Serial.println(" readings ---");
+    Serial.print("  one per transaction: ");
+    Serial.print(READING_COUNT);
+    Serial.println(" tx");
+
+    InstructionPacker packer;
+    packer.begin(payerPub, transactions, MAX_TRANSACTIONS);
+    packer.setRecentBlockhash(blockhash);
+    packer.setInOrder(true);
+    bool ok = true;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < READING_COUNT && ok; i++) {
+        ok = packer.add(readings[i]);
+    }
+    uint32_t elapsedUs = micros() - start;
+    report("in order           ", packer, ok);
+
+    packer.begin(payerPub, transactions, MAX_TRANSACTIONS);
+    packer.setRecentBlockhash(blockhash);
+    start = micros();
+    ok = packer.pack(readings, READING_COUNT);
+    uint32_t packUs = micros() - start;
+    report("pack()             ", packer, ok);
+
+    Serial.print("  packing time: ");
+    Serial.print(elapsedUs);
+    Serial.print(" us in order, ");
+    Serial.print(packUs);
+    Serial.println(" us pack()");
+
+    Serial.println(ok && signAndCheck(packer) ? "  sizes verified after signing"
+                                              : "  [ERROR] signed size differs from packer accounting");
+}
+
+void loop() {
+    delay(10000);
+}
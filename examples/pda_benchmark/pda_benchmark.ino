@@ -0,0 +1,210 @@
+/**
+ * Solduino PDA Benchmark
+ *
+ * Runs testProgramAddress() (known PDAs from the Solana docs plus on-curve
+ * edge cases), then measures:
+ *   - isOnCurve() versus libsodium's crypto_core_ed25519_is_valid_point()
+ *     on random 32-byte hashes (one bump attempt each)
+ *   - findProgramAddress() end to end for a typical ATA-style seed set
+ *   - the SHA-256 part of a 256-bump sweep over 16 seeds, re-hashing every
+ *     seed per bump, reusing the seed midstate, and finishing
+ *     SOLDUINO_SHA256_LANES bumps per pass as findProgramAddress does
+ *   - a batch of ATA-style PDAs: a findProgramAddress() loop versus
+ *     findProgramAddresses() on one thread and on every core
+ *
+ * libsodium's check is shown for speed reference only: it also rejects
+ * small-order and non-subgroup points, so it is not what Solana uses.
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+#include <sodium.h>
+
+const uint32_t ITERATIONS = 2000;
+const uint32_t FIND_ITERATIONS = 200;
+const size_t BATCH_SIZE = 256;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printRate(const char* label, uint32_t elapsedUs, uint32_t iterations) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / iterations, 2);
+    Serial.print(" us/op  (");
+    Serial.print(elapsedUs > 0 ? (uint32_t)((uint64_t)iterations * 1000000ULL / elapsedUs) : 0);
+    Serial.println(" ops/s)");
+}
+
+void benchCurveCheck() {
+    static uint8_t points[64][32];
+    for (size_t i = 0; i < 64; i++) {
+        for (size_t j = 0; j < 32; j++) points[i][j] = (uint8_t)random(256);
+    }
+
+    Serial.println("\n--- Curve check (per bump attempt) ---");
+
+    volatile uint32_t hits = 0;
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < ITERATIONS; i++) hits += isOnCurve(points[i & 63]);
+    printRate("isOnCurve        ", micros() - start, ITERATIONS);
+
+    start = micros();
+    for (uint32_t i = 0; i < ITERATIONS; i++) hits += crypto_core_ed25519_is_valid_point(points[i & 63]);
+    printRate("sodium valid_pt  ", micros() - start, ITERATIONS);
+}
+
+void benchFind() {
+    const uint8_t* seeds[3] = {SystemProgram::PROGRAM_ID, TokenProgram::PROGRAM_ID, SystemProgram::PROGRAM_ID};
+    size_t seedLens[3] = {32, 32, 32};
+    uint8_t address[32];
+    uint8_t bump = 0;
+
+    Serial.println("\n--- findProgramAddress (3 x 32-byte seeds) ---");
+
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < FIND_ITERATIONS; i++) {
+        findProgramAddress(seeds, seedLens, 3, TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID, address, &bump);
+    }
+    printRate("findProgramAddress", micros() - start, FIND_ITERATIONS);
+    Serial.print("  bump: ");
+    Serial.println(bump);
+}
+
+void benchSweep() {
+    static uint8_t seedData[MAX_PDA_SEEDS][32];
+    uint8_t programId[32];
+    uint8_t hash[32];
+    for (size_t i = 0; i < MAX_PDA_SEEDS; i++) {
+        for (size_t j = 0; j < 32; j++) seedData[i][j] = (uint8_t)random(256);
+    }
+    memcpy(programId, SystemProgram::PROGRAM_ID, 32);
+
+    Serial.println("\n--- SHA-256 per bump, 16 x 32-byte seeds ---");
+
+    // What createProgramAddress did for every bump before midstate reuse
+    uint32_t start = micros();
+    for (int b = 255; b >= 0; b--) {
+        crypto_hash_sha256_state state;
+        crypto_hash_sha256_init(&state);
+        for (size_t i = 0; i < MAX_PDA_SEEDS; i++) crypto_hash_sha256_update(&state, seedData[i], 32);
+        uint8_t bump = (uint8_t)b;
+        crypto_hash_sha256_update(&state, &bump, 1);
+        crypto_hash_sha256_update(&state, programId, 32);
+        crypto_hash_sha256_update(&state, (const uint8_t*)"ProgramDerivedAddress", 21);
+        crypto_hash_sha256_final(&state, hash);
+    }
+    printRate("rehash seeds     ", micros() - start, 256);
+
+    // What findProgramAddress does now: seeds once, then copy + suffix
+    uint8_t suffix[54];
+    memcpy(suffix + 1, programId, 32);
+    memcpy(suffix + 33, "ProgramDerivedAddress", 21);
+    start = micros();
+    crypto_hash_sha256_state seedState;
+    crypto_hash_sha256_init(&seedState);
+    for (size_t i = 0; i < MAX_PDA_SEEDS; i++) crypto_hash_sha256_update(&seedState, seedData[i], 32);
+    for (int b = 255; b >= 0; b--) {
+        crypto_hash_sha256_state state = seedState;
+        suffix[0] = (uint8_t)b;
+        crypto_hash_sha256_update(&state, suffix, sizeof(suffix));
+        crypto_hash_sha256_final(&state, hash);
+    }
+    printRate("seed midstate    ", micros() - start, 256);
+
+    // What findProgramAddress does now: SOLDUINO_SHA256_LANES bumps per pass
+    uint8_t suffixes[SOLDUINO_SHA256_LANES][54];
+    const uint8_t* lanes[SOLDUINO_SHA256_LANES];
+    uint8_t hashes[SOLDUINO_SHA256_LANES][32];
+    for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+        memcpy(suffixes[l], suffix, sizeof(suffix));
+        lanes[l] = suffixes[l];
+    }
+    start = micros();
+    Sha256Midstate mid;
+    sha256MidstateInit(&mid);
+    for (size_t i = 0; i < MAX_PDA_SEEDS; i++) sha256MidstateUpdate(&mid, seedData[i], 32);
+    for (int top = 255; top >= 0; top -= SOLDUINO_SHA256_LANES) {
+        for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) suffixes[l][0] = (uint8_t)(top - l);
+        sha256FinishLanes(&mid, lanes, sizeof(suffix), hashes);
+    }
+    printRate("midstate + lanes ", micros() - start, 256);
+}
+
+void benchBatch() {
+    static uint8_t owners[BATCH_SIZE][32];
+    static const uint8_t* seeds[BATCH_SIZE][3];
+    static size_t seedLens[BATCH_SIZE][3];
+    static PdaRequest requests[BATCH_SIZE];
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        for (size_t j = 0; j < 32; j++) owners[i][j] = (uint8_t)random(256);
+        seeds[i][0] = owners[i];
+        seeds[i][1] = TokenProgram::PROGRAM_ID;
+        seeds[i][2] = SystemProgram::PROGRAM_ID;
+        for (size_t k = 0; k < 3; k++) seedLens[i][k] = 32;
+        requests[i].seeds = seeds[i];
+        requests[i].seedLens = seedLens[i];
+        requests[i].seedCount = 3;
+        requests[i].programId = TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID;
+    }
+
+    Serial.print("\n--- Batch of ");
+    Serial.print(BATCH_SIZE);
+    Serial.println(" ATA-style PDAs ---");
+
+    uint8_t address[32];
+    uint8_t bump;
+    uint32_t start = micros();
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        findProgramAddress(seeds[i], seedLens[i], 3, requests[i].programId, address, &bump);
+    }
+    printRate("findProgramAddress loop", micros() - start, BATCH_SIZE);
+
+    start = micros();
+    findProgramAddresses(requests, BATCH_SIZE, 1);
+    printRate("findProgramAddresses x1", micros() - start, BATCH_SIZE);
+
+    start = micros();
+    size_t found = findProgramAddresses(requests, BATCH_SIZE);
+    printRate("findProgramAddresses   ", micros() - start, BATCH_SIZE);
+    Serial.print("  found: ");
+    Serial.println((uint32_t)found);
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino PDA Benchmark ===");
+
+    if (sodium_init() < 0) {
+        Serial.println("[ERROR] libsodium init failed");
+        return;
+    }
+
+    if (!testProgramAddress()) {
+        Serial.println("[ERROR] Self-test failed, skipping benchmark");
+        return;
+    }
+
+    benchCurveCheck();
+    benchFind();
+    benchSweep();
+    benchBatch();
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
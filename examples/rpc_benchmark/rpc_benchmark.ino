@@ -0,0 +1,221 @@
+/**
+ * Solduino RPC Connection Benchmark
+ *
+ * Times a burst of getSlot requests three ways and prints how many
+ * connections each opened:
+ *   - keep-alive off: a new TCP (and, for https, TLS) handshake per request
+ *   - keep-alive on: one handshake, every later request reuses it
+ *   - pre-connect: connect(true) handshakes in the background while the
+ *     sketch "samples a sensor", so the request that follows only pays
+ *     for the round trip
+ *
+ * The boot sequence (getLatestBlockhash, getSlot, getBalance) is then
+ * timed as three requests and as one RpcBatch.
+ *
+ * For https endpoints it then times connect() cold (no cached TLS
+ * session, full handshake) against warm (TlsSessionCache attached, the
+ * server resumes the session), as after a deep-sleep wake.
+ *
+ * Point RPC_ENDPOINT at a local stand-in so network jitter stays out of
+ * the numbers. stand_in_server.py in this folder answers every JSON-RPC
+ * call with a canned result over HTTP/1.1 keep-alive:
+ *   python3 stand_in_server.py --port 8899
+ *   python3 stand_in_server.py --port 8443 --cert cert.pem --key key.pem
+ * (make a self-signed pair with
+ *   openssl req -x509 -newkey rsa:2048 -nodes -subj /CN=localhost \
+ *     -keyout key.pem -out cert.pem). solana-test-validator works too for
+ * http.
+ *
+ * Hardware: ESP32 (any variant)
+ *
+ * Required Libraries:
+ *   - ArduinoJson
+ *   - Solduino
+ */
+
+#include <WiFi.h>
+#include <solduino.h>
+
+const char* ssid = "YOUR_WIFI_SSID";
+const char* password = "YOUR_WIFI_PASSWORD";
+
+// Your computer's IP address; use https:// and port 8443 for the TLS run
+const String RPC_ENDPOINT = "http://192.168.1.100:8899";
+
+const uint32_t REQUESTS = 20;
+const uint32_t SAMPLE_MS = 500;     // stand-in for reading a sensor
+
+// Test account (Solana System Program - always exists)
+const String TEST_ACCOUNT = "11111111111111111111111111111111";
+
+RpcClient rpcClient(RPC_ENDPOINT);
+TlsSessionCache sessions;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printResult(const char* label, uint32_t elapsedMs, uint32_t requests) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedMs / requests, 1);
+    Serial.print(" ms/request, ");
+    Serial.print(rpcClient.getHandshakeCount());
+    Serial.print(" handshakes, ");
+    Serial.print(rpcClient.getReusedCount());
+    Serial.println(" reused");
+}
+
+void benchBurst(const char* label, bool keepAlive) {
+    rpcClient.end();
+    rpcClient.setKeepAlive(keepAlive);
+    rpcClient.resetConnectionStats();
+
+    uint32_t failures = 0;
+    uint32_t start = millis();
+    for (uint32_t i = 0; i < REQUESTS; i++) {
+        if (rpcClient.getSlot() == 0) failures++;
+    }
+    printResult(label, millis() - start, REQUESTS);
+    if (failures) {
+        Serial.print("  [ERROR] failed requests: ");
+        Serial.println(failures);
+    }
+}
+
+// Only the request itself is timed; the sampling delay overlaps the handshake
+void benchPreconnect(const char* label, bool background) {
+    rpcClient.setKeepAlive(true);
+    rpcClient.resetConnectionStats();
+
+    uint32_t requestMs = 0;
+    for (uint32_t i = 0; i < REQUESTS / 4; i++) {
+        rpcClient.end();
+        rpcClient.connect(background);
+        delay(SAMPLE_MS);
+
+        uint32_t start = millis();
+        rpcClient.getSlot();
+        requestMs += millis() - start;
+    }
+    printResult(label, requestMs, REQUESTS / 4);
+}
+
+// getLatestBlockhash + getSlot + getBalance, as separate requests or one batch
+void benchBootSequence(const char* label, bool batched) {
+    rpcClient.setKeepAlive(true);
+    rpcClient.resetConnectionStats();
+
+    String blockhash;
+    uint64_t slot = 0;
+    uint64_t lamports = 0;
+    uint32_t failures = 0;
+    uint32_t start = millis();
+    for (uint32_t i = 0; i < REQUESTS; i++) {
+        if (batched) {
+            RpcBatch batch;
+            batch.getLatestBlockhash(blockhash);
+            batch.getSlot(slot);
+            batch.getBalance(TEST_ACCOUNT, lamports);
+            if (!rpcClient.send(batch) || batch.getCompleted() != batch.size()) failures++;
+        } else {
+            blockhash = rpcClient.getLatestBlockhash();
+            slot = rpcClient.getSlot();
+            lamports = rpcClient.getBalanceLamports(TEST_ACCOUNT);
+            if (blockhash.length() == 0 || slot == 0) failures++;
+        }
+    }
+    printResult(label, millis() - start, REQUESTS);
+    if (failures) {
+        Serial.print("  [ERROR] failed sequences: ");
+        Serial.println(failures);
+    }
+}
+
+void printHandshakes(const char* label, uint32_t connects) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)rpcClient.getHandshakeTimeUs() / connects / 1000.0f, 1);
+    Serial.print(" ms/connect, ");
+    Serial.print(rpcClient.getResumedCount());
+    Serial.print(" of ");
+    Serial.print(connects);
+    Serial.println(" resumed");
+}
+
+// Each connect() starts from a closed connection, like a reconnect
+void benchHandshake(const char* label, bool resume) {
+    const uint32_t connects = REQUESTS / 4;
+    rpcClient.setSessionCache(resume ? &sessions : nullptr);
+    if (resume) {
+        // Prime the cache with one full handshake, as the boot before sleep would
+        rpcClient.end();
+        rpcClient.connect();
+    }
+    rpcClient.resetConnectionStats();
+
+    for (uint32_t i = 0; i < connects; i++) {
+        rpcClient.end();
+        if (!rpcClient.connect()) {
+            Serial.println("  [ERROR] connect failed");
+            return;
+        }
+    }
+    printHandshakes(label, connects);
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino RPC Connection Benchmark ===");
+
+    WiFi.begin(ssid, password);
+    while (WiFi.status() != WL_CONNECTED) {
+        delay(250);
+    }
+    Serial.print("Endpoint: ");
+    Serial.println(RPC_ENDPOINT);
+
+    if (!rpcClient.begin()) {
+        Serial.println("[ERROR] endpoint not reachable");
+        return;
+    }
+
+    Serial.println("\n--- burst of getSlot ---");
+    benchBurst("keep-alive off", false);
+    benchBurst("keep-alive on ", true);
+
+    Serial.println("\n--- connect, sample, getSlot ---");
+    benchPreconnect("connect()     ", false);
+    benchPreconnect("connect(true) ", true);
+
+    Serial.println("\n--- boot: blockhash + slot + balance ---");
+    benchBootSequence("3 requests    ", false);
+    benchBootSequence("1 RpcBatch    ", true);
+
+    if (RPC_ENDPOINT.startsWith("https://")) {
+        Serial.println("\n--- TLS connect after a disconnect ---");
+#if SOLDUINO_TLS_SESSIONS
+        benchHandshake("cold (full)   ", false);
+        benchHandshake("warm (resumed)", true);
+        Serial.print("  cached session: ");
+        Serial.print(sessions.savedSize());
+        Serial.println(" bytes to keep in RTC memory");
+#else
+        Serial.println("  TLS session resumption needs SOLDUINO_TLS_SESSIONS (ESP32)");
+#endif
+    }
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
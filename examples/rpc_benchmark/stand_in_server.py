@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Local JSON-RPC stand-in for rpc_benchmark.
+
+Answers every POST with a canned result over HTTP/1.1 keep-alive, so the
+benchmark measures connection handling rather than a validator. Pass
+--cert/--key to serve HTTPS.
+"""
+
+import argparse
+import json
+import ssl
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+RESULTS = {
+    "getHealth": "ok",
+    "getSlot": 123456789,
+    "getBlockHeight": 123450000,
+    "getBalance": {"context": {"slot": 123456789}, "value": 1000000000},
+    "getLatestBlockhash": {
+        "context": {"slot": 123456789},
+        "value": {
+            "blockhash": "EkSnNWid2cvwEVnVx9aBqawnmiCNiDgp3gUdkDPTKN1N",
+            "lastValidBlockHeight": 123450150,
+        },
+    },
+}
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def do_POST(self):
+        request = json.loads(self.rfile.read(int(self.headers["Content-Length"])))
+        calls = request if isinstance(request, list) else [request]
+        replies = [
+            {"jsonrpc": "2.0", "id": call.get("id"), "result": RESULTS.get(call.get("method"), 0)}
+            for call in calls
+        ]
+        body = json.dumps(replies if isinstance(request, list) else replies[0]).encode()
+
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--port", type=int, default=8899)
+    parser.add_argument("--cert")
+    parser.add_argument("--key")
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), Handler)
+    if args.cert:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(args.cert, args.key)
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+    print("listening on", args.port, "(https)" if args.cert else "(http)")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,321 @@
+/**
+ * Solduino RPC Response Parsing Benchmark
+ *
+ * Feeds multi-megabyte responses through the Stream parsers RpcClient
+ * uses on the connection, and prints throughput and the parser's working
+ * memory, which does not grow with the response:
+ *   - getProgramAccounts (base64 data, ~1 KB per account)
+ *   - getTokenAccountsByOwner (jsonParsed, mostly fields that are dropped)
+ *   - getBlock (full transactions, which are only counted)
+ *
+ * The responses are generated on the fly, so no RAM holds them. Every
+ * run checks the parsed count and the last item against what was
+ * generated before printing a number.
+ *
+ * On a host build (Arduino core emulation, ARDUINO undefined) it also
+ * parses recorded responses listed in RECORDED, if the files exist.
+ * Record one with e.g.
+ *   curl -s https://api.mainnet-beta.solana.com -H 'Content-Type: application/json' \
+ *     -d '{"jsonrpc":"2.0","id":1,"method":"getBlock","params":[300000000,
+ *          {"encoding":"base64","maxSupportedTransactionVersion":0}]}' \
+ *     > recorded/getBlock.json
+ *
+ * Hardware: ESP32 (any variant) or a host build
+ *
+ * Required Libraries:
+ *   - ArduinoJson
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+#ifdef ARDUINO
+const size_t RESPONSE_BYTES = 256 * 1024;      // results still have to fit in RAM
+#else
+const size_t RESPONSE_BYTES = 8 * 1024 * 1024;
+#endif
+
+const size_t ACCOUNT_DATA = 1024;              // base64 characters per account
+const size_t TRANSACTION_DATA = 900;
+
+// ============================================================================
+// Generated responses
+// ============================================================================
+
+/**
+ * A JSON-RPC response produced piece by piece: head, count elements
+ * (comma-separated), tail. Only the current piece is in memory.
+ */
+class GeneratedResponse : public Stream {
+public:
+    typedef void (*ElementWriter)(size_t index, String& out);
+
+    GeneratedResponse(const char* head, const char* tail, size_t count, ElementWriter element)
+        : head(head), tail(tail), count(count), element(element), index(0), pos(0), total(0) {
+        setTimeout(10);
+    }
+
+    int available() override { return ensure() ? 1 : 0; }
+    int peek() override { return ensure() ? (uint8_t)piece[pos] : -1; }
+    int read() override {
+        if (!ensure()) return -1;
+        total++;
+        return (uint8_t)piece[pos++];
+    }
+    size_t write(uint8_t) override { return 0; }
+
+    size_t bytes() const { return total; }
+
+private:
+    const char* head;
+    const char* tail;
+    size_t count;
+    ElementWriter element;
+    size_t index;       // next piece: 0 = head, 1..count = elements, count + 1 = tail
+    size_t pos;
+    size_t total;
+    String piece;
+
+    bool ensure() {
+        while (pos >= piece.length()) {
+            if (index > count + 1) return false;
+            pos = 0;
+            if (index == 0) {
+                piece = head;
+            } else if (index <= count) {
+                piece = index > 1 ? "," : "";
+                element(index - 1, piece);
+            } else {
+                piece = tail;
+            }
+            index++;
+        }
+        return true;
+    }
+};
+
+// 44-character stand-in for an address, distinct per index
+void appendAddress(String& out, const char* prefix, size_t index) {
+    char text[45];
+    snprintf(text, sizeof(text), "%s%0*lu", prefix, (int)(44 - strlen(prefix)), (unsigned long)index);
+    out += text;
+}
+
+void appendFiller(String& out, size_t length) {
+    static const char pattern[] = "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA";
+    while (length > 0) {
+        size_t n = min(length, sizeof(pattern) - 1);
+        out.concat(pattern, n);
+        length -= n;
+    }
+}
+
+void programAccountElement(size_t index, String& out) {
+    out += "{\"account\":{\"data\":[\"";
+    appendFiller(out, ACCOUNT_DATA);
+    out += "\",\"base64\"],\"executable\":false,\"lamports\":";
+    out += String((unsigned long)(2039280 + index));
+    out += ",\"owner\":\"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA\","
+           "\"rentEpoch\":18446744073709551615,\"space\":165},\"pubkey\":\"";
+    appendAddress(out, "Acct", index);
+    out += "\"}";
+}
+
+void tokenAccountElement(size_t index, String& out) {
+    out += "{\"account\":{\"data\":{\"parsed\":{\"info\":{\"isNative\":false,"
+           "\"mint\":\"EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v\",\"owner\":\"";
+    appendAddress(out, "Ownr", 7);
+    out += "\",\"state\":\"initialized\",\"tokenAmount\":{\"amount\":\"";
+    out += String((unsigned long)index);
+    out += "\",\"decimals\":6,\"uiAmount\":0.000001,\"uiAmountString\":\"0.000001\"}},"
+           "\"type\":\"account\"},\"program\":\"spl-token\",\"space\":165},\"executable\":false,"
+           "\"lamports\":2039280,\"owner\":\"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA\","
+           "\"rentEpoch\":18446744073709551615,\"space\":165},\"pubkey\":\"";
+    appendAddress(out, "Tokn", index);
+    out += "\"}";
+}
+
+void transactionElement(size_t index, String& out) {
+    out += "{\"meta\":{\"computeUnitsConsumed\":150,\"err\":null,\"fee\":5000,\"innerInstructions\":[],"
+           "\"logMessages\":[\"Program 11111111111111111111111111111111 invoke [1]\","
+           "\"Program 11111111111111111111111111111111 success\"],\"postBalances\":[";
+    out += String((unsigned long)index);
+    out += ",1],\"preBalances\":[1,1],\"rewards\":[],\"status\":{\"Ok\":null}},\"transaction\":[\"";
+    appendFiller(out, TRANSACTION_DATA);
+    out += "\",\"base64\"],\"version\":0}";
+}
+
+const char RPC_TAIL_ARRAY[] = "],\"id\":1}";
+const char RPC_TAIL_VALUE[] = "]},\"id\":1}";
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printResult(const char* label, size_t bytes, uint32_t elapsedUs, size_t items, bool ok) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print(bytes / 1024);
+    Serial.print(" KB, ");
+    Serial.print(items);
+    Serial.print(" items, ");
+    Serial.print(elapsedUs / 1000);
+    Serial.print(" ms, ");
+    Serial.print(elapsedUs ? (float)bytes / elapsedUs : 0.0f, 2);
+    Serial.print(" MB/s");
+    Serial.println(ok ? "" : "  [FAIL]");
+}
+
+void benchProgramAccounts() {
+    size_t perItem = ACCOUNT_DATA + 240;
+    size_t count = RESPONSE_BYTES / perItem;
+    ProgramAccount* accounts = new ProgramAccount[count];
+
+    GeneratedResponse body("{\"jsonrpc\":\"2.0\",\"result\":[", RPC_TAIL_ARRAY, count, programAccountElement);
+    uint32_t start = micros();
+    size_t n = parseProgramAccounts(body, accounts, count);
+    uint32_t elapsed = micros() - start;
+
+    bool ok = n == count && accounts[n - 1].account.lamports == 2039280 + n - 1 &&
+              accounts[n - 1].account.data.length() == ACCOUNT_DATA;
+    printResult("getProgramAccounts     ", body.bytes(), elapsed, n, ok);
+    delete[] accounts;
+}
+
+void benchTokenAccounts() {
+    size_t perItem = 560;
+    size_t count = RESPONSE_BYTES / perItem;
+    TokenAccount* accounts = new TokenAccount[count];
+
+    GeneratedResponse body("{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"1.18.22\","
+                           "\"slot\":300000000},\"value\":[",
+                           RPC_TAIL_VALUE, count, tokenAccountElement);
+    uint32_t start = micros();
+    size_t n = parseTokenAccounts(body, accounts, count);
+    uint32_t elapsed = micros() - start;
+
+    bool ok = n == count && accounts[n - 1].amount == n - 1 && accounts[n - 1].decimals == 6 &&
+              accounts[n - 1].mint == "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v";
+    printResult("getTokenAccountsByOwner", body.bytes(), elapsed, n, ok);
+    delete[] accounts;
+}
+
+void benchBlock() {
+    size_t perItem = TRANSACTION_DATA + 330;
+    size_t count = RESPONSE_BYTES / perItem;
+
+    GeneratedResponse body("{\"jsonrpc\":\"2.0\",\"result\":{\"blockHeight\":280000000,\"blockTime\":1720000000,"
+                           "\"blockhash\":\"5eykt4UsFv8P8NJdTREpY1vzqKqZKvdpKuc147dw2N9d\",\"parentSlot\":299999999,"
+                           "\"previousBlockhash\":\"4sGjMW1sUnHzSxGspuhpqLDx6wiyjNtZAMdL4VZHirAn\",\"transactions\":[",
+                           RPC_TAIL_VALUE, count, transactionElement);
+    BlockInfo info;
+    uint32_t start = micros();
+    bool parsed = parseBlockInfo(body, info);
+    uint32_t elapsed = micros() - start;
+
+    bool ok = parsed && info.transactionCount == count && info.slot == 300000000;
+    printResult("getBlock               ", body.bytes(), elapsed, info.transactionCount, ok);
+}
+
+#ifndef ARDUINO
+
+// Recorded responses; missing files are skipped
+const char* const RECORDED[][2] = {
+    {"getProgramAccounts",      "recorded/getProgramAccounts.json"},
+    {"getTokenAccountsByOwner", "recorded/getTokenAccountsByOwner.json"},
+    {"getBlock",                "recorded/getBlock.json"},
+};
+const size_t RECORDED_MAX_ITEMS = 100000;
+
+class FileStream : public Stream {
+public:
+    explicit FileStream(FILE* file) : file(file), total(0) { setTimeout(0); }
+
+    int available() override { return peek() >= 0 ? 1 : 0; }
+    int peek() override {
+        int c = getc(file);
+        if (c != EOF) ungetc(c, file);
+        return c == EOF ? -1 : c;
+    }
+    int read() override {
+        int c = getc(file);
+        if (c == EOF) return -1;
+        total++;
+        return c;
+    }
+    size_t write(uint8_t) override { return 0; }
+
+    size_t bytes() const { return total; }
+
+private:
+    FILE* file;
+    size_t total;
+};
+
+void benchRecorded() {
+    for (size_t i = 0; i < sizeof(RECORDED) / sizeof(RECORDED[0]); i++) {
+        const char* method = RECORDED[i][0];
+        FILE* file = fopen(RECORDED[i][1], "rb");
+        if (!file) continue;
+
+        FileStream body(file);
+        size_t n = 0;
+        uint32_t start = micros();
+        if (strcmp(method, "getProgramAccounts") == 0) {
+            ProgramAccount* accounts = new ProgramAccount[RECORDED_MAX_ITEMS];
+            n = parseProgramAccounts(body, accounts, RECORDED_MAX_ITEMS);
+            delete[] accounts;
+        } else if (strcmp(method, "getTokenAccountsByOwner") == 0) {
+            TokenAccount* accounts = new TokenAccount[RECORDED_MAX_ITEMS];
+            n = parseTokenAccounts(body, accounts, RECORDED_MAX_ITEMS);
+            delete[] accounts;
+        } else {
+            BlockInfo info;
+            if (parseBlockInfo(body, info)) n = info.transactionCount;
+        }
+        uint32_t elapsed = micros() - start;
+        fclose(file);
+
+        Serial.print("  ");
+        Serial.print(RECORDED[i][1]);
+        Serial.println(":");
+        printResult(method, body.bytes(), elapsed, n, n > 0);
+    }
+}
+
+#endif
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino RPC Response Parsing Benchmark ===");
+    Serial.print("Parser documents: ");
+    Serial.print(SOLDUINO_RPC_ACCOUNT_DOC_SIZE);
+    Serial.print(" B per account, ");
+    Serial.print(SOLDUINO_RPC_ITEM_DOC_SIZE);
+    Serial.print(" B per token account, ");
+    Serial.print(SOLDUINO_RPC_TRANSACTION_DOC_SIZE);
+    Serial.println(" B per transaction, whatever the response size");
+
+    Serial.println("\n--- generated responses ---");
+    benchProgramAccounts();
+    benchTokenAccounts();
+    benchBlock();
+
+#ifndef ARDUINO
+    Serial.println("\n--- recorded responses ---");
+    benchRecorded();
+#endif
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
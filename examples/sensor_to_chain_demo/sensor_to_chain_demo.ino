@@ -87,6 +87,7 @@ uint8_t authorityPub[SOLDUINO_PUBKEY_SIZE];
 uint8_t programId[SOLDUINO_PUBKEY_SIZE];
 uint8_t dataAccountPda[SOLDUINO_PUBKEY_SIZE];
 uint8_t pdaBump;
+PdaCache pdaCache;   // persisted in NVS so reboots skip the bump search
 
 static char g_txBuf[2048];
 
@@ -138,7 +139,8 @@ bool pushSensorData(int64_t sensorValue) {
     int64_t timestamp = (int64_t)(millis() / 1000);
 
     // Build the instruction
-    Instruction ix;
+    // Sized for this record: three keys and 24 data bytes
+    BasicInstruction<3, 24> ix;
     ix.setProgram(programId);
     ix.addKey(authorityPub, true, true);                 // authority (signer, writable)
     ix.addKey(dataAccountPda, false, true);               // data PDA (writable)
@@ -154,7 +156,8 @@ bool pushSensorData(int64_t sensorValue) {
     Serial.println(" bytes");
 
     // Build transaction
-    Transaction tx;
+    // Those keys plus the program ID, one instruction
+    BasicTransaction<4, 1, 24> tx;
     tx.add(ix);
 
     // Get blockhash
@@ -266,10 +269,12 @@ void setup() {
     const uint8_t* seeds[] = { seed1, authorityPub };
     const size_t seedLens[] = { 6, SOLDUINO_PUBKEY_SIZE };
 
-    if (!findProgramAddress(seeds, seedLens, 2, programId, dataAccountPda, &pdaBump)) {
+    pdaCache.load("solduino");
+    if (!pdaCache.findProgramAddress(seeds, seedLens, 2, programId, dataAccountPda, &pdaBump)) {
         Serial.println("[FATAL] PDA derivation failed -- halting.");
         while (true) delay(1000);
     }
+    pdaCache.save("solduino");
 
     char pdaAddr[64];
     publicKeyToAddress(dataAccountPda, pdaAddr, sizeof(pdaAddr));
@@ -0,0 +1,161 @@
+/**
+ * Solduino Multi-Signer Benchmark
+ *
+ * Signs and Base64-encodes Memo transactions carrying 1, 2, 4 and 8
+ * signers, comparing:
+ *   - per-signer serialization: the message is invalidated before every
+ *     signature and before encoding, which is what partialSignRaw() did
+ *     before Message cached its wire form (N + 1 serializations)
+ *   - cached: a fresh blockhash, then sign(signers, n, 1) and
+ *     encodeTransaction() sharing one serialization
+ *   - parallel: the same with sign(signers, n), which spreads the
+ *     signatures over both cores (SOLDUINO_SIGN_THREADS); its output is
+ *     checked against the sequential signatures
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const uint8_t MAX_SIGNERS = 8;
+const uint8_t SIGNER_COUNTS[] = {1, 2, 4, 8};
+const uint32_t ITERATIONS = 20;
+const char* MEMO_PROGRAM_ID = "MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr";
+
+static Keypair keypairs[MAX_SIGNERS];
+static const Keypair* signers[MAX_SIGNERS];
+static Transaction tx;
+static char encoded[2048];
+static uint8_t sequential[MAX_SIGNERS][SIGNATURE_SIZE];
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printRate(const char* label, uint32_t elapsedUs, uint32_t iterations) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / iterations, 1);
+    Serial.println(" us/tx");
+}
+
+bool buildMemo(uint8_t signerCount) {
+    uint8_t memoProgram[SOLDUINO_PUBKEY_SIZE];
+    if (!addressToPublicKey(MEMO_PROGRAM_ID, memoProgram)) {
+        return false;
+    }
+
+    Instruction ix;
+    ix.setProgram(memoProgram);
+    for (uint8_t i = 0; i < signerCount; i++) {
+        uint8_t pub[SOLDUINO_PUBKEY_SIZE];
+        keypairs[i].getPublicKey(pub);
+        ix.addKey(pub, true, i == 0);   // fee payer writable, co-signers readonly
+    }
+    ix.writeBytes((const uint8_t*)"solduino sign benchmark", 23);
+
+    tx.reset();
+    return tx.add(ix);
+}
+
+void benchSigners(uint8_t n) {
+    Serial.print("\n--- ");
+    Serial.print(n);
+    Serial.println(n == 1 ? " signer ---" : " signers ---");
+
+    if (!buildMemo(n)) {
+        Serial.println("  [ERROR] could not build transaction");
+        return;
+    }
+
+    uint8_t blockhash[BLOCKHASH_SIZE];
+    bool ok = true;
+
+    uint32_t start = micros();
+    for (uint32_t it = 0; it < ITERATIONS; it++) {
+        memset(blockhash, (uint8_t)it, sizeof(blockhash));
+        tx.setRecentBlockhash(blockhash);
+        tx.sign(*signers[0]);
+        for (uint8_t i = 1; i < n; i++) {
+            tx.setRecentBlockhash(blockhash);   // drop the cached bytes
+            ok &= tx.partialSign(*signers[i]);
+        }
+        tx.setRecentBlockhash(blockhash);
+        ok &= TransactionSerializer::encodeTransaction(tx, encoded, sizeof(encoded));
+    }
+    printRate("per-signer serialization", micros() - start, ITERATIONS);
+
+    start = micros();
+    for (uint32_t it = 0; it < ITERATIONS; it++) {
+        memset(blockhash, (uint8_t)it, sizeof(blockhash));
+        tx.setRecentBlockhash(blockhash);
+        ok &= tx.sign(signers, n, 1);
+        ok &= TransactionSerializer::encodeTransaction(tx, encoded, sizeof(encoded));
+    }
+    printRate("cached                  ", micros() - start, ITERATIONS);
+
+    for (uint8_t i = 0; i < n; i++) {
+        tx.getSignature(i, sequential[i]);
+    }
+
+    start = micros();
+    for (uint32_t it = 0; it < ITERATIONS; it++) {
+        memset(blockhash, (uint8_t)it, sizeof(blockhash));
+        tx.setRecentBlockhash(blockhash);
+        ok &= tx.sign(signers, n);
+        ok &= TransactionSerializer::encodeTransaction(tx, encoded, sizeof(encoded));
+    }
+    printRate("cached, parallel        ", micros() - start, ITERATIONS);
+
+    for (uint8_t i = 0; i < n; i++) {
+        uint8_t signature[SIGNATURE_SIZE];
+        tx.getSignature(i, signature);
+        if (memcmp(signature, sequential[i], SIGNATURE_SIZE) != 0) {
+            Serial.println("  [ERROR] parallel signatures differ from sequential");
+            break;
+        }
+    }
+
+    if (!ok) {
+        Serial.println("  [ERROR] signing or encoding failed");
+    }
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Multi-Signer Benchmark ===");
+
+    Solduino solduino;
+    if (!solduino.begin()) {
+        Serial.println("[ERROR] Crypto backend init failed");
+        return;
+    }
+
+    for (uint8_t i = 0; i < MAX_SIGNERS; i++) {
+        if (!keypairs[i].generate()) {
+            Serial.println("[ERROR] Keypair generation failed");
+            return;
+        }
+        signers[i] = &keypairs[i];
+    }
+
+    for (size_t i = 0; i < sizeof(SIGNER_COUNTS); i++) {
+        benchSigners(SIGNER_COUNTS[i]);
+    }
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
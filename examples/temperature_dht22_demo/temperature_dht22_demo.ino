@@ -58,6 +58,8 @@ uint8_t pdaBump;
 
 DHT dht(DHT_PIN, DHTTYPE);
 
+TransactionTemplate recordTemplate;
+
 static char g_txBuf[2048];
 
 // ============================================================================
@@ -92,27 +94,42 @@ bool readDhtValues(int64_t& tempX100, int64_t& humidityX100) {
 // Transaction Push
 // ============================================================================
 
-bool pushSensorData(int64_t tempX100, int64_t humidityX100) {
-    int64_t timestamp = (int64_t)(millis() / 1000);
-
-    Instruction ix;
+// The accounts, program and data layout never change between readings, so
+// the transaction is serialized once here and only the blockhash and the
+// i64 fields are patched before each send.
+bool buildRecordTemplate() {
+    // Sized for this record: three keys and 32 data bytes
+    BasicInstruction<3, 32> ix;
     ix.setProgram(programId);
     ix.addKey(authorityPub, true, true);
     ix.addKey(dataAccountPda, false, true);
     ix.addKey(SystemProgram::PROGRAM_ID, false, false);
     ix.writeBytes(RECORD_DATA_DISCRIMINATOR, 8);
-    ix.writeI64LE(tempX100);
-    ix.writeI64LE(humidityX100);
-    ix.writeI64LE(timestamp);
+    ix.writeI64LE(0);   // tempX100
+    ix.writeI64LE(0);   // humidityX100
+    ix.writeI64LE(0);   // timestamp
+
+    // Those keys plus the program ID, one instruction
+    BasicTransaction<4, 1, 32> tx;
+    if (!tx.add(ix)) return false;
+    if (!recordTemplate.compile(tx)) return false;
+    if (recordTemplate.addField("tempX100", 0, 8, 8) < 0) return false;
+    if (recordTemplate.addField("humidityX100", 0, 16, 8) < 0) return false;
+    if (recordTemplate.addField("timestamp", 0, 24, 8) < 0) return false;
+    return true;
+}
 
-    Transaction tx;
-    tx.add(ix);
+bool pushSensorData(int64_t tempX100, int64_t humidityX100) {
+    int64_t timestamp = (int64_t)(millis() / 1000);
 
     uint8_t blockhash[BLOCKHASH_SIZE];
     if (!rpcClient.getLatestBlockhashBytes(blockhash)) return false;
-    if (!tx.setRecentBlockhash(blockhash)) return false;
-    if (!tx.sign(authorityKeypair)) return false;
-    if (!TransactionSerializer::encodeTransactionBase58(tx, g_txBuf, sizeof(g_txBuf))) return false;
+    if (!recordTemplate.setBlockhash(blockhash)) return false;
+    if (!recordTemplate.setI64("tempX100", tempX100)) return false;
+    if (!recordTemplate.setI64("humidityX100", humidityX100)) return false;
+    if (!recordTemplate.setI64("timestamp", timestamp)) return false;
+    if (!recordTemplate.sign(authorityKeypair)) return false;
+    if (!recordTemplate.encode(g_txBuf, sizeof(g_txBuf), TX_ENCODING_BASE58)) return false;
 
     String sig = rpcClient.sendTransactionBase58(g_txBuf);
     if (sig.length() == 0) {
@@ -185,6 +202,11 @@ void setup() {
         while (true) delay(1000);
     }
 
+    if (!buildRecordTemplate()) {
+        Serial.println("[FATAL] Transaction template build failed -- halting.");
+        while (true) delay(1000);
+    }
+
     dht.begin();
 
     Serial.println("Setup complete.\n");
@@ -69,6 +69,8 @@ uint8_t programId[SOLDUINO_PUBKEY_SIZE];
 uint8_t dataAccountPda[SOLDUINO_PUBKEY_SIZE];
 uint8_t pdaBump;
 
+TransactionTemplate recordTemplate;
+
 static char g_txBuf[2048];
 
 // ============================================================================
@@ -107,26 +109,39 @@ int64_t readThermistorTempX100() {
 // Transaction Push
 // ============================================================================
 
-bool pushSensorData(int64_t sensorValue) {
-    int64_t timestamp = (int64_t)(millis() / 1000);
-
-    Instruction ix;
+// The accounts, program and data layout never change between readings, so
+// the transaction is serialized once here and only the blockhash and the
+// i64 fields are patched before each send.
+bool buildRecordTemplate() {
+    // Sized for this record: three keys and 24 data bytes
+    BasicInstruction<3, 24> ix;
     ix.setProgram(programId);
     ix.addKey(authorityPub, true, true);
     ix.addKey(dataAccountPda, false, true);
     ix.addKey(SystemProgram::PROGRAM_ID, false, false);
     ix.writeBytes(RECORD_DATA_DISCRIMINATOR, 8);
-    ix.writeI64LE(sensorValue);
-    ix.writeI64LE(timestamp);
+    ix.writeI64LE(0);   // sensorValue
+    ix.writeI64LE(0);   // timestamp
+
+    // Those keys plus the program ID, one instruction
+    BasicTransaction<4, 1, 24> tx;
+    if (!tx.add(ix)) return false;
+    if (!recordTemplate.compile(tx)) return false;
+    if (recordTemplate.addField("sensorValue", 0, 8, 8) < 0) return false;
+    if (recordTemplate.addField("timestamp", 0, 16, 8) < 0) return false;
+    return true;
+}
 
-    Transaction tx;
-    tx.add(ix);
+bool pushSensorData(int64_t sensorValue) {
+    int64_t timestamp = (int64_t)(millis() / 1000);
 
     uint8_t blockhash[BLOCKHASH_SIZE];
     if (!rpcClient.getLatestBlockhashBytes(blockhash)) return false;
-    if (!tx.setRecentBlockhash(blockhash)) return false;
-    if (!tx.sign(authorityKeypair)) return false;
-    if (!TransactionSerializer::encodeTransactionBase58(tx, g_txBuf, sizeof(g_txBuf))) return false;
+    if (!recordTemplate.setBlockhash(blockhash)) return false;
+    if (!recordTemplate.setI64("sensorValue", sensorValue)) return false;
+    if (!recordTemplate.setI64("timestamp", timestamp)) return false;
+    if (!recordTemplate.sign(authorityKeypair)) return false;
+    if (!recordTemplate.encode(g_txBuf, sizeof(g_txBuf), TX_ENCODING_BASE58)) return false;
 
     String sig = rpcClient.sendTransactionBase58(g_txBuf);
     if (sig.length() == 0) {
@@ -199,6 +214,11 @@ void setup() {
         while (true) delay(1000);
     }
 
+    if (!buildRecordTemplate()) {
+        Serial.println("[FATAL] Transaction template build failed -- halting.");
+        while (true) delay(1000);
+    }
+
     analogReadResolution(12);
     pinMode(SENSOR_PIN, INPUT);
 
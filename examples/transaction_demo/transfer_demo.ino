@@ -245,7 +245,8 @@ void demonstrateTransfer() {
      
      // Create transaction first
      Serial.println("\n5. Creating transaction...");
-     static Transaction transaction;
+     // Payer, recipient and System Program; a transfer carries 12 data bytes
+     static BasicTransaction<3, 1, 12> transaction;
 
      if (!transaction.addTransferInstruction(senderPubkey, receiverPubkey, TRANSFER_AMOUNT)) {
          Serial.println("   ✗ Failed to create transaction");
@@ -0,0 +1,133 @@
+/**
+ * Solduino Vanity Address Grinder
+ *
+ * Runs testVanity(), compares the old approach (Keypair::generate() plus a
+ * full Base58 encode per candidate) with VanityGrinder::matches(), then
+ * grinds a keypair whose address starts with VANITY_PREFIX on every core,
+ * printing keys/s once a second. Send any character over Serial to cancel.
+ *
+ * Expected work is 58^n candidates for an n-character pattern (about
+ * 58^n / 2^k with ignoreCase and k letters), so keep patterns short on a
+ * microcontroller. The same code runs unchanged on hosted builds.
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const char* VANITY_PREFIX = "sol";
+const char* VANITY_SUFFIX = nullptr;
+const bool IGNORE_CASE = true;
+const uint32_t COMPARE_ITERATIONS = 200;
+
+Solduino solduino;
+VanityGrinder grinder;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+bool onProgress(uint64_t attempts, float keysPerSecond, void* context) {
+    (void)context;
+    Serial.print("  ");
+    Serial.print((uint32_t)attempts);
+    Serial.print(" keys, ");
+    Serial.print((uint32_t)keysPerSecond);
+    Serial.println(" keys/s");
+    // Any input cancels
+    return Serial.available() == 0;
+}
+
+void benchMatch() {
+    Serial.println("\n--- Candidate check ---");
+
+    Keypair keypair;
+    char address[64];
+    size_t prefixLen = strlen(VANITY_PREFIX);
+    uint32_t start = micros();
+    for (uint32_t i = 0; i < COMPARE_ITERATIONS; i++) {
+        keypair.generate();
+        keypair.getPublicKeyAddress(address, sizeof(address));
+        volatile bool hit = strncasecmp(address, VANITY_PREFIX, prefixLen) == 0;
+        (void)hit;
+    }
+    uint32_t legacyUs = micros() - start;
+
+    uint8_t publicKey[32];
+    uint8_t privateKey[64];
+    start = micros();
+    for (uint32_t i = 0; i < COMPARE_ITERATIONS; i++) {
+        generateKeypair(publicKey, privateKey);
+        volatile bool hit = grinder.matches(publicKey);
+        (void)hit;
+    }
+    uint32_t grinderUs = micros() - start;
+
+    Serial.print("  generate + Base58 : ");
+    Serial.print((float)legacyUs / COMPARE_ITERATIONS, 1);
+    Serial.println(" us/key");
+    Serial.print("  generate + matches: ");
+    Serial.print((float)grinderUs / COMPARE_ITERATIONS, 1);
+    Serial.println(" us/key");
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Vanity Grinder ===");
+
+    if (!solduino.begin()) {
+        Serial.println("[ERROR] Crypto backend init failed");
+        return;
+    }
+
+    if (!testVanity()) {
+        Serial.println("[ERROR] Self-test failed");
+        return;
+    }
+
+    if (!grinder.setPattern(VANITY_PREFIX, VANITY_SUFFIX, IGNORE_CASE)) {
+        Serial.println("[ERROR] Pattern contains characters Base58 cannot produce");
+        return;
+    }
+
+    benchMatch();
+
+    Serial.println("\n--- Grinding ---");
+    grinder.setProgressCallback(onProgress, nullptr, 1000);
+
+    uint8_t publicKey[32];
+    uint8_t privateKey[64];
+    if (grinder.grind(publicKey, privateKey)) {
+        Keypair keypair;
+        char text[96];
+        keypair.importFromPrivateKey(privateKey);
+        keypair.getPublicKeyAddress(text, sizeof(text));
+        Serial.print("Found: ");
+        Serial.println(text);
+        keypair.getPrivateKeyBase58(text, sizeof(text));
+        Serial.print("Private key: ");
+        Serial.println(text);
+        memset(text, 0, sizeof(text));
+    } else {
+        Serial.println("Cancelled");
+    }
+    memset(privateKey, 0, sizeof(privateKey));
+
+    Serial.print((uint32_t)grinder.getAttempts());
+    Serial.print(" keys at ");
+    Serial.print((uint32_t)grinder.getKeysPerSecond());
+    Serial.println(" keys/s");
+}
+
+void loop() {
+    delay(10000);
+}
@@ -0,0 +1,134 @@
+/**
+ * Solduino Signature Verification Benchmark
+ *
+ * Signs 256 random 32-byte readings with 256 keys, then measures
+ * verifySignature() one at a time against verifySignaturesBatch() at batch
+ * sizes 1, 16, 64 and 256. A corrupted signature is then slipped into the
+ * largest batch to show the per-signature fallback finding it.
+ *
+ * Batches are split into chunks of SOLDUINO_VERIFY_BATCH_MAX signatures
+ * (16 on Arduino targets), so sizes above that measure chunked throughput.
+ *
+ * Hardware: ESP32 (any variant) or any board with a Serial port and
+ * enough RAM for about 50 KB of workspace
+ *
+ * Required Libraries:
+ *   - Solduino
+ */
+
+#include <solduino.h>
+
+const size_t MAX_BATCH = 256;
+const size_t BATCH_SIZES[] = {1, 16, 64, 256};
+const size_t MESSAGE_LEN = 32;
+
+static uint8_t publicKeys[MAX_BATCH][32];
+static uint8_t signatures[MAX_BATCH][64];
+static uint8_t messages[MAX_BATCH][MESSAGE_LEN];
+static SignatureBatchEntry entries[MAX_BATCH];
+static bool results[MAX_BATCH];
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+void printRate(const char* label, uint32_t elapsedUs, uint32_t iterations) {
+    Serial.print("  ");
+    Serial.print(label);
+    Serial.print(": ");
+    Serial.print((float)elapsedUs / iterations, 2);
+    Serial.print(" us/sig  (");
+    Serial.print(elapsedUs > 0 ? (uint32_t)((uint64_t)iterations * 1000000ULL / elapsedUs) : 0);
+    Serial.println(" sig/s)");
+}
+
+bool prepareSignatures() {
+    uint8_t privateKey[64];
+    for (size_t i = 0; i < MAX_BATCH; i++) {
+        if (!generateKeypair(publicKeys[i], privateKey)) {
+            return false;
+        }
+        for (size_t j = 0; j < MESSAGE_LEN; j++) messages[i][j] = (uint8_t)random(256);
+        if (!signMessage(messages[i], MESSAGE_LEN, privateKey, signatures[i])) {
+            return false;
+        }
+        entries[i].message = messages[i];
+        entries[i].messageLen = MESSAGE_LEN;
+        entries[i].signature = signatures[i];
+        entries[i].publicKey = publicKeys[i];
+    }
+    memset(privateKey, 0, sizeof(privateKey));
+    return true;
+}
+
+void benchBatch(size_t n) {
+    Serial.print("\n--- Batch of ");
+    Serial.print((uint32_t)n);
+    Serial.println(" ---");
+
+    bool ok = true;
+    uint32_t start = micros();
+    for (size_t i = 0; i < n; i++) {
+        ok &= verifySignature(messages[i], MESSAGE_LEN, signatures[i], publicKeys[i]);
+    }
+    printRate("verifySignature      ", micros() - start, n);
+
+    start = micros();
+    ok &= verifySignaturesBatch(entries, n, nullptr);
+    printRate("verifySignaturesBatch", micros() - start, n);
+
+    if (!ok) {
+        Serial.println("  [ERROR] a valid signature was rejected");
+    }
+}
+
+void benchCorrupted() {
+    Serial.println("\n--- Batch of 256, signature 100 corrupted ---");
+
+    signatures[100][40] ^= 0x01;
+    uint32_t start = micros();
+    bool ok = verifySignaturesBatch(entries, MAX_BATCH, results);
+    printRate("verifySignaturesBatch", micros() - start, MAX_BATCH);
+    signatures[100][40] ^= 0x01;
+
+    Serial.print("  batch valid: ");
+    Serial.println(ok ? "yes" : "no");
+    for (size_t i = 0; i < MAX_BATCH; i++) {
+        if (!results[i]) {
+            Serial.print("  rejected: ");
+            Serial.println((uint32_t)i);
+        }
+    }
+}
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== Solduino Signature Verification Benchmark ===");
+
+    if (!cryptoBegin()) {
+        Serial.println("[ERROR] Crypto backend init failed");
+        return;
+    }
+
+    if (!prepareSignatures()) {
+        Serial.println("[ERROR] Could not generate test signatures");
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]); i++) {
+        benchBatch(BATCH_SIZES[i]);
+    }
+    benchCorrupted();
+
+    Serial.println("\n=== Benchmark Complete ===\n");
+}
+
+void loop() {
+    delay(10000);
+}
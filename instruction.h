@@ -10,16 +10,16 @@
 // ============================================================================
 // Provides instruction builder API for Solana programs:
 // - AccountMeta struct (pubkey + isSigner + isWritable)
-// - Instruction class with fluent data-encoding helpers
+// - BasicInstruction<MaxAccounts, MaxData> with fluent data-encoding helpers
 // - Borsh-compatible little-endian serialization
 // ============================================================================
 
-// Per-instruction account limit (override at compile time if needed)
+// Account and data capacity of the Instruction alias (override at compile
+// time if needed, or declare a BasicInstruction of the size required)
 #ifndef MAX_IX_ACCOUNTS
 #define MAX_IX_ACCOUNTS 10
 #endif
 
-// Per-instruction data limit (override at compile time if needed)
 #ifndef MAX_IX_DATA
 #define MAX_IX_DATA 256
 #endif
@@ -38,6 +38,35 @@ struct AccountMeta {
     bool isWritable;
 };
 
+/**
+ * Non-owning instruction: spans over a program ID, account metas and data
+ * the caller already holds. Transaction::add() reads them once, so nothing
+ * is copied into an Instruction first; they only need to stay valid for
+ * the duration of the call.
+ *
+ * Usage:
+ *   static const AccountMeta metas[] = { ... };
+ *   InstructionRef ref = { programId, metas, 2, payload, payloadLen };
+ *   tx.add(ref);
+ */
+struct InstructionRef {
+    const uint8_t* programId;         // 32 bytes
+    const AccountMeta* keys;
+    uint8_t keyCount;
+    const uint8_t* data;
+    uint16_t dataLength;
+};
+
+/**
+ * Storage of a BasicInstruction, constructed ahead of the InstructionBase
+ * that works in it
+ */
+template <uint8_t MaxAccounts, uint16_t MaxData>
+struct InstructionStorage {
+    AccountMeta keys[MaxAccounts];
+    uint8_t data[MaxData];
+};
+
 /**
  * Instruction Builder
  *
@@ -46,6 +75,11 @@ struct AccountMeta {
  *   - Ordered list of AccountMeta keys
  *   - Serialized instruction data
  *
+ * InstructionBase holds the logic and works in storage owned by a
+ * BasicInstruction<MaxAccounts, MaxData>, so every capacity shares one
+ * implementation and APIs take `const InstructionBase&`. `Instruction` is
+ * the BasicInstruction of MAX_IX_ACCOUNTS and MAX_IX_DATA.
+ *
  * Usage:
  *   Instruction ix;
  *   ix.setProgram(programId);
@@ -57,17 +91,34 @@ struct AccountMeta {
  *   Transaction tx;
  *   tx.add(ix);
  */
-class Instruction {
+class InstructionBase {
 private:
     uint8_t programId_[SOLDUINO_PUBKEY_SIZE];
-    AccountMeta keys_[MAX_IX_ACCOUNTS];
+    AccountMeta* keys_;
+    uint8_t maxKeys_;
     uint8_t keyCount_;
-    uint8_t data_[MAX_IX_DATA];
+    uint8_t* data_;
+    uint16_t maxData_;
     uint16_t dataLen_;
     bool hasProgram_;
 
+protected:
+    template <uint8_t MaxAccounts, uint16_t MaxData>
+    explicit InstructionBase(InstructionStorage<MaxAccounts, MaxData>& storage)
+        : keys_(storage.keys), maxKeys_(MaxAccounts), data_(storage.data), maxData_(MaxData) {
+        reset();
+    }
+
+    // Copies go through assign(), which keeps each object in its own storage
+    InstructionBase(const InstructionBase&) = delete;
+    InstructionBase& operator=(const InstructionBase&) = delete;
+
 public:
-    Instruction();
+    /**
+     * Copy another instruction's program, keys and data.
+     * @return false if they exceed this instruction's capacity (left reset)
+     */
+    bool assign(const InstructionBase& other);
 
     // ---- Program ID --------------------------------------------------------
 
@@ -198,7 +249,31 @@ public:
     uint16_t getDataLength() const { return dataLen_; }
 
     /** Get the remaining capacity in the data buffer. */
-    uint16_t getDataCapacity() const { return MAX_IX_DATA - dataLen_; }
+    uint16_t getDataCapacity() const { return maxData_ - dataLen_; }
+
+    /** Get the maximum number of account keys. */
+    uint8_t getKeyCapacity() const { return maxKeys_; }
+
+    /** View of this instruction's program, keys and data */
+    InstructionRef ref() const;
+};
+
+/**
+ * Instruction with room for MaxAccounts keys and MaxData bytes of data
+ */
+template <uint8_t MaxAccounts, uint16_t MaxData>
+class BasicInstruction : private InstructionStorage<MaxAccounts, MaxData>, public InstructionBase {
+    static_assert(MaxAccounts > 0 && MaxData > 0, "BasicInstruction needs room for a key and data");
+
+public:
+    BasicInstruction() : InstructionBase(static_cast<InstructionStorage<MaxAccounts, MaxData>&>(*this)) {}
+    BasicInstruction(const BasicInstruction& other) : BasicInstruction() { assign(other); }
+    BasicInstruction& operator=(const BasicInstruction& other) {
+        assign(other);
+        return *this;
+    }
 };
 
+typedef BasicInstruction<MAX_IX_ACCOUNTS, MAX_IX_DATA> Instruction;
+
 #endif // SOLDUINO_INSTRUCTION_H
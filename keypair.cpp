@@ -12,9 +12,21 @@ Keypair::~Keypair() {
 void Keypair::clearKeys() {
     memset(publicKey, 0, sizeof(publicKey));
     memset(privateKey, 0, sizeof(privateKey));
+    clearSigningKey(&signingKey);
     initialized = false;
 }
 
+bool Keypair::finishImport() {
+    // Derive the signing scalar and nonce prefix once per key
+    if (!expandSigningKey(privateKey, &signingKey)) {
+        clearKeys();
+        return false;
+    }
+    
+    initialized = true;
+    return true;
+}
+
 bool Keypair::generate() {
     clearKeys();
     
@@ -23,12 +35,13 @@ bool Keypair::generate() {
         return false;
     }
     
-    if (!generateKeypairFromSeed(seed, publicKey, privateKey)) {
+    bool ok = generateKeypairFromSeed(seed, publicKey, privateKey);
+    memset(seed, 0, sizeof(seed));
+    if (!ok) {
         return false;
     }
     
-    initialized = true;
-    return true;
+    return finishImport();
 }
 
 bool Keypair::importFromPrivateKey(const uint8_t* privateKeyBytes) {
@@ -45,8 +58,7 @@ bool Keypair::importFromPrivateKey(const uint8_t* privateKeyBytes) {
         return false;
     }
     
-    initialized = true;
-    return true;
+    return finishImport();
 }
 
 bool Keypair::importFromPrivateKeyBase58(const char* privateKeyBase58) {
@@ -75,8 +87,7 @@ bool Keypair::importFromSeed(const uint8_t* seed) {
         return false;
     }
     
-    initialized = true;
-    return true;
+    return finishImport();
 }
 
 bool Keypair::getPublicKey(uint8_t* output) const {
@@ -118,7 +129,7 @@ bool Keypair::sign(const uint8_t* message, size_t messageLen, uint8_t* signature
         return false;
     }
     
-    return signMessage(message, messageLen, privateKey, signature);
+    return signMessageExpanded(message, messageLen, &signingKey, signature);
 }
 
 bool Keypair::signString(const String& message, uint8_t* signature) const {
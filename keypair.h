@@ -25,9 +25,11 @@ class Keypair {
 private:
     uint8_t publicKey[SOLDUINO_PUBKEY_SIZE];
     uint8_t privateKey[SOLDUINO_SECRETKEY_SIZE];
+    Ed25519SigningKey signingKey;   // Expanded once so sign() skips SHA-512(seed)
     bool initialized;
     
     void clearKeys();
+    bool finishImport();
 
 public:
     /**
@@ -98,7 +100,8 @@ public:
     bool getPrivateKeyBase58(char* output, size_t outputLen) const;
     
     /**
-     * Sign a message with this keypair
+     * Sign a message with this keypair. Uses the expanded signing key
+     * computed at generate()/import*(), so no per-call key derivation.
      * @param message Message to sign
      * @param messageLen Length of message
      * @param signature Output signature (64 bytes)
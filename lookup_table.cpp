@@ -0,0 +1,98 @@
+#include "lookup_table.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ============================================================================
+// AddressLookupTable Implementation
+// ============================================================================
+
+// ProgramState::LookupTable discriminant (u32 LE) at the start of the meta
+static const uint32_t ALT_STATE_LOOKUP_TABLE = 1;
+
+AddressLookupTable::AddressLookupTable() {
+    memset(key, 0, sizeof(key));
+    addresses = nullptr;
+    count = 0;
+    deactivationSlot = UINT64_MAX;
+    loaded = false;
+}
+
+AddressLookupTable::~AddressLookupTable() {
+    clear();
+}
+
+void AddressLookupTable::clear() {
+    free(addresses);
+    addresses = nullptr;
+    count = 0;
+    deactivationSlot = UINT64_MAX;
+    loaded = false;
+}
+
+bool AddressLookupTable::set(const uint8_t* tableKey, const uint8_t addresses[][SOLDUINO_PUBKEY_SIZE], uint16_t count) {
+    if (!tableKey || (count > 0 && !addresses) || count > SOLDUINO_ALT_MAX_ADDRESSES) {
+        return false;
+    }
+    clear();
+
+    if (count > 0) {
+        this->addresses = (uint8_t (*)[SOLDUINO_PUBKEY_SIZE])malloc((size_t)count * SOLDUINO_PUBKEY_SIZE);
+        if (!this->addresses) {
+            return false;
+        }
+        memcpy(this->addresses, addresses, (size_t)count * SOLDUINO_PUBKEY_SIZE);
+    }
+    memcpy(key, tableKey, SOLDUINO_PUBKEY_SIZE);
+    this->count = count;
+    loaded = true;
+    return true;
+}
+
+bool AddressLookupTable::load(const uint8_t* tableKey, const uint8_t* accountData, size_t dataLen) {
+    if (!tableKey || !accountData || dataLen < SOLDUINO_ALT_META_SIZE) {
+        return false;
+    }
+
+    // LookupTableMeta: u32 state, u64 deactivation_slot, u64 last_extended_slot,
+    // u8 last_extended_slot_start_index, Option<Pubkey> authority, u16 padding
+    uint32_t state = 0;
+    for (int i = 0; i < 4; i++) {
+        state |= (uint32_t)accountData[i] << (i * 8);
+    }
+    size_t addressBytes = dataLen - SOLDUINO_ALT_META_SIZE;
+    if (state != ALT_STATE_LOOKUP_TABLE || addressBytes % SOLDUINO_PUBKEY_SIZE != 0 ||
+        addressBytes / SOLDUINO_PUBKEY_SIZE > SOLDUINO_ALT_MAX_ADDRESSES) {
+        return false;
+    }
+
+    uint64_t deactivation = 0;
+    for (int i = 0; i < 8; i++) {
+        deactivation |= (uint64_t)accountData[4 + i] << (i * 8);
+    }
+
+    if (!set(tableKey, (const uint8_t (*)[SOLDUINO_PUBKEY_SIZE])(accountData + SOLDUINO_ALT_META_SIZE),
+             (uint16_t)(addressBytes / SOLDUINO_PUBKEY_SIZE))) {
+        return false;
+    }
+    deactivationSlot = deactivation;
+    return true;
+}
+
+const uint8_t* AddressLookupTable::getAddress(uint16_t index) const {
+    if (index >= count) {
+        return nullptr;
+    }
+    return addresses[index];
+}
+
+int16_t AddressLookupTable::find(const uint8_t* pubkey) const {
+    if (!pubkey) return -1;
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (addresses[i][0] == pubkey[0] &&
+            memcmp(addresses[i], pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
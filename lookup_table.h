@@ -0,0 +1,99 @@
+#ifndef SOLDUINO_LOOKUP_TABLE_H
+#define SOLDUINO_LOOKUP_TABLE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "crypto.h"
+
+// ============================================================================
+// Solduino Address Lookup Table Module
+// ============================================================================
+// Client-side copy of an on-chain address lookup table (ALT):
+// - Parses the table account (56-byte meta, then 32-byte addresses)
+// - Finds the table index of an address for v0 message compilation
+// Fetch contents with RpcClient::getAddressLookupTable(), then attach the
+// table with Message::addLookupTable().
+// ============================================================================
+
+// Base58 ID of the Address Lookup Table program (owner of every table)
+#define SOLDUINO_ALT_PROGRAM_ID "AddressLookupTab1e1111111111111111111111111"
+
+// Serialized LookupTableMeta preceding the addresses
+#define SOLDUINO_ALT_META_SIZE 56
+
+// A table holds at most 256 addresses (message indexes are u8)
+#ifndef SOLDUINO_ALT_MAX_ADDRESSES
+#define SOLDUINO_ALT_MAX_ADDRESSES 256
+#endif
+
+/**
+ * Address lookup table contents.
+ *
+ * Addresses live in one heap block sized to the table. Tables are
+ * append-only on chain, so a loaded copy stays valid for every address it
+ * already holds; reload it only to pick up newly extended entries.
+ */
+class AddressLookupTable {
+public:
+    AddressLookupTable();
+    ~AddressLookupTable();
+
+    AddressLookupTable(const AddressLookupTable&) = delete;
+    AddressLookupTable& operator=(const AddressLookupTable&) = delete;
+
+    /**
+     * Load from the raw table account data.
+     * @param tableKey    Table account address (32 bytes)
+     * @param accountData Account data as stored on chain
+     * @param dataLen     Length of accountData
+     * @return false if the data is not a lookup table or memory ran out
+     */
+    bool load(const uint8_t* tableKey, const uint8_t* accountData, size_t dataLen);
+
+    /**
+     * Load from a known address list (e.g. a table created by this device).
+     * @param tableKey  Table account address (32 bytes)
+     * @param addresses Table entries in on-chain order
+     * @param count     Number of entries
+     * @return false if count exceeds SOLDUINO_ALT_MAX_ADDRESSES or memory ran out
+     */
+    bool set(const uint8_t* tableKey, const uint8_t addresses[][SOLDUINO_PUBKEY_SIZE], uint16_t count);
+
+    /**
+     * Release the addresses.
+     */
+    void clear();
+
+    bool isLoaded() const { return loaded; }
+
+    /**
+     * @return true unless the table has been deactivated on chain
+     */
+    bool isActive() const { return deactivationSlot == UINT64_MAX; }
+
+    /** @return Table account address (32 bytes) */
+    const uint8_t* getKey() const { return key; }
+
+    uint16_t getAddressCount() const { return count; }
+
+    /**
+     * @return Address at index (32 bytes), or nullptr if out of range
+     */
+    const uint8_t* getAddress(uint16_t index) const;
+
+    /**
+     * Find an address in the table.
+     * @param pubkey Public key (32 bytes)
+     * @return Table index, or -1 if absent
+     */
+    int16_t find(const uint8_t* pubkey) const;
+
+private:
+    uint8_t key[SOLDUINO_PUBKEY_SIZE];
+    uint8_t (*addresses)[SOLDUINO_PUBKEY_SIZE];
+    uint16_t count;
+    uint64_t deactivationSlot;
+    bool loaded;
+};
+
+#endif // SOLDUINO_LOOKUP_TABLE_H
@@ -0,0 +1,258 @@
+#include "packer.h"
+#include "serializer.h"
+#include <string.h>
+#include <stdlib.h>
+
+// ============================================================================
+// Size Helpers
+// ============================================================================
+
+// Rough standalone cost of an instruction, used only to order pack()
+static uint32_t instructionFootprint(const InstructionBase& instruction) {
+    uint32_t size = TransactionSerializer::instructionSize(instruction.getKeyCount(), instruction.getDataLength());
+    for (uint8_t i = 0; i < instruction.getKeyCount(); i++) {
+        size += SOLDUINO_PUBKEY_SIZE + (instruction.getKey(i)->isSigner ? SIGNATURE_SIZE : 0);
+    }
+    return size;
+}
+
+// ============================================================================
+// InstructionPacker Implementation
+// ============================================================================
+
+InstructionPacker::InstructionPacker() {
+    memset(feePayer, 0, sizeof(feePayer));
+    memset(recentBlockhash, 0, sizeof(recentBlockhash));
+    hasBlockhash = false;
+    memset(lookupTables, 0, sizeof(lookupTables));
+    lookupTableCount = 0;
+    limits.maxTransactionSize = SOLDUINO_MAX_TRANSACTION_SIZE;
+    limits.maxAccounts = SOLDUINO_MAX_ACCOUNT_LOCKS;
+    limits.maxInstructions = 255;                  // the transactions' capacity decides
+    limits.maxComputeUnits = SOLDUINO_MAX_COMPUTE_UNITS;
+    inOrder = false;
+    out = nullptr;
+    transactionAt = nullptr;
+    maxTransactions = 0;
+    used = 0;
+    memset(computeUsed, 0, sizeof(computeUsed));
+}
+
+bool InstructionPacker::begin(const uint8_t* feePayer, void* out, TransactionBase& (*at)(void*, uint16_t),
+                              uint8_t maxTransactions) {
+    if (!feePayer || !out || maxTransactions == 0) {
+        return false;
+    }
+    if (maxTransactions > SOLDUINO_PACKER_MAX_TRANSACTIONS) {
+        maxTransactions = SOLDUINO_PACKER_MAX_TRANSACTIONS;
+    }
+
+    memcpy(this->feePayer, feePayer, SOLDUINO_PUBKEY_SIZE);
+    this->out = out;
+    transactionAt = at;
+    this->maxTransactions = maxTransactions;
+    used = 0;
+    memset(computeUsed, 0, sizeof(computeUsed));
+    hasBlockhash = false;
+    lookupTableCount = 0;
+    return true;
+}
+
+bool InstructionPacker::addLookupTable(const AddressLookupTable* table) {
+    if (!table || lookupTableCount >= SOLDUINO_MAX_LOOKUP_TABLES) {
+        return false;
+    }
+    lookupTables[lookupTableCount++] = table;
+    return true;
+}
+
+void InstructionPacker::setRecentBlockhash(const uint8_t* blockhash) {
+    if (!blockhash) return;
+    memcpy(recentBlockhash, blockhash, BLOCKHASH_SIZE);
+    hasBlockhash = true;
+    for (uint8_t t = 0; t < used; t++) {
+        transaction(t).setRecentBlockhash(blockhash);
+    }
+}
+
+bool InstructionPacker::open(TransactionBase& transaction) {
+    transaction.reset();
+    // The fee payer goes in first so compile() keeps it at index 0
+    if (transaction.getMessage().addAccount(feePayer, true, true) < 0) {
+        return false;
+    }
+    for (uint8_t t = 0; t < lookupTableCount; t++) {
+        if (!transaction.getMessage().addLookupTable(lookupTables[t])) {
+            return false;
+        }
+    }
+    if (hasBlockhash) {
+        transaction.setRecentBlockhash(recentBlockhash);
+    }
+    return true;
+}
+
+bool InstructionPacker::measure(const MessageBase& message, const InstructionBase* instruction,
+                                uint16_t& size, uint8_t& accounts) {
+    // Keys and merged privileges as they would be after adding the
+    // instruction: the message's own keys, then the ones it introduces
+    const uint8_t* keys[SOLDUINO_ACCOUNT_LIMIT];
+    uint8_t flags[SOLDUINO_ACCOUNT_LIMIT];
+    uint8_t keyCount = message.accountCount;
+    for (uint8_t i = 0; i < keyCount; i++) {
+        keys[i] = message.accountKeys[i];
+        flags[i] = message.accountFlags[i];
+    }
+
+    uint32_t instructionBytes = 0;
+    uint8_t instructionCount = message.instructionCount;
+    for (uint8_t i = 0; i < instructionCount; i++) {
+        instructionBytes += TransactionSerializer::instructionSize(message.instructions[i].accountCount,
+                                                                   message.instructions[i].dataLength);
+    }
+
+    if (instruction) {
+        uint8_t metaCount = instruction->getKeyCount();
+        for (uint8_t m = 0; m <= metaCount; m++) {
+            const uint8_t* pubkey;
+            uint8_t keyFlags;
+            if (m < metaCount) {
+                const AccountMeta* meta = instruction->getKey(m);
+                pubkey = meta->pubkey;
+                keyFlags = (meta->isSigner ? MessageBase::KEY_SIGNER : 0) | (meta->isWritable ? MessageBase::KEY_WRITABLE : 0);
+            } else {
+                pubkey = instruction->getProgram();
+                keyFlags = MessageBase::KEY_INVOKED;
+            }
+
+            uint8_t k = message.lookupKey(pubkey);
+            if (k == 255) {
+                for (k = message.accountCount; k < keyCount; k++) {
+                    if (memcmp(keys[k], pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
+                        break;
+                    }
+                }
+                if (k == keyCount) {
+                    if (keyCount >= message.maxAccounts) {
+                        return false;
+                    }
+                    keys[keyCount] = pubkey;
+                    flags[keyCount++] = 0;
+                }
+            }
+            flags[k] |= keyFlags;
+        }
+        instructionBytes += TransactionSerializer::instructionSize(metaCount, instruction->getDataLength());
+        instructionCount++;
+    }
+
+    // Bucket each key the way compile() will, then size the message the
+    // way the serializer does
+    const uint8_t T = SOLDUINO_MAX_LOOKUP_TABLES;
+    uint8_t bucketCount[4 + 2 * SOLDUINO_MAX_LOOKUP_TABLES] = {0};
+    for (uint8_t i = 0; i < keyCount; i++) {
+        uint8_t entry;
+        bucketCount[message.classifyKey(keys[i], flags[i], entry)]++;
+    }
+    uint8_t signers = bucketCount[0] + bucketCount[1];
+    uint8_t staticKeys = signers + bucketCount[2] + bucketCount[3];
+    uint32_t messageBytes = TransactionSerializer::messageSize(message.isVersioned(), staticKeys, instructionCount,
+                                                               instructionBytes, bucketCount + 4, bucketCount + 4 + T,
+                                                               message.lookupTableCount);
+
+    uint32_t total = TransactionSerializer::signaturesSize(signers) + messageBytes;
+    if (messageBytes > MAX_MESSAGE_SIZE || total > 0xFFFF) {
+        return false;
+    }
+    size = (uint16_t)total;
+    accounts = keyCount;
+    return true;
+}
+
+bool InstructionPacker::fits(const TransactionBase& transaction, uint32_t computeUsed,
+                             const InstructionBase& instruction, uint32_t computeUnits) const {
+    const MessageBase& message = transaction.getMessage();
+    if (message.getInstructionCount() >= limits.maxInstructions ||
+        message.getInstructionCount() >= message.getInstructionCapacity() ||
+        instruction.getKeyCount() > message.getAccountCapacity() ||
+        instruction.getDataLength() > message.getDataCapacity() ||
+        computeUsed + computeUnits > limits.maxComputeUnits) {
+        return false;
+    }
+
+    uint16_t size;
+    uint8_t accounts;
+    return measure(message, &instruction, size, accounts) &&
+           size <= limits.maxTransactionSize && accounts <= limits.maxAccounts;
+}
+
+bool InstructionPacker::add(const InstructionBase& instruction, uint32_t computeUnits) {
+    if (!out || !instruction.hasProgram()) {
+        return false;
+    }
+
+    uint8_t first = (inOrder && used > 0) ? used - 1 : 0;
+    for (uint8_t t = first; t < used; t++) {
+        if (fits(transaction(t), computeUsed[t], instruction, computeUnits)) {
+            if (!transaction(t).add(instruction)) {
+                return false;
+            }
+            computeUsed[t] += computeUnits;
+            return true;
+        }
+    }
+
+    // Open a new transaction; an instruction that does not fit an empty
+    // one never will, and leaves the slot unused
+    if (used >= maxTransactions || !open(transaction(used)) ||
+        !fits(transaction(used), 0, instruction, computeUnits) || !transaction(used).add(instruction)) {
+        return false;
+    }
+    computeUsed[used++] = computeUnits;
+    return true;
+}
+
+bool InstructionPacker::packArray(const void* instructions, const InstructionBase& (*at)(const void*, uint16_t),
+                                  uint16_t count, const uint32_t* computeUnits) {
+    if (!instructions || count == 0) {
+        return count == 0;
+    }
+
+    uint16_t* order = (uint16_t*)malloc((size_t)count * sizeof(uint16_t));
+    uint32_t* footprint = (uint32_t*)malloc((size_t)count * sizeof(uint32_t));
+    if (!order || !footprint) {
+        free(order);
+        free(footprint);
+        return false;
+    }
+
+    // Stable insertion sort, largest first, so equal readings stay in order
+    for (uint16_t i = 0; i < count; i++) {
+        footprint[i] = instructionFootprint(at(instructions, i));
+        uint16_t j = i;
+        while (j > 0 && footprint[order[j - 1]] < footprint[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    bool ok = true;
+    for (uint16_t i = 0; i < count && ok; i++) {
+        uint16_t index = order[i];
+        ok = add(at(instructions, index), computeUnits ? computeUnits[index] : 0);
+    }
+
+    free(order);
+    free(footprint);
+    return ok;
+}
+
+uint16_t InstructionPacker::getTransactionSize(uint8_t index) const {
+    uint16_t size;
+    uint8_t accounts;
+    if (index >= used || !measure(transaction(index).getMessage(), nullptr, size, accounts)) {
+        return 0;
+    }
+    return size;
+}
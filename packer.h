@@ -0,0 +1,183 @@
+#ifndef SOLDUINO_PACKER_H
+#define SOLDUINO_PACKER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "transaction.h"
+
+// ============================================================================
+// Solduino Instruction Packer Module
+// ============================================================================
+// Bins a stream of instructions into as few transactions as possible:
+// - Exact wire-size accounting (signatures, shortvecs, v0 lookups)
+// - Per-transaction account, instruction and compute-unit limits
+// - In-order (next-fit) or first-fit placement; pack() sorts first
+// ============================================================================
+
+// Accounts a single transaction may lock, loaded accounts included
+#ifndef SOLDUINO_MAX_ACCOUNT_LOCKS
+#define SOLDUINO_MAX_ACCOUNT_LOCKS 64
+#endif
+
+// Compute units a single transaction may request
+#ifndef SOLDUINO_MAX_COMPUTE_UNITS
+#define SOLDUINO_MAX_COMPUTE_UNITS 1400000
+#endif
+
+// Transactions one packer fills
+#ifndef SOLDUINO_PACKER_MAX_TRANSACTIONS
+#define SOLDUINO_PACKER_MAX_TRANSACTIONS 32
+#endif
+
+/**
+ * Per-transaction limits enforced by InstructionPacker
+ */
+struct PackerLimits {
+    uint16_t maxTransactionSize;   // serialized bytes, signatures included
+    uint8_t maxAccounts;           // account locks (static + loaded keys)
+    uint8_t maxInstructions;
+    uint32_t maxComputeUnits;      // sum of the estimates passed to add()
+};
+
+/**
+ * Instruction packer.
+ *
+ * Fills a caller-owned array of transactions of any BasicTransaction
+ * capacity. Each transaction starts with
+ * the fee payer as its first writable signer, every attached lookup table
+ * and the current blockhash, so the output is ready to sign. Before an
+ * instruction is placed, the packer computes the exact serialized size the
+ * transaction would have with it (merged key privileges, signature slots,
+ * compact-u16 lengths and v0 lookups), so a transaction it returns always
+ * serializes within the limits.
+ *
+ * add() tries every open transaction in order (first fit), or only the
+ * last one with setInOrder(true), which keeps instructions in submission
+ * order across transactions. pack() places an array largest-first (first
+ * fit decreasing), which leaves the fewest transactions for mixed sizes.
+ *
+ * Usage:
+ *   static Transaction txs[8];
+ *   InstructionPacker packer;
+ *   packer.begin(payerPub, txs, 8);
+ *   packer.setRecentBlockhash(blockhash);
+ *   for (...) packer.add(readingIx);
+ *   for (uint8_t i = 0; i < packer.getTransactionCount(); i++) {
+ *       txs[i].sign(payer);
+ *   }
+ */
+class InstructionPacker {
+public:
+    InstructionPacker();
+
+    /**
+     * Start packing into out[0..maxTransactions). Transactions are reset
+     * as they are opened. Clears lookup tables and the blockhash.
+     * @param feePayer        Fee payer public key (32 bytes)
+     * @param out             Output transactions (Transaction or any BasicTransaction)
+     * @param maxTransactions Capacity of out (at most SOLDUINO_PACKER_MAX_TRANSACTIONS)
+     * @return true if successful
+     */
+    template <typename Tx>
+    bool begin(const uint8_t* feePayer, Tx* out, uint8_t maxTransactions) {
+        return begin(feePayer, out, &transactionOf<Tx>, maxTransactions);
+    }
+
+    /**
+     * Replace the default limits (SOLDUINO_MAX_TRANSACTION_SIZE,
+     * SOLDUINO_MAX_ACCOUNT_LOCKS, no instruction limit, SOLDUINO_MAX_COMPUTE_UNITS).
+     * Applies to instructions added afterwards. The capacity of the output
+     * transactions (keys, instructions, data) limits them as well.
+     */
+    void setLimits(const PackerLimits& limits) { this->limits = limits; }
+    const PackerLimits& getLimits() const { return limits; }
+
+    /**
+     * Only ever append to the last transaction (next fit)
+     */
+    void setInOrder(bool inOrder) { this->inOrder = inOrder; }
+
+    /**
+     * Attach a lookup table to every transaction opened from now on.
+     * Call before adding instructions. The table must outlive the output.
+     * @return false if SOLDUINO_MAX_LOOKUP_TABLES are already attached
+     */
+    bool addLookupTable(const AddressLookupTable* table);
+
+    /**
+     * Set the recent blockhash of every transaction, including ones
+     * opened later.
+     * @param blockhash Blockhash (32 bytes)
+     */
+    void setRecentBlockhash(const uint8_t* blockhash);
+
+    /**
+     * Place one instruction.
+     * @param instruction  Instruction to place
+     * @param computeUnits Estimated compute units (0 = not counted)
+     * @return false if it does not fit even an empty transaction, or every
+     *         transaction is full
+     */
+    bool add(const InstructionBase& instruction, uint32_t computeUnits = 0);
+
+    /**
+     * Place an array of instructions, largest first. Equal-sized
+     * instructions keep their order.
+     * @param instructions Instructions to place (Instruction or any BasicInstruction)
+     * @param count        Number of instructions
+     * @param computeUnits Per-instruction estimates, or nullptr
+     * @return false if any instruction could not be placed; the ones
+     *         before it in placement order stay packed
+     */
+    template <typename Ix>
+    bool pack(const Ix* instructions, uint16_t count, const uint32_t* computeUnits = nullptr) {
+        return packArray(instructions, &instructionOf<Ix>, count, computeUnits);
+    }
+
+    /** @return Number of transactions filled so far */
+    uint8_t getTransactionCount() const { return used; }
+
+    /**
+     * Exact serialized size of a filled transaction once fully signed.
+     * @return Size in bytes, or 0 if index is out of range
+     */
+    uint16_t getTransactionSize(uint8_t index) const;
+
+    /** @return Compute units estimated for a filled transaction */
+    uint32_t getComputeUnits(uint8_t index) const { return index < used ? computeUsed[index] : 0; }
+
+private:
+    uint8_t feePayer[SOLDUINO_PUBKEY_SIZE];
+    uint8_t recentBlockhash[BLOCKHASH_SIZE];
+    bool hasBlockhash;
+    const AddressLookupTable* lookupTables[SOLDUINO_MAX_LOOKUP_TABLES];
+    uint8_t lookupTableCount;
+    PackerLimits limits;
+    bool inOrder;
+
+    // Output array, reached through an accessor that knows its element type
+    void* out;
+    TransactionBase& (*transactionAt)(void* out, uint16_t index);
+    uint8_t maxTransactions;
+    uint8_t used;
+    uint32_t computeUsed[SOLDUINO_PACKER_MAX_TRANSACTIONS];
+
+    template <typename Tx>
+    static TransactionBase& transactionOf(void* array, uint16_t index) { return static_cast<Tx*>(array)[index]; }
+    template <typename Ix>
+    static const InstructionBase& instructionOf(const void* array, uint16_t index) {
+        return static_cast<const Ix*>(array)[index];
+    }
+
+    bool begin(const uint8_t* feePayer, void* out, TransactionBase& (*at)(void*, uint16_t), uint8_t maxTransactions);
+    bool packArray(const void* instructions, const InstructionBase& (*at)(const void*, uint16_t),
+                   uint16_t count, const uint32_t* computeUnits);
+    TransactionBase& transaction(uint8_t index) const { return transactionAt(out, index); }
+    bool open(TransactionBase& transaction);
+    bool fits(const TransactionBase& transaction, uint32_t computeUsed,
+              const InstructionBase& instruction, uint32_t computeUnits) const;
+    static bool measure(const MessageBase& message, const InstructionBase* instruction,
+                        uint16_t& size, uint8_t& accounts);
+};
+
+#endif // SOLDUINO_PACKER_H
@@ -1,6 +1,18 @@
 #include "programs.h"
 #include <string.h>
-#include <sodium.h>
+#include <stdlib.h>
+#include "crypto_backend.h"
+
+#ifdef ESP32
+#include <Preferences.h>
+#else
+#include <stdio.h>
+#endif
+
+#if SOLDUINO_PDA_THREADS
+#include <atomic>
+#include "worker_pool.h"
+#endif
 
 // ============================================================================
 // Well-Known Program IDs
@@ -26,6 +38,14 @@ const uint8_t TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID[SOLDUINO_PUBKEY_SIZE] =
     0x04, 0x8e, 0x7b, 0xd8, 0xdb, 0xe9, 0xf8, 0x59
 };
 
+// Rent sysvar: SysvarRent111111111111111111111111111111111
+const uint8_t TokenProgram::RENT_SYSVAR_ID[SOLDUINO_PUBKEY_SIZE] = {
+    0x06, 0xa7, 0xd5, 0x17, 0x18, 0x7b, 0xd1, 0x6c,
+    0xdd, 0x36, 0xdc, 0xf3, 0x05, 0xe6, 0x8d, 0x16,
+    0xc0, 0x01, 0x6c, 0x68, 0x05, 0x5a, 0x2d, 0x69,
+    0x10, 0x05, 0x10, 0x03, 0x35, 0x47, 0xb5, 0x6b
+};
+
 // ============================================================================
 // SystemProgram Implementation
 // ============================================================================
@@ -34,17 +54,9 @@ Instruction SystemProgram::transfer(const uint8_t* from,
                                     const uint8_t* to,
                                     uint64_t lamports) {
     Instruction ix;
-    if (!from || !to) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(from, true, true);    // signer, writable (fee payer / source)
-    ix.addKey(to, false, true);     // writable (destination)
-
-    // SystemInstruction::Transfer discriminator = 2 (u32 LE)
-    ix.writeU32LE(2);
-    // Amount in lamports (u64 LE)
-    ix.writeU64LE(lamports);
-
+    if (!Transfer::encode(ix, from, to, lamports)) {
+        ix.reset();
+    }
     return ix;
 }
 
@@ -54,52 +66,26 @@ Instruction SystemProgram::createAccount(const uint8_t* payer,
                                          uint64_t space,
                                          const uint8_t* owner) {
     Instruction ix;
-    if (!payer || !newAccount || !owner) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(payer, true, true);       // signer, writable (funding account)
-    ix.addKey(newAccount, true, true);  // signer, writable (new account)
-
-    // SystemInstruction::CreateAccount discriminator = 0 (u32 LE)
-    ix.writeU32LE(0);
-    // Lamports to transfer (u64 LE)
-    ix.writeU64LE(lamports);
-    // Space in bytes (u64 LE)
-    ix.writeU64LE(space);
-    // Owner program ID (32 bytes)
-    ix.writePubkey(owner);
-
+    if (!CreateAccount::encode(ix, payer, newAccount, lamports, space, owner)) {
+        ix.reset();
+    }
     return ix;
 }
 
 Instruction SystemProgram::assign(const uint8_t* account,
                                   const uint8_t* owner) {
     Instruction ix;
-    if (!account || !owner) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(account, true, true);  // signer, writable
-
-    // SystemInstruction::Assign discriminator = 1 (u32 LE)
-    ix.writeU32LE(1);
-    // New owner program ID (32 bytes)
-    ix.writePubkey(owner);
-
+    if (!Assign::encode(ix, account, owner)) {
+        ix.reset();
+    }
     return ix;
 }
 
 Instruction SystemProgram::allocate(const uint8_t* account, uint64_t space) {
     Instruction ix;
-    if (!account) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(account, true, true);  // signer, writable
-
-    // SystemInstruction::Allocate discriminator = 8 (u32 LE)
-    ix.writeU32LE(8);
-    // Space in bytes (u64 LE)
-    ix.writeU64LE(space);
-
+    if (!Allocate::encode(ix, account, space)) {
+        ix.reset();
+    }
     return ix;
 }
 
@@ -112,18 +98,9 @@ Instruction TokenProgram::transfer(const uint8_t* source,
                                    const uint8_t* authority,
                                    uint64_t amount) {
     Instruction ix;
-    if (!source || !dest || !authority) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(source, false, true);     // writable (source token account)
-    ix.addKey(dest, false, true);       // writable (destination token account)
-    ix.addKey(authority, true, false);  // signer (owner/delegate)
-
-    // TokenInstruction::Transfer discriminator = 3 (single byte)
-    ix.writeU8(3);
-    // Amount (u64 LE)
-    ix.writeU64LE(amount);
-
+    if (!Transfer::encode(ix, source, dest, authority, amount)) {
+        ix.reset();
+    }
     return ix;
 }
 
@@ -132,18 +109,9 @@ Instruction TokenProgram::approve(const uint8_t* source,
                                   const uint8_t* authority,
                                   uint64_t amount) {
     Instruction ix;
-    if (!source || !delegate || !authority) return ix;
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(source, false, true);     // writable (source token account)
-    ix.addKey(delegate, false, false);  // readonly (delegate)
-    ix.addKey(authority, true, false);  // signer (owner)
-
-    // TokenInstruction::Approve discriminator = 4 (single byte)
-    ix.writeU8(4);
-    // Amount (u64 LE)
-    ix.writeU64LE(amount);
-
+    if (!Approve::encode(ix, source, delegate, authority, amount)) {
+        ix.reset();
+    }
     return ix;
 }
 
@@ -151,25 +119,9 @@ Instruction TokenProgram::initializeAccount(const uint8_t* account,
                                             const uint8_t* mint,
                                             const uint8_t* owner) {
     Instruction ix;
-    if (!account || !mint || !owner) return ix;
-
-    // Rent sysvar: SysvarRent111111111111111111111111111111111
-    static const uint8_t RENT_SYSVAR[SOLDUINO_PUBKEY_SIZE] = {
-        0x06, 0xa7, 0xd5, 0x17, 0x18, 0x7b, 0xd1, 0x6c,
-        0xdd, 0x36, 0xdc, 0xf3, 0x05, 0xe6, 0x8d, 0x16,
-        0xc0, 0x01, 0x6c, 0x68, 0x05, 0x5a, 0x2d, 0x69,
-        0x10, 0x05, 0x10, 0x03, 0x35, 0x47, 0xb5, 0x6b
-    };
-
-    ix.setProgram(PROGRAM_ID);
-    ix.addKey(account, false, true);    // writable (token account to init)
-    ix.addKey(mint, false, false);      // readonly (mint)
-    ix.addKey(owner, false, false);     // readonly (owner)
-    ix.addKey(RENT_SYSVAR, false, false); // readonly (rent sysvar)
-
-    // TokenInstruction::InitializeAccount discriminator = 1 (single byte)
-    ix.writeU8(1);
-
+    if (!InitializeAccount::encode(ix, account, mint, owner)) {
+        ix.reset();
+    }
     return ix;
 }
 
@@ -181,6 +133,95 @@ Instruction TokenProgram::initializeAccount(const uint8_t* account,
 static const char PDA_MARKER[] = "ProgramDerivedAddress";
 static const size_t PDA_MARKER_LEN = 21; // strlen("ProgramDerivedAddress")
 
+// Everything after the seeds: [bump | programId | "ProgramDerivedAddress"]
+static const size_t PDA_SUFFIX_LEN = 1 + SOLDUINO_PUBKEY_SIZE + PDA_MARKER_LEN;
+
+/**
+ * Absorb the seeds into a fresh SHA-256 prefix. The result is the midstate
+ * shared by every bump attempt for the same seed set.
+ */
+static void pdaHashSeeds(Sha256Midstate* mid,
+                         const uint8_t* seeds[],
+                         const size_t seedLens[],
+                         uint8_t seedCount) {
+    sha256MidstateInit(mid);
+    for (uint8_t i = 0; i < seedCount; i++) {
+        if (seeds[i] && seedLens[i] > 0) {
+            sha256MidstateUpdate(mid, seeds[i], seedLens[i]);
+        }
+    }
+}
+
+/**
+ * Fill the suffix buffer with programId and the marker; byte 0 is left for
+ * the bump and patched per attempt.
+ */
+static void pdaBuildSuffix(uint8_t suffix[PDA_SUFFIX_LEN], const uint8_t* programId) {
+    suffix[0] = 0;
+    memcpy(suffix + 1, programId, SOLDUINO_PUBKEY_SIZE);
+    memcpy(suffix + 1 + SOLDUINO_PUBKEY_SIZE, PDA_MARKER, PDA_MARKER_LEN);
+}
+
+/**
+ * Finish one bump attempt from the seed midstate.
+ * @return true if the hash is off-curve (a valid PDA), written to outAddress
+ */
+static bool pdaTryBump(const Sha256Midstate* seedState,
+                       uint8_t suffix[PDA_SUFFIX_LEN],
+                       uint8_t bump,
+                       uint8_t* outAddress) {
+    suffix[0] = bump;
+    uint8_t hash[32];
+    sha256Finish(seedState, suffix, PDA_SUFFIX_LEN, hash);
+
+    // A valid PDA must NOT be on the Ed25519 curve. isOnCurve() only tests
+    // decompression, exactly like Solana; libsodium's is_valid_point also
+    // rejects small-order and non-subgroup points and so misses many bumps.
+    if (cryptoBackend()->isOnCurve(hash)) {
+        return false;
+    }
+
+    memcpy(outAddress, hash, SOLDUINO_PUBKEY_SIZE);
+    return true;
+}
+
+/**
+ * Bump search over SOLDUINO_SHA256_LANES bumps per pass. Lanes are checked
+ * highest bump first, so the result is the same canonical bump a one-at-a-
+ * time search returns.
+ */
+static bool pdaSearch(const Sha256Midstate* seedState,
+                      const uint8_t* programId,
+                      uint8_t* outAddress,
+                      uint8_t* outBump) {
+    uint8_t suffixes[SOLDUINO_SHA256_LANES][PDA_SUFFIX_LEN];
+    const uint8_t* lanes[SOLDUINO_SHA256_LANES];
+    for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+        pdaBuildSuffix(suffixes[l], programId);
+        lanes[l] = suffixes[l];
+    }
+
+    bool (*onCurve)(const uint8_t*) = cryptoBackend()->isOnCurve;
+    uint8_t hashes[SOLDUINO_SHA256_LANES][32];
+    for (int top = 255; top >= 0; top -= SOLDUINO_SHA256_LANES) {
+        for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+            suffixes[l][0] = (uint8_t)(top - l);
+        }
+        sha256FinishLanes(seedState, lanes, PDA_SUFFIX_LEN, hashes);
+
+        for (int l = 0; l < SOLDUINO_SHA256_LANES && top - l >= 0; l++) {
+            if (!onCurve(hashes[l])) {
+                memcpy(outAddress, hashes[l], SOLDUINO_PUBKEY_SIZE);
+                *outBump = (uint8_t)(top - l);
+                return true;
+            }
+        }
+    }
+
+    // No valid PDA found (extremely rare)
+    return false;
+}
+
 bool createProgramAddress(const uint8_t* seeds[],
                           const size_t seedLens[],
                           uint8_t seedCount,
@@ -189,63 +230,478 @@ bool createProgramAddress(const uint8_t* seeds[],
                           uint8_t* outAddress) {
     if (!programId || !outAddress) return false;
     if (seedCount > MAX_PDA_SEEDS) return false;
-    if (sodium_init() < 0) return false;
 
-    // Build the hash input: [seeds... | [bump] | programId | "ProgramDerivedAddress"]
-    crypto_hash_sha256_state state;
-    crypto_hash_sha256_init(&state);
+    Sha256Midstate seedState;
+    pdaHashSeeds(&seedState, seeds, seedLens, seedCount);
 
-    // Hash each seed
-    for (uint8_t i = 0; i < seedCount; i++) {
-        if (seeds[i] && seedLens[i] > 0) {
-            crypto_hash_sha256_update(&state, seeds[i], seedLens[i]);
-        }
-    }
+    uint8_t suffix[PDA_SUFFIX_LEN];
+    pdaBuildSuffix(suffix, programId);
+    return pdaTryBump(&seedState, suffix, bump, outAddress);
+}
 
-    // Hash the bump seed as a single byte
-    uint8_t bumpByte = bump;
-    crypto_hash_sha256_update(&state, &bumpByte, 1);
+bool findProgramAddress(const uint8_t* seeds[],
+                        const size_t seedLens[],
+                        uint8_t seedCount,
+                        const uint8_t* programId,
+                        uint8_t* outAddress,
+                        uint8_t* outBump) {
+    if (!programId || !outAddress || !outBump) return false;
+    if (seedCount > MAX_PDA_SEEDS) return false;
 
-    // Hash the program ID (32 bytes)
-    crypto_hash_sha256_update(&state, programId, SOLDUINO_PUBKEY_SIZE);
+    // Seeds are identical for every bump: hash them once, then finish
+    // SOLDUINO_SHA256_LANES suffixes per pass from the shared midstate.
+    Sha256Midstate seedState;
+    pdaHashSeeds(&seedState, seeds, seedLens, seedCount);
+    return pdaSearch(&seedState, programId, outAddress, outBump);
+}
 
-    // Hash the marker string "ProgramDerivedAddress"
-    crypto_hash_sha256_update(&state, (const uint8_t*)PDA_MARKER, PDA_MARKER_LEN);
+// ============================================================================
+// Batch PDA Derivation
+// ============================================================================
 
-    // Finalize the hash
-    uint8_t hash[32];
-    crypto_hash_sha256_final(&state, hash);
+/**
+ * Shared by every worker: requests are claimed one at a time through
+ * `next`, so a slow search (a low bump) never stalls a whole chunk.
+ */
+struct PdaBatchJob {
+    PdaRequest* requests;
+    size_t count;
+#if SOLDUINO_PDA_THREADS
+    std::atomic<size_t> next;
+    std::atomic<size_t> found;
+#else
+    size_t next;
+    size_t found;
+#endif
+};
 
-    // A valid PDA must NOT be on the Ed25519 curve.
-    // crypto_core_ed25519_is_valid_point returns 1 if the point IS on the curve.
-    if (crypto_core_ed25519_is_valid_point(hash) == 1) {
-        // Point is on curve -- not a valid PDA for this bump
-        return false;
+static void pdaBatchWorker(void* context, unsigned) {
+    PdaBatchJob* job = (PdaBatchJob*)context;
+    for (;;) {
+        size_t i = job->next++;
+        if (i >= job->count) break;
+
+        PdaRequest& r = job->requests[i];
+        r.found = findProgramAddress(r.seeds, r.seedLens, r.seedCount,
+                                     r.programId, r.address, &r.bump);
+        if (r.found) job->found++;
     }
+}
 
-    // Valid PDA found
-    memcpy(outAddress, hash, SOLDUINO_PUBKEY_SIZE);
-    return true;
+size_t findProgramAddresses(PdaRequest* requests, size_t count, unsigned threads) {
+    if (!requests || count == 0) return 0;
+
+    PdaBatchJob job;
+    job.requests = requests;
+    job.count = count;
+    job.next = 0;
+    job.found = 0;
+
+#if SOLDUINO_PDA_THREADS
+    // Start the crypto backend here rather than racing on it in the workers
+    if (!cryptoBegin()) return 0;
+
+    unsigned maxThreads = count < SOLDUINO_PDA_MAX_THREADS ? (unsigned)count : SOLDUINO_PDA_MAX_THREADS;
+    runWorkers(pdaBatchWorker, &job, threads, maxThreads, SOLDUINO_PDA_STACK);
+#else
+    (void)threads;
+    pdaBatchWorker(&job, 0);
+#endif
+
+    return job.found;
 }
 
-bool findProgramAddress(const uint8_t* seeds[],
+// ============================================================================
+// PDA Cache Implementation
+// ============================================================================
+
+// Serialized layout: "PDAC" | version | count (u16 LE) | count x
+// [key(32) | address(32) | bump(1)], oldest entry first.
+static const uint8_t PDA_CACHE_MAGIC[4] = {'P', 'D', 'A', 'C'};
+static const uint8_t PDA_CACHE_VERSION = 1;
+static const size_t PDA_CACHE_HEADER_LEN = 7;
+static const size_t PDA_CACHE_RECORD_LEN = 32 + SOLDUINO_PUBKEY_SIZE + 1;
+
+#ifdef ESP32
+static const char PDA_CACHE_NVS_KEY[] = "pda";
+#endif
+
+/**
+ * Cache key: SHA-256 over the program ID and the length-prefixed seeds.
+ */
+static void pdaCacheKey(const uint8_t* seeds[],
                         const size_t seedLens[],
                         uint8_t seedCount,
                         const uint8_t* programId,
-                        uint8_t* outAddress,
-                        uint8_t* outBump) {
+                        uint8_t key[32]) {
+    CryptoSlice parts[2 + 2 * MAX_PDA_SEEDS];
+    uint8_t lenBytes[MAX_PDA_SEEDS][4];
+    size_t count = 0;
+    parts[count++] = {programId, SOLDUINO_PUBKEY_SIZE};
+    parts[count++] = {&seedCount, 1};
+    for (uint8_t i = 0; i < seedCount; i++) {
+        size_t len = seeds[i] ? seedLens[i] : 0;
+        lenBytes[i][0] = (uint8_t)len;
+        lenBytes[i][1] = (uint8_t)(len >> 8);
+        lenBytes[i][2] = (uint8_t)(len >> 16);
+        lenBytes[i][3] = (uint8_t)(len >> 24);
+        parts[count++] = {lenBytes[i], 4};
+        if (len > 0) {
+            parts[count++] = {seeds[i], len};
+        }
+    }
+    cryptoBackend()->sha256(parts, count, key);
+}
+
+PdaCache::PdaCache() {
+    clear();
+}
+
+void PdaCache::clear() {
+    memset(entries, 0, sizeof(entries));
+    for (size_t i = 0; i < SOLDUINO_PDA_CACHE_SIZE; i++) {
+        buckets[i] = -1;
+        entries[i].next = -1;
+    }
+    count = 0;
+    tick = 0;
+    hits = 0;
+    misses = 0;
+    dirty = false;
+}
+
+size_t PdaCache::bucketOf(const uint8_t key[32]) {
+    // The key is already a uniform hash, any four bytes will do
+    uint32_t h = (uint32_t)key[0] | ((uint32_t)key[1] << 8) |
+                 ((uint32_t)key[2] << 16) | ((uint32_t)key[3] << 24);
+    return h % SOLDUINO_PDA_CACHE_SIZE;
+}
+
+int16_t PdaCache::lookup(const uint8_t key[32]) const {
+    for (int16_t slot = buckets[bucketOf(key)]; slot >= 0; slot = entries[slot].next) {
+        if (memcmp(entries[slot].key, key, 32) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void PdaCache::unlink(int16_t slot) {
+    int16_t* link = &buckets[bucketOf(entries[slot].key)];
+    while (*link >= 0) {
+        if (*link == slot) {
+            *link = entries[slot].next;
+            break;
+        }
+        link = &entries[*link].next;
+    }
+    entries[slot].next = -1;
+    entries[slot].lastUsed = 0;
+    count--;
+}
+
+void PdaCache::insert(const uint8_t key[32], const uint8_t* address, uint8_t bump) {
+    // Reuse a free slot, otherwise evict the least recently used one
+    int16_t slot = 0;
+    for (int16_t i = 0; i < (int16_t)SOLDUINO_PDA_CACHE_SIZE; i++) {
+        if (entries[i].lastUsed == 0) {
+            slot = i;
+            break;
+        }
+        if (entries[i].lastUsed < entries[slot].lastUsed) {
+            slot = i;
+        }
+    }
+    if (entries[slot].lastUsed != 0) {
+        unlink(slot);
+    }
+
+    Entry& e = entries[slot];
+    memcpy(e.key, key, 32);
+    memcpy(e.address, address, SOLDUINO_PUBKEY_SIZE);
+    e.bump = bump;
+    e.lastUsed = ++tick;
+
+    size_t b = bucketOf(key);
+    e.next = buckets[b];
+    buckets[b] = slot;
+    count++;
+    dirty = true;
+}
+
+bool PdaCache::findProgramAddress(const uint8_t* seeds[],
+                                  const size_t seedLens[],
+                                  uint8_t seedCount,
+                                  const uint8_t* programId,
+                                  uint8_t* outAddress,
+                                  uint8_t* outBump) {
     if (!programId || !outAddress || !outBump) return false;
     if (seedCount > MAX_PDA_SEEDS) return false;
 
-    // Try bump seeds from 255 down to 0
-    for (int bump = 255; bump >= 0; bump--) {
-        if (createProgramAddress(seeds, seedLens, seedCount, programId,
-                                 (uint8_t)bump, outAddress)) {
-            *outBump = (uint8_t)bump;
+    uint8_t key[32];
+    pdaCacheKey(seeds, seedLens, seedCount, programId, key);
+
+    int16_t slot = lookup(key);
+    if (slot >= 0) {
+        // Re-derive at the stored bump: one hash instead of a search
+        Entry& e = entries[slot];
+        uint8_t address[SOLDUINO_PUBKEY_SIZE];
+        if (createProgramAddress(seeds, seedLens, seedCount, programId, e.bump, address) &&
+            memcmp(address, e.address, SOLDUINO_PUBKEY_SIZE) == 0) {
+            e.lastUsed = ++tick;
+            memcpy(outAddress, address, SOLDUINO_PUBKEY_SIZE);
+            *outBump = e.bump;
+            hits++;
             return true;
         }
+        // Stale or corrupted entry
+        unlink(slot);
+        dirty = true;
     }
 
-    // No valid PDA found (extremely rare)
-    return false;
+    misses++;
+    if (!::findProgramAddress(seeds, seedLens, seedCount, programId, outAddress, outBump)) {
+        return false;
+    }
+    insert(key, outAddress, *outBump);
+    return true;
+}
+
+bool PdaCache::save(const char* name) {
+    if (!name) return false;
+    if (!dirty) return true;
+
+    // Oldest first, so load() rebuilds the same LRU order
+    int16_t order[SOLDUINO_PDA_CACHE_SIZE];
+    size_t n = 0;
+    for (int16_t i = 0; i < (int16_t)SOLDUINO_PDA_CACHE_SIZE; i++) {
+        if (entries[i].lastUsed == 0) continue;
+        size_t j = n++;
+        while (j > 0 && entries[order[j - 1]].lastUsed > entries[i].lastUsed) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    size_t len = PDA_CACHE_HEADER_LEN + n * PDA_CACHE_RECORD_LEN;
+    uint8_t* buf = (uint8_t*)malloc(len);
+    if (!buf) return false;
+
+    memcpy(buf, PDA_CACHE_MAGIC, 4);
+    buf[4] = PDA_CACHE_VERSION;
+    buf[5] = (uint8_t)n;
+    buf[6] = (uint8_t)(n >> 8);
+    uint8_t* p = buf + PDA_CACHE_HEADER_LEN;
+    for (size_t i = 0; i < n; i++) {
+        const Entry& e = entries[order[i]];
+        memcpy(p, e.key, 32);
+        memcpy(p + 32, e.address, SOLDUINO_PUBKEY_SIZE);
+        p[32 + SOLDUINO_PUBKEY_SIZE] = e.bump;
+        p += PDA_CACHE_RECORD_LEN;
+    }
+
+    bool ok = false;
+#ifdef ESP32
+    Preferences prefs;
+    if (prefs.begin(name, false)) {
+        ok = prefs.putBytes(PDA_CACHE_NVS_KEY, buf, len) == len;
+        prefs.end();
+    }
+#else
+    FILE* f = fopen(name, "wb");
+    if (f) {
+        ok = fwrite(buf, 1, len, f) == len;
+        ok = (fclose(f) == 0) && ok;
+    }
+#endif
+    free(buf);
+
+    if (ok) dirty = false;
+    return ok;
+}
+
+bool PdaCache::load(const char* name) {
+    if (!name) return false;
+
+    size_t maxLen = PDA_CACHE_HEADER_LEN + SOLDUINO_PDA_CACHE_SIZE * PDA_CACHE_RECORD_LEN;
+    uint8_t* buf = (uint8_t*)malloc(maxLen);
+    if (!buf) return false;
+
+    size_t len = 0;
+#ifdef ESP32
+    Preferences prefs;
+    if (prefs.begin(name, true)) {
+        size_t stored = prefs.getBytesLength(PDA_CACHE_NVS_KEY);
+        if (stored > 0 && stored <= maxLen) {
+            len = prefs.getBytes(PDA_CACHE_NVS_KEY, buf, stored);
+        }
+        prefs.end();
+    }
+#else
+    FILE* f = fopen(name, "rb");
+    if (f) {
+        len = fread(buf, 1, maxLen, f);
+        // Anything beyond maxLen means the file is not ours (or too big)
+        if (fgetc(f) != EOF) len = 0;
+        fclose(f);
+    }
+#endif
+
+    size_t n = len >= PDA_CACHE_HEADER_LEN ? ((size_t)buf[5] | ((size_t)buf[6] << 8)) : 0;
+    bool ok = len >= PDA_CACHE_HEADER_LEN &&
+              memcmp(buf, PDA_CACHE_MAGIC, 4) == 0 &&
+              buf[4] == PDA_CACHE_VERSION &&
+              n <= SOLDUINO_PDA_CACHE_SIZE &&
+              len == PDA_CACHE_HEADER_LEN + n * PDA_CACHE_RECORD_LEN;
+
+    if (ok) {
+        clear();
+        const uint8_t* p = buf + PDA_CACHE_HEADER_LEN;
+        for (size_t i = 0; i < n; i++) {
+            if (lookup(p) < 0) {
+                insert(p, p + 32, p[32 + SOLDUINO_PUBKEY_SIZE]);
+            }
+            p += PDA_CACHE_RECORD_LEN;
+        }
+        dirty = false;
+    }
+
+    free(buf);
+    return ok;
+}
+
+// ============================================================================
+// Self-test
+// ============================================================================
+
+namespace {
+
+struct PdaVector {
+    const char* seed0;        // UTF-8 seed, or nullptr
+    const uint8_t* seed1;     // raw seed, or nullptr
+    size_t seed1Len;
+    const uint8_t* programId;
+    const char* expected;     // Base58 PDA
+    uint8_t bump;
+};
+
+struct CurveVector {
+    const char* point;        // Base58 encoding of the 32 raw bytes
+    bool onCurve;
+};
+
+// RFC 8032 test 1 public key, used as an "authority" seed
+const uint8_t RFC8032_PUBKEY[32] = {
+    0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+    0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a
+};
+const uint8_t VAULT_ID[3] = {0x01, 0x02, 0x03};
+const uint8_t DEVICE_31[4] = {0x1f, 0x00, 0x00, 0x00};
+
+// The first entry is the worked example from the Solana PDA docs; the rest
+// were derived with a reference model of curve25519-dalek decompression.
+// The first entry is the one libsodium's is_valid_point gets wrong: bump 255
+// hashes to an on-curve point outside the prime-order subgroup.
+const PdaVector PDA_VECTORS[] = {
+    {"helloWorld", nullptr, 0, SystemProgram::PROGRAM_ID, "46GZzzetjCURsdFPb7rcnspbEMnCBXe9kpjrsZAkKb6X", 254},
+    {"sensor", RFC8032_PUBKEY, 32, TokenProgram::PROGRAM_ID, "7BWfGjLfx8mWcKwqX2uHk55eLcK9asiaQAdqqx5r3d8s", 254},
+    {"sensor", RFC8032_PUBKEY, 32, TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID, "HeRfXFE3Ny3VSPsiyLrESgmgXCEFJce7XV3aacHmTP44", 254},
+    {nullptr, nullptr, 0, TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID, "DzQr5rR32D2de4ugfqgNmKboRoBK5eid5K7WpRCxeRBY", 254},
+    {"vault", VAULT_ID, 3, SystemProgram::PROGRAM_ID, "9APHqJYQV7apisbyPng5pTjvpTHSfWUpyy5dsCHoczYa", 252},
+    {"device", DEVICE_31, 4, TokenProgram::ASSOCIATED_TOKEN_PROGRAM_ID, "CaaMZrdusiSow42xN3tfmDQoF9oe21k9zHrXa1Tvrnp4", 250},
+};
+
+// Points where Solana's decompression-only check and libsodium disagree
+const CurveVector CURVE_VECTORS[] = {
+    {"4uQeVj5tqViQh7yWWGStvkEG1Zmhx6uasJtWCJziofM", true},   // identity (y = 1), small order
+    {"11111111111111111111111111111111", true},              // y = 0, order 4 (System Program ID)
+    {"H5xSWNRAbqKddKjrabehyU8drL3Dk4LgZJiEJc9rGGyC", true},  // y = p + 1, non-canonical
+    {"4uQeVj5tqViQh7yWWGStvkEG1Zmhx6uasJtWCJziohZ", true},   // y = 1 with x sign bit set
+    {"FVen3X669xLzsi6N2V91DoiyzHzg1uAgqiT8jZ9nS96Z", true},  // RFC 8032 public key
+    {"7aGCrjwMFDLq92oeSwfADozP7RNk5Rkqoz2ESFUZAT3b", true},  // "helloWorld" bump 255: on curve, not in subgroup
+    {"46GZzzetjCURsdFPb7rcnspbEMnCBXe9kpjrsZAkKb6X", false}, // "helloWorld" bump 254: the PDA
+};
+
+}  // namespace
+
+bool testProgramAddress() {
+    bool ok = true;
+
+    for (size_t i = 0; i < sizeof(CURVE_VECTORS) / sizeof(CURVE_VECTORS[0]); i++) {
+        uint8_t point[SOLDUINO_PUBKEY_SIZE];
+        if (!addressToPublicKey(CURVE_VECTORS[i].point, point) ||
+            isOnCurve(point) != CURVE_VECTORS[i].onCurve) {
+            Serial.print("isOnCurve mismatch: ");
+            Serial.println(CURVE_VECTORS[i].point);
+            ok = false;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(PDA_VECTORS) / sizeof(PDA_VECTORS[0]); i++) {
+        const PdaVector& v = PDA_VECTORS[i];
+        const uint8_t* seeds[2];
+        size_t seedLens[2];
+        uint8_t seedCount = 0;
+        if (v.seed0) {
+            seeds[seedCount] = (const uint8_t*)v.seed0;
+            seedLens[seedCount++] = strlen(v.seed0);
+        }
+        if (v.seed1) {
+            seeds[seedCount] = v.seed1;
+            seedLens[seedCount++] = v.seed1Len;
+        }
+
+        uint8_t expected[SOLDUINO_PUBKEY_SIZE];
+        uint8_t address[SOLDUINO_PUBKEY_SIZE];
+        uint8_t bump = 0;
+        if (!addressToPublicKey(v.expected, expected) ||
+            !findProgramAddress(seeds, seedLens, seedCount, v.programId, address, &bump) ||
+            bump != v.bump || memcmp(address, expected, SOLDUINO_PUBKEY_SIZE) != 0) {
+            Serial.print("PDA mismatch: ");
+            Serial.println(v.expected);
+            ok = false;
+        }
+    }
+
+    // Lane kernel against one-at-a-time SHA-256 (libsodium's where it is
+    // available), across every tail length of the prefix
+    // and suffixes that span one and two final blocks
+    uint8_t message[128 + 64];
+    for (size_t i = 0; i < sizeof(message); i++) message[i] = (uint8_t)(i * 37 + 11);
+    for (size_t prefixLen = 0; prefixLen <= 128; prefixLen++) {
+        for (size_t suffixLen = 54; suffixLen <= 64; suffixLen += 10) {
+            Sha256Midstate mid;
+            sha256MidstateInit(&mid);
+            sha256MidstateUpdate(&mid, message, prefixLen);
+
+            uint8_t suffixes[SOLDUINO_SHA256_LANES][64];
+            const uint8_t* lanes[SOLDUINO_SHA256_LANES];
+            uint8_t digests[SOLDUINO_SHA256_LANES][32];
+            for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+                memcpy(suffixes[l], message + prefixLen, suffixLen);
+                suffixes[l][0] ^= (uint8_t)l;
+                lanes[l] = suffixes[l];
+            }
+            sha256FinishLanes(&mid, lanes, suffixLen, digests);
+
+            for (int l = 0; l < SOLDUINO_SHA256_LANES; l++) {
+                uint8_t expected[32];
+                CryptoSlice parts[2] = {{message, prefixLen}, {suffixes[l], suffixLen}};
+#if SOLDUINO_HAS_SODIUM
+                CRYPTO_BACKEND_LIBSODIUM.sha256(parts, 2, expected);
+#else
+                CRYPTO_BACKEND_REFERENCE.sha256(parts, 2, expected);
+#endif
+                if (memcmp(digests[l], expected, 32) != 0) {
+                    Serial.print("SHA-256 lane mismatch at prefix length ");
+                    Serial.println((int)prefixLen);
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    Serial.println(ok ? "All PDA tests passed" : "PDA tests failed");
+    return ok;
 }
@@ -14,6 +14,8 @@
 // - TokenProgram   (TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA)
 // - AssociatedTokenProgram
 // - findProgramAddress() for PDA derivation
+// - findProgramAddresses() for deriving many PDAs across cores
+// - PdaCache for remembering derivations across calls and reboots
 // ============================================================================
 
 // Maximum number of seeds for PDA derivation
@@ -21,6 +23,32 @@
 #define MAX_PDA_SEEDS 16
 #endif
 
+// Number of derivations a PdaCache remembers
+#ifndef SOLDUINO_PDA_CACHE_SIZE
+#define SOLDUINO_PDA_CACHE_SIZE 16
+#endif
+
+// findProgramAddresses() spreads work over std::thread workers on ESP32
+// and hosted builds; other boards derive the batch on the calling thread
+#ifndef SOLDUINO_PDA_THREADS
+#if defined(ESP32) || !defined(ARDUINO)
+#define SOLDUINO_PDA_THREADS 1
+#else
+#define SOLDUINO_PDA_THREADS 0
+#endif
+#endif
+
+// Upper bound on findProgramAddresses() worker threads
+#ifndef SOLDUINO_PDA_MAX_THREADS
+#define SOLDUINO_PDA_MAX_THREADS 16
+#endif
+
+// Stack of each findProgramAddresses() worker on ESP32; the hash and
+// on-curve frames need more than the 3 KB pthread default
+#ifndef SOLDUINO_PDA_STACK
+#define SOLDUINO_PDA_STACK 8192
+#endif
+
 // ============================================================================
 // System Program
 // ============================================================================
@@ -29,11 +57,15 @@
  * SystemProgram helpers
  * 
  * Provides static methods that return ready-to-use Instruction objects
- * for the Solana System Program (address: 11111111111111111111111111111111).
+ * for the Solana System Program (address: 11111111111111111111111111111111),
+ * and instruction types that Transaction::emplace() encodes straight into
+ * the message. Both produce the same instruction; emplace() skips the
+ * Instruction in between.
  *
  * Usage:
  *   Transaction tx;
  *   tx.add(SystemProgram::transfer(from, to, lamports));
+ *   tx.emplace<SystemProgram::Transfer>(from, to, lamports);
  */
 class SystemProgram {
 public:
@@ -79,6 +111,63 @@ public:
      * @return Instruction ready to add to a Transaction
      */
     static Instruction allocate(const uint8_t* account, uint64_t space);
+
+    // ---- Instruction types -------------------------------------------------
+    // encode() writes into an Instruction or, through emplace(), straight
+    // into a transaction; the helpers above are built from them
+
+    /** SOL transfer; see transfer() */
+    struct Transfer {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* from, const uint8_t* to, uint64_t lamports) {
+            return from && to &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(from, true, true) &&      // signer, writable (fee payer / source)
+                   ix.addKey(to, false, true) &&       // writable (destination)
+                   ix.writeU32LE(2) &&                 // SystemInstruction::Transfer
+                   ix.writeU64LE(lamports);
+        }
+    };
+
+    /** Create account; see createAccount() */
+    struct CreateAccount {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* payer, const uint8_t* newAccount,
+                           uint64_t lamports, uint64_t space, const uint8_t* owner) {
+            return payer && newAccount && owner &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(payer, true, true) &&     // signer, writable (funding account)
+                   ix.addKey(newAccount, true, true) && // signer, writable (new account)
+                   ix.writeU32LE(0) &&                 // SystemInstruction::CreateAccount
+                   ix.writeU64LE(lamports) &&
+                   ix.writeU64LE(space) &&
+                   ix.writePubkey(owner);
+        }
+    };
+
+    /** Assign; see assign() */
+    struct Assign {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* account, const uint8_t* owner) {
+            return account && owner &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(account, true, true) &&   // signer, writable
+                   ix.writeU32LE(1) &&                 // SystemInstruction::Assign
+                   ix.writePubkey(owner);
+        }
+    };
+
+    /** Allocate; see allocate() */
+    struct Allocate {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* account, uint64_t space) {
+            return account &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(account, true, true) &&   // signer, writable
+                   ix.writeU32LE(8) &&                 // SystemInstruction::Allocate
+                   ix.writeU64LE(space);
+        }
+    };
 };
 
 // ============================================================================
@@ -89,11 +178,13 @@ public:
  * TokenProgram helpers
  * 
  * Provides static methods that return ready-to-use Instruction objects
- * for the SPL Token Program (TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA).
+ * for the SPL Token Program (TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA),
+ * and the matching instruction types for Transaction::emplace().
  *
  * Usage:
  *   Transaction tx;
  *   tx.add(TokenProgram::transfer(source, dest, authority, amount));
+ *   tx.emplace<TokenProgram::Transfer>(source, dest, authority, amount);
  */
 class TokenProgram {
 public:
@@ -103,6 +194,9 @@ public:
     /** Associated Token Account Program ID */
     static const uint8_t ASSOCIATED_TOKEN_PROGRAM_ID[SOLDUINO_PUBKEY_SIZE];
 
+    /** Rent sysvar (SysvarRent111111111111111111111111111111111) */
+    static const uint8_t RENT_SYSVAR_ID[SOLDUINO_PUBKEY_SIZE];
+
     /**
      * SPL Token Transfer instruction.
      * @param source    Source token account (writable)
@@ -140,6 +234,52 @@ public:
     static Instruction initializeAccount(const uint8_t* account,
                                          const uint8_t* mint,
                                          const uint8_t* owner);
+
+    // ---- Instruction types -------------------------------------------------
+
+    /** Token transfer; see transfer() */
+    struct Transfer {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* source, const uint8_t* dest,
+                           const uint8_t* authority, uint64_t amount) {
+            return source && dest && authority &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(source, false, true) &&   // writable (source token account)
+                   ix.addKey(dest, false, true) &&     // writable (destination token account)
+                   ix.addKey(authority, true, false) && // signer (owner/delegate)
+                   ix.writeU8(3) &&                    // TokenInstruction::Transfer
+                   ix.writeU64LE(amount);
+        }
+    };
+
+    /** Approve; see approve() */
+    struct Approve {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* source, const uint8_t* delegate,
+                           const uint8_t* authority, uint64_t amount) {
+            return source && delegate && authority &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(source, false, true) &&   // writable (source token account)
+                   ix.addKey(delegate, false, false) && // readonly (delegate)
+                   ix.addKey(authority, true, false) && // signer (owner)
+                   ix.writeU8(4) &&                    // TokenInstruction::Approve
+                   ix.writeU64LE(amount);
+        }
+    };
+
+    /** Initialize account; see initializeAccount() */
+    struct InitializeAccount {
+        template <typename Writer>
+        static bool encode(Writer& ix, const uint8_t* account, const uint8_t* mint, const uint8_t* owner) {
+            return account && mint && owner &&
+                   ix.setProgram(PROGRAM_ID) &&
+                   ix.addKey(account, false, true) &&  // writable (token account to init)
+                   ix.addKey(mint, false, false) &&    // readonly (mint)
+                   ix.addKey(owner, false, false) &&   // readonly (owner)
+                   ix.addKey(RENT_SYSVAR_ID, false, false) && // readonly (rent sysvar)
+                   ix.writeU8(1);                      // TokenInstruction::InitializeAccount
+        }
+    };
 };
 
 // ============================================================================
@@ -151,9 +291,9 @@ public:
  *
  * Iterates bump seeds from 255 down to 0, hashing
  * [seeds... | bump | programId | "ProgramDerivedAddress"]
- * with SHA-256 until the result is NOT on the Ed25519 curve.
- *
- * Requires libsodium with Ed25519 ristretto / core support.
+ * with SHA-256 until the result is NOT on the Ed25519 curve
+ * (see isOnCurve(), which matches Solana's check exactly).
+ * Bumps are hashed SOLDUINO_SHA256_LANES at a time (see sha256FinishLanes()).
  *
  * @param seeds      Array of seed byte pointers
  * @param seedLens   Array of seed lengths (one per seed)
@@ -189,4 +329,137 @@ bool createProgramAddress(const uint8_t* seeds[],
                           uint8_t bump,
                           uint8_t* outAddress);
 
+// ============================================================================
+// Batch PDA Derivation
+// ============================================================================
+
+/**
+ * One entry of a findProgramAddresses() batch. Inputs are borrowed and
+ * must stay valid for the duration of the call; outputs are filled in.
+ */
+struct PdaRequest {
+    const uint8_t** seeds;      // Seed byte pointers
+    const size_t* seedLens;     // Seed lengths (one per seed)
+    uint8_t seedCount;          // Number of seeds
+    const uint8_t* programId;   // 32-byte program ID
+
+    uint8_t address[SOLDUINO_PUBKEY_SIZE];  // Output: the PDA
+    uint8_t bump;                           // Output: canonical bump
+    bool found;                             // Output: false if no bump worked
+};
+
+/**
+ * Derive many PDAs at once.
+ *
+ * Each request is searched exactly like findProgramAddress() (same
+ * address and bump). With SOLDUINO_PDA_THREADS the batch is shared by up
+ * to `threads` workers, the calling thread included.
+ *
+ * Example:
+ *   PdaRequest reqs[1000];
+ *   // ... fill seeds / seedLens / seedCount / programId ...
+ *   size_t ok = findProgramAddresses(reqs, 1000);
+ *
+ * @param requests Array of requests, outputs written in place
+ * @param count    Number of requests
+ * @param threads  Worker count; 0 = one per hardware thread
+ * @return Number of requests for which a PDA was found
+ */
+size_t findProgramAddresses(PdaRequest* requests, size_t count, unsigned threads = 0);
+
+// ============================================================================
+// PDA Cache
+// ============================================================================
+
+/**
+ * Fixed-capacity cache of PDA derivations, keyed by
+ * SHA-256(programId | seedCount | len | seed | ...).
+ *
+ * A hit is re-verified with createProgramAddress() at the stored bump
+ * (one hash + one curve check) instead of a full bump search, so a stale
+ * or corrupted entry can never hand back a wrong address. When full, the
+ * least recently used entry is evicted.
+ *
+ * The table can be saved and restored so devices skip the search on boot:
+ * on ESP32 it is stored as an NVS blob (the "nvs" flash partition) under
+ * the given namespace; elsewhere it is written to the given file path.
+ *
+ * Usage:
+ *   PdaCache pdaCache;
+ *   pdaCache.load("solduino");
+ *   pdaCache.findProgramAddress(seeds, seedLens, 2, programId, pda, &bump);
+ *   pdaCache.save("solduino");   // only writes if something changed
+ */
+class PdaCache {
+public:
+    PdaCache();
+
+    /**
+     * Same contract as ::findProgramAddress(), served from the cache
+     * when possible. Misses run the full search and insert the result.
+     */
+    bool findProgramAddress(const uint8_t* seeds[],
+                            const size_t seedLens[],
+                            uint8_t seedCount,
+                            const uint8_t* programId,
+                            uint8_t* outAddress,
+                            uint8_t* outBump);
+
+    /** Drop every entry and reset the counters. */
+    void clear();
+
+    /**
+     * Persist the table.
+     * @param name NVS namespace on ESP32, file path elsewhere
+     * @return true on success (or if nothing changed since the last save/load)
+     */
+    bool save(const char* name);
+
+    /**
+     * Restore a table written by save(). Existing entries are replaced.
+     * @param name NVS namespace on ESP32, file path elsewhere
+     * @return true if a valid table was loaded
+     */
+    bool load(const char* name);
+
+    /** @return number of cached derivations */
+    size_t size() const { return count; }
+
+    /** @return lookups answered from the cache (and re-verified) */
+    uint32_t getHits() const { return hits; }
+
+    /** @return lookups that needed a full bump search */
+    uint32_t getMisses() const { return misses; }
+
+private:
+    struct Entry {
+        uint8_t key[32];
+        uint8_t address[SOLDUINO_PUBKEY_SIZE];
+        uint8_t bump;
+        int16_t next;        // next entry in the same bucket, -1 = end
+        uint32_t lastUsed;   // LRU tick, 0 = free slot
+    };
+
+    Entry entries[SOLDUINO_PDA_CACHE_SIZE];
+    int16_t buckets[SOLDUINO_PDA_CACHE_SIZE];
+    size_t count;
+    uint32_t tick;
+    uint32_t hits;
+    uint32_t misses;
+    bool dirty;
+
+    int16_t lookup(const uint8_t key[32]) const;
+    void insert(const uint8_t key[32], const uint8_t* address, uint8_t bump);
+    void unlink(int16_t slot);
+    static size_t bucketOf(const uint8_t key[32]);
+};
+
+/**
+ * Self-test: checks isOnCurve() and findProgramAddress() against a corpus
+ * of known PDAs and edge-case points, and the multi-lane SHA-256 kernel
+ * against libsodium. Prints mismatches to Serial.
+ * @return true if every vector matches
+ */
+bool testProgramAddress();
+
 #endif // SOLDUINO_PROGRAMS_H
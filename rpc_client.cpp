@@ -1,17 +1,158 @@
 #include "rpc_client.h"
 #include "crypto.h"
 #include "transaction.h"
+#include "serializer.h"
+#include "lookup_table.h"
+
+#if SOLDUINO_RPC_THREADS
+#include "worker_pool.h"
+#endif
+
+// ============================================================================
+// Request writer
+// ============================================================================
+
+void RpcRequestWriter::write(const char* text) {
+    while (*text) put(*text++);
+}
+
+void RpcRequestWriter::begin(int id, const char* method) {
+    write("{\"jsonrpc\":\"2.0\",\"id\":");
+    writeInteger((int64_t)id);
+    write(",\"method\":");
+    writeString(method);
+    write(",\"params\":");
+}
+
+void RpcRequestWriter::rawParams(const char* json) {
+    write(json && *json ? json : "[]");
+}
+
+void RpcRequestWriter::separator() {
+    if (!first) put(',');
+    first = false;
+}
+
+void RpcRequestWriter::writeString(const char* value) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put('"');
+    for (const char* p = value ? value : ""; *p; p++) {
+        uint8_t c = (uint8_t)*p;
+        if (c == '"' || c == '\\') {
+            put('\\');
+            put((char)c);
+        } else if (c < 0x20) {
+            write("\\u00");
+            put(HEX_DIGITS[c >> 4]);
+            put(HEX_DIGITS[c & 0x0F]);
+        } else {
+            put((char)c);
+        }
+    }
+    put('"');
+}
+
+void RpcRequestWriter::writeInteger(uint64_t value) {
+    char digits[20];
+    uint8_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) put(digits[--n]);
+}
+
+void RpcRequestWriter::writeInteger(int64_t value) {
+    if (value < 0) {
+        put('-');
+        writeInteger((uint64_t)0 - (uint64_t)value);
+    } else {
+        writeInteger((uint64_t)value);
+    }
+}
+
+void RpcRequestWriter::param(const char* value) {
+    separator();
+    writeString(value);
+}
+
+void RpcRequestWriter::param(const RpcOptions& options) {
+    separator();
+    put('{');
+    bool any = false;
+    if (options.encoding) {
+        write("\"encoding\":");
+        writeString(options.encoding);
+        any = true;
+    }
+    if (options.maxSupportedTransactionVersion >= 0) {
+        if (any) put(',');
+        write("\"maxSupportedTransactionVersion\":");
+        writeInteger((int64_t)options.maxSupportedTransactionVersion);
+        any = true;
+    }
+    if (options.transactionDetails) {
+        if (any) put(',');
+        write("\"transactionDetails\":");
+        writeString(options.transactionDetails);
+        any = true;
+    }
+    if (options.noRewards) {
+        if (any) put(',');
+        write("\"rewards\":false");
+    }
+    put('}');
+}
+
+void RpcRequestWriter::param(const RpcField& field) {
+    separator();
+    put('{');
+    writeString(field.name);
+    put(':');
+    writeString(field.value);
+    put('}');
+}
+
+void RpcRequestWriter::param(const RpcStringArray& array) {
+    separator();
+    put('[');
+    for (size_t i = 0; i < array.count; i++) {
+        if (i > 0) put(',');
+        writeString(array.items[i].c_str());
+    }
+    put(']');
+}
+
+// ============================================================================
+// RpcClient
+// ============================================================================
 
 RpcClient::RpcClient(const String& endpoint)
-    : rpcEndpoint(endpoint), requestId(1), timeoutMs(10000), secureClient(nullptr), httpClient(nullptr) {
+    : rpcEndpoint(endpoint), port(0), secureClient(nullptr), sessionCache(nullptr), httpClient(nullptr),
+      keepAlive(true), connectionUsed(false), requestId(1), timeoutMs(10000), handshakeCount(0), reusedCount(0), resumedCount(0),
+      lastHandshakeUs(0), handshakeTimeUs(0), requestBuffer(nullptr), requestCapacity(0) {
     useSecure = endpoint.startsWith("https://");
 
     if (useSecure) {
-        secureClient = new WiFiClientSecure();
+        secureClient = new RpcSecureClient();
         secureClient->setInsecure();
     } else {
         httpClient = new WiFiClient();
     }
+
+    // scheme://host[:port][/path], for connect()
+    int hostStart = endpoint.indexOf("://");
+    hostStart = hostStart < 0 ? 0 : hostStart + 3;
+    int pathStart = endpoint.indexOf('/', hostStart);
+    String authority = pathStart < 0 ? endpoint.substring(hostStart) : endpoint.substring(hostStart, pathStart);
+    int colon = authority.indexOf(':');
+    if (colon >= 0) {
+        host = authority.substring(0, colon);
+        port = (uint16_t)authority.substring(colon + 1).toInt();
+    } else {
+        host = authority;
+        port = useSecure ? 443 : 80;
+    }
 }
 
 RpcClient::~RpcClient() {
@@ -24,6 +165,8 @@ RpcClient::~RpcClient() {
         delete httpClient;
         httpClient = nullptr;
     }
+    free(requestBuffer);
+    requestBuffer = nullptr;
 }
 
 bool RpcClient::begin() {
@@ -35,8 +178,10 @@ bool RpcClient::begin() {
 }
 
 void RpcClient::end() {
-    if (http.connected()) {
-        http.end();
+    waitForConnection();
+    http.end();
+    if (transport()) {
+        transport()->stop();
     }
 }
 
@@ -44,49 +189,159 @@ void RpcClient::setTimeout(int timeout) {
     timeoutMs = timeout;
 }
 
-String RpcClient::makeRpcRequest(const String& method, const String& params) {
-    if (WiFi.status() != WL_CONNECTED) {
-        logError("WiFi not connected");
-        return "";
+// ============================================================================
+// Connection
+// ============================================================================
+
+bool RpcClient::connect(bool background) {
+    waitForConnection();
+    if (!transport() || WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
+    if (transport()->connected()) {
+        return true;
     }
 
-    bool beginSuccess = false;
-    if (useSecure && secureClient) {
-        beginSuccess = http.begin(*secureClient, rpcEndpoint);
-    } else if (!useSecure && httpClient) {
-        beginSuccess = http.begin(*httpClient, rpcEndpoint);
+    handshakeCount++;
+#if SOLDUINO_RPC_THREADS
+    if (background) {
+        WorkerStack stack(SOLDUINO_RPC_CONNECT_STACK);
+        connector = std::thread(&RpcClient::openConnection, this);
+        return true;
     }
+#endif
+    return openConnection();
+}
 
-    if (!beginSuccess) {
-        logError("Failed to begin HTTP connection");
-        return "";
+bool RpcClient::openConnection() {
+    connectionUsed = false;
+    uint32_t start = micros();
+    bool ok = transport()->connect(host.c_str(), port) != 0;
+    lastHandshakeUs = micros() - start;
+    handshakeTimeUs += lastHandshakeUs;
+#if SOLDUINO_TLS_SESSIONS
+    if (ok && useSecure && secureClient->isResumed()) {
+        resumedCount++;
     }
+#endif
+    return ok;
+}
 
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(timeoutMs);
+void RpcClient::resetConnectionStats() {
+    handshakeCount = 0;
+    reusedCount = 0;
+    resumedCount = 0;
+    lastHandshakeUs = 0;
+    handshakeTimeUs = 0;
+}
 
-    DynamicJsonDocument requestDoc(2048);
-    requestDoc["jsonrpc"] = "2.0";
-    requestDoc["id"] = requestId++;
-    requestDoc["method"] = method;
+void RpcClient::setSessionCache(TlsSessionCache* cache) {
+    waitForConnection();
+    sessionCache = cache;
+#if SOLDUINO_TLS_SESSIONS
+    if (secureClient) {
+        secureClient->setSessionCache(cache);
+    }
+#endif
+}
 
-    if (params != "[]" && params.length() > 0) {
-        DynamicJsonDocument paramsDoc(1024);
-        deserializeJson(paramsDoc, params);
-        requestDoc["params"] = paramsDoc.as<JsonArray>();
-    } else {
-        requestDoc["params"] = JsonArray();
+void RpcClient::waitForConnection() {
+#if SOLDUINO_RPC_THREADS
+    if (connector.joinable()) {
+        connector.join();
     }
+#endif
+}
 
-    String requestBody;
-    serializeJson(requestDoc, requestBody);
+int RpcClient::post(const char* body, size_t length, String* response, RpcResponseReader reader, void* context) {
+    WiFiClient* client = transport();
+    if (!client) {
+        return 0;
+    }
+    waitForConnection();
+
+    for (uint8_t attempt = 0;; attempt++) {
+        // Connect here rather than inside HTTPClient so the handshake is
+        // timed (and resumed) the same way as connect(); HTTPClient then
+        // sends on the open connection. A live connection is used whatever
+        // keepAlive says: connect() may have just opened it
+        bool live = client->connected();
+        if (!live) {
+            client->stop();
+            handshakeCount++;
+            if (!openConnection()) {
+                return HTTPC_ERROR_CONNECTION_REFUSED;
+            }
+        }
 
-    int httpResponseCode = http.POST(requestBody);
-    String response = "";
+        if (!http.begin(*client, rpcEndpoint)) {
+            return 0;
+        }
+        http.setReuse(keepAlive);
+        http.addHeader("Content-Type", "application/json");
+        http.setTimeout(timeoutMs);
+        const char* headers[] = {"Transfer-Encoding"};
+        http.collectHeaders(headers, 1);
+
+        int code = http.POST((uint8_t*)body, length);
+        if (code < 0 && live && attempt == 0) {
+            // The server closed the idle connection under us
+            http.end();
+            client->stop();
+            continue;
+        }
+        // The first request on a connection paid for its handshake, even
+        // when connect() opened it ahead of time
+        if (live && connectionUsed) {
+            reusedCount++;
+        }
+        connectionUsed = true;
+        if (code == HTTP_CODE_OK && reader) {
+            RpcBodyStream stream(*client, http.getSize(),
+                                 http.header("Transfer-Encoding").equalsIgnoreCase("chunked"), timeoutMs);
+            reader(stream, context);
+            // A reader may stop early (a full buffer); only a short unread
+            // tail is worth reading to keep the connection
+            if (!stream.drain()) {
+                client->stop();
+            }
+        } else if (code == HTTP_CODE_OK && response) {
+            *response = http.getString();
+        }
 
-    if (httpResponseCode == HTTP_CODE_OK) {
-        response = http.getString();
-    } else {
+        // Leaves the connection open when keep-alive is on and the server
+        // did not ask to close it
+        http.end();
+        return code;
+    }
+}
+
+bool RpcClient::reserveRequest(size_t length) {
+    if (length <= requestCapacity) return true;
+
+    size_t capacity = max((size_t)SOLDUINO_RPC_REQUEST_SIZE, length);
+    char* grown = (char*)realloc(requestBuffer, capacity);
+    if (!grown) {
+        logError("Out of memory for a " + String((unsigned)length) + "-byte request");
+        return false;
+    }
+    requestBuffer = grown;
+    requestCapacity = capacity;
+    return true;
+}
+
+bool RpcClient::sendRequest(size_t length, String* response, RpcResponseReader reader, void* context) {
+    requestId++;
+    if (WiFi.status() != WL_CONNECTED) {
+        logError("WiFi not connected");
+        return false;
+    }
+
+    int httpResponseCode = post(requestBuffer, length, response, reader, context);
+
+    if (httpResponseCode == 0) {
+        logError("Failed to begin HTTP connection");
+    } else if (httpResponseCode != HTTP_CODE_OK) {
         logError("HTTP Error: " + String(httpResponseCode));
         if (httpResponseCode < 0) {
             String errorMsg = "Connection failed";
@@ -99,8 +354,7 @@ String RpcClient::makeRpcRequest(const String& method, const String& params) {
         }
     }
 
-    http.end();
-    return response;
+    return httpResponseCode == HTTP_CODE_OK;
 }
 
 bool RpcClient::extractResult(const String& response, DynamicJsonDocument& doc) {
@@ -126,19 +380,545 @@ void RpcClient::logError(const String& message) {
     Serial.println("[RPC_ERROR] " + message);
 }
 
+// ============================================================================
+// Result readers, shared by the parsers and RpcBatch
+// ============================================================================
+
+static bool readAccountInfo(JsonVariantConst value, AccountInfo& info) {
+    if (value.isNull()) return false;
+
+    info.owner = value["owner"].as<String>();
+    info.lamports = value["lamports"].as<uint64_t>();
+    info.data = value["data"][0].as<String>();
+    info.executable = value["executable"].as<bool>();
+    info.rentEpoch = value["rentEpoch"].as<uint64_t>();
+    return true;
+}
+
+static bool readBlockInfo(JsonVariantConst result, BlockInfo& info) {
+    if (result.isNull()) return false;
+
+    info.slot = result["parentSlot"].as<uint64_t>() + 1;
+    info.blockhash = result["blockhash"].as<String>();
+    info.previousBlockhash = result["previousBlockhash"].as<String>();
+    info.blockTime = result["blockTime"].as<uint64_t>();
+    // -1 when the block was requested without transactions
+    info.transactionCount = result["transactions"].isNull() ? -1 : (int)result["transactions"].size();
+    return true;
+}
+
+static bool readTokenAmount(JsonVariantConst value, TokenAmount& supply) {
+    if (value.isNull()) return false;
+
+    const char* amount = value["amount"].as<const char*>();
+    supply.amount = amount ? strtoull(amount, nullptr, 10) : 0;
+    supply.decimals = value["decimals"].as<uint8_t>();
+    supply.uiAmountString = value["uiAmountString"].as<String>();
+    return true;
+}
+
+static size_t readSignatureStatuses(JsonVariantConst value, SignatureStatus* buffer, size_t maxCount) {
+    JsonArrayConst arr = value.as<JsonArrayConst>();
+    if (arr.isNull()) return 0;
+
+    size_t n = 0;
+    for (JsonVariantConst entry : arr) {
+        if (n >= maxCount) break;
+        SignatureStatus& s = buffer[n++];
+        s.found = !entry.isNull();
+        s.slot = entry["slot"].as<uint64_t>();
+        s.confirmations = entry["confirmations"].isNull() ? -1 : entry["confirmations"].as<int32_t>();
+        s.confirmationStatus = s.found ? entry["confirmationStatus"].as<String>() : String();
+        s.error = s.found && !entry["err"].isNull() ? entry["err"].as<String>() : String();
+    }
+    return n;
+}
+
+// ============================================================================
+// Streaming response parsing
+// ============================================================================
+//
+// A response is read once, front to back, and never held whole. Object
+// results go through deserializeJson() with a Filter that keeps only the
+// fields their struct needs. Array results (program accounts, token
+// accounts, blocks, signature statuses) are walked by JsonScanner, which
+// hands each element to deserializeJson() on its own, so memory is bounded
+// by one element whatever the response size.
+//
+// The parsers are templated on the reader: RpcBodyStream straight off the
+// connection, StreamReader for any other Stream, StringReader for the
+// String overloads.
+
+namespace {
+
+struct StringReader {
+    const char* p;
+    const char* end;
+
+    explicit StringReader(const String& s) : p(s.c_str()), end(s.c_str() + s.length()) {}
+
+    int read() { return p < end ? (uint8_t)*p++ : -1; }
+    int peek() const { return p < end ? (uint8_t)*p : -1; }
+
+    size_t readBytes(char* buffer, size_t length) {
+        size_t n = min(length, (size_t)(end - p));
+        memcpy(buffer, p, n);
+        p += n;
+        return n;
+    }
+};
+
+// Stream::peek() does not wait for late bytes; this one waits as long as
+// readBytes() would
+struct StreamReader {
+    Stream& stream;
+
+    explicit StreamReader(Stream& stream) : stream(stream) {}
+
+    int peek() {
+        unsigned long start = millis();
+        int c;
+        while ((c = stream.peek()) < 0 && millis() - start < stream.getTimeout()) {
+            delay(1);
+        }
+        return c;
+    }
+    int read() { return peek() < 0 ? -1 : stream.read(); }
+    size_t readBytes(char* buffer, size_t length) { return stream.readBytes(buffer, length); }
+};
+
+template <typename Reader>
+class JsonScanner {
+public:
+    explicit JsonScanner(Reader& in) : in(in) {}
+
+    Reader& in;
+
+    /** Next non-space character, left unread */
+    int peek() {
+        int c;
+        while (isSpace(c = in.peek())) in.read();
+        return c;
+    }
+
+    bool expect(char c) {
+        if (peek() != c) return false;
+        in.read();
+        return true;
+    }
+
+    /**
+     * Step to the next member of the object being read: consumes "key":
+     * and leaves the value next. Returns false after the closing brace.
+     */
+    bool nextMember(char* key, size_t size) {
+        int c = peek();
+        if (c == ',') {
+            in.read();
+            c = peek();
+        }
+        if (c != '"') {
+            if (c == '}') in.read();
+            return false;
+        }
+        in.read();
+        return readString(key, size) && expect(':');
+    }
+
+    /** Step to the next element of the array being read; false after ']' */
+    bool nextElement() {
+        int c = peek();
+        if (c == ',') {
+            in.read();
+            c = peek();
+        }
+        if (c == ']') {
+            in.read();
+            return false;
+        }
+        return c >= 0;
+    }
+
+    /** Skip members up to the named one and leave its value next */
+    bool findMember(const char* name) {
+        char key[24];
+        while (nextMember(key, sizeof(key))) {
+            if (strcmp(key, name) == 0) return true;
+            if (!skipValue()) return false;
+        }
+        return false;
+    }
+
+    /**
+     * Read a string (without quotes), number or literal as text,
+     * truncated to size. deserializeJson() would swallow the delimiter
+     * after a bare number, so scalars are read here instead.
+     */
+    bool readScalar(char* out, size_t size) {
+        int c = peek();
+        if (c == '"') {
+            in.read();
+            return readString(out, size);
+        }
+        size_t n = 0;
+        while ((c = in.peek()) >= 0 && c != ',' && c != '}' && c != ']' && !isSpace(c)) {
+            in.read();
+            if (n + 1 < size) out[n++] = (char)c;
+        }
+        if (size) out[n] = '\0';
+        return c >= 0;
+    }
+
+    bool skipValue() {
+        int c = peek();
+        if (c != '{' && c != '[') return readScalar(nullptr, 0);
+
+        int depth = 0;
+        do {
+            c = in.read();
+            if (c < 0) return false;
+            if (c == '"') {
+                if (!readString(nullptr, 0)) return false;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+            }
+        } while (depth > 0);
+        return true;
+    }
+
+    /** Skip the envelope up to the "result" value; false on an error reply or null result */
+    bool openResult() {
+        return expect('{') && findMember("result") && peek() != 'n';
+    }
+
+private:
+    static bool isSpace(int c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    // Opening quote already consumed. Escapes are reduced to the escaped
+    // character, which is exact for the keys and values read here
+    bool readString(char* out, size_t size) {
+        size_t n = 0;
+        for (;;) {
+            int c = in.read();
+            if (c < 0) return false;
+            if (c == '"') break;
+            if (c == '\\') {
+                c = in.read();
+                if (c < 0) return false;
+            }
+            if (n + 1 < size) out[n++] = (char)c;
+        }
+        if (size) out[n] = '\0';
+        return true;
+    }
+};
+
+// Passes a reader through while following the nesting of what was read,
+// so a value deserializeJson() gave up on part way (too large for its
+// document) can be skipped to its end and the next one read
+template <typename Reader>
+class JsonTracker {
+public:
+    explicit JsonTracker(Reader& in) : in(in), depth(0), inString(false), escaped(false) {}
+
+    int read() {
+        int c = in.read();
+        if (c >= 0) track((char)c);
+        return c;
+    }
+
+    size_t readBytes(char* buffer, size_t length) {
+        size_t n = in.readBytes(buffer, length);
+        for (size_t i = 0; i < n; i++) track(buffer[i]);
+        return n;
+    }
+
+    /** Read up to the end of the value started; false if the input ends first */
+    bool finish() {
+        while (depth > 0 || inString) {
+            if (read() < 0) return false;
+        }
+        return true;
+    }
+
+private:
+    Reader& in;
+    int depth;
+    bool inString;
+    bool escaped;
+
+    void track(char c) {
+        if (inString) {
+            if (escaped) escaped = false;
+            else if (c == '\\') escaped = true;
+            else if (c == '"') inString = false;
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+    }
+};
+
+// Deserialize one array element (an object or array, never a bare
+// scalar). An element that fails is read to its end, leaving the next one
+// in place.
+template <typename Reader>
+bool readElement(Reader& in, JsonDocument& doc, JsonDocument& filter) {
+    JsonTracker<Reader> tracked(in);
+    if (!deserializeJson(doc, tracked, DeserializationOption::Filter(filter))) return true;
+    tracked.finish();
+    return false;
+}
+
+// Filters: what each result struct needs, everything else is dropped
+// while parsing
+const char ACCOUNT_INFO_FILTER[] =
+    "{\"result\":{\"value\":{\"owner\":true,\"lamports\":true,\"data\":[true],"
+    "\"executable\":true,\"rentEpoch\":true}}}";
+const char PROGRAM_ACCOUNT_FILTER[] =
+    "{\"pubkey\":true,\"account\":{\"owner\":true,\"lamports\":true,\"data\":[true],"
+    "\"executable\":true,\"rentEpoch\":true}}";
+const char TOKEN_ACCOUNT_FILTER[] =
+    "{\"pubkey\":true,\"account\":{\"data\":{\"parsed\":{\"info\":{\"mint\":true,\"owner\":true,"
+    "\"tokenAmount\":{\"amount\":true,\"decimals\":true}}}}}}";
+const char TRANSACTION_FILTER[] =
+    "{\"result\":{\"slot\":true,\"meta\":{\"status\":true,\"err\":true},\"transaction\":[true]}}";
+const char SIGNATURE_STATUS_FILTER[] =
+    "{\"slot\":true,\"confirmations\":true,\"confirmationStatus\":true,\"err\":true}";
+const char BATCH_REPLY_FILTER[] = "{\"id\":true,\"error\":{\"message\":true},\"result\":true}";
+
+typedef StaticJsonDocument<512> FilterDocument;
+
+template <typename Reader>
+bool streamAccountInfo(Reader& in, AccountInfo& info) {
+    FilterDocument filter;
+    deserializeJson(filter, ACCOUNT_INFO_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_ACCOUNT_DOC_SIZE);
+    if (deserializeJson(doc, in, DeserializationOption::Filter(filter))) return false;
+    return readAccountInfo(doc["result"]["value"], info);
+}
+
+template <typename Reader>
+bool streamTransaction(Reader& in, TransactionResponse& tx) {
+    FilterDocument filter;
+    deserializeJson(filter, TRANSACTION_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_TRANSACTION_DOC_SIZE);
+    if (deserializeJson(doc, in, DeserializationOption::Filter(filter))) return false;
+
+    JsonVariantConst result = doc["result"];
+    if (result.isNull()) return false;
+
+    tx.slot = result["slot"].as<int>();
+    tx.status = result["meta"]["status"].as<String>();
+    tx.error = result["meta"]["err"].isNull() ? String() : result["meta"]["err"].as<String>();
+
+    // base64 encoding returns [data, "base64"]
+    tx.transaction = result["transaction"][0].as<String>();
+    return true;
+}
+
+// Transactions are counted, never parsed
+template <typename Reader>
+bool streamBlockInfo(Reader& in, BlockInfo& info) {
+    JsonScanner<Reader> scan(in);
+    if (!scan.openResult() || !scan.expect('{')) return false;
+
+    info.slot = 0;
+    info.blockhash = "";
+    info.previousBlockhash = "";
+    info.blockTime = 0;
+    info.transactionCount = 0;
+
+    char key[24];
+    char text[96];
+    while (scan.nextMember(key, sizeof(key))) {
+        bool ok;
+        if (strcmp(key, "transactions") == 0) {
+            ok = scan.expect('[');
+            while (ok && scan.nextElement()) {
+                ok = scan.skipValue();
+                info.transactionCount++;
+            }
+        } else if (strcmp(key, "parentSlot") == 0 && (ok = scan.readScalar(text, sizeof(text)))) {
+            info.slot = strtoull(text, nullptr, 10) + 1;
+        } else if (strcmp(key, "blockTime") == 0 && (ok = scan.readScalar(text, sizeof(text)))) {
+            info.blockTime = strtoull(text, nullptr, 10);
+        } else if (strcmp(key, "blockhash") == 0 && (ok = scan.readScalar(text, sizeof(text)))) {
+            info.blockhash = text;
+        } else if (strcmp(key, "previousBlockhash") == 0 && (ok = scan.readScalar(text, sizeof(text)))) {
+            info.previousBlockhash = text;
+        } else {
+            ok = scan.skipValue();
+        }
+        if (!ok) return false;
+    }
+    return info.blockhash.length() > 0;
+}
+
+// The list parsers skip an element that does not fit its document (an
+// account with more data than SOLDUINO_RPC_ACCOUNT_DOC_SIZE holds) and go
+// on with the next, counting it in *skipped
+template <typename Reader>
+size_t streamProgramAccounts(Reader& in, ProgramAccount* buffer, size_t maxCount, size_t* skipped = nullptr) {
+    JsonScanner<Reader> scan(in);
+    if (!scan.openResult() || !scan.expect('[')) return 0;
+
+    FilterDocument filter;
+    deserializeJson(filter, PROGRAM_ACCOUNT_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_ACCOUNT_DOC_SIZE);
+
+    size_t n = 0;
+    while (n < maxCount && scan.nextElement()) {
+        if (!readElement(in, doc, filter)) {
+            if (skipped) (*skipped)++;
+            continue;
+        }
+        ProgramAccount& p = buffer[n];
+        p.pubkey = doc["pubkey"].as<String>();
+        if (readAccountInfo(doc["account"], p.account)) n++;
+    }
+    return n;
+}
+
+template <typename Reader>
+size_t streamTokenAccounts(Reader& in, TokenAccount* buffer, size_t maxCount, size_t* skipped = nullptr) {
+    JsonScanner<Reader> scan(in);
+    if (!scan.openResult() || !scan.expect('{') || !scan.findMember("value") || !scan.expect('[')) return 0;
+
+    FilterDocument filter;
+    deserializeJson(filter, TOKEN_ACCOUNT_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_ITEM_DOC_SIZE);
+
+    size_t n = 0;
+    while (n < maxCount && scan.nextElement()) {
+        if (!readElement(in, doc, filter)) {
+            if (skipped) (*skipped)++;
+            continue;
+        }
+        TokenAccount& t = buffer[n++];
+        t.pubkey = doc["pubkey"].as<String>();
+        JsonVariantConst parsed = doc["account"]["data"]["parsed"]["info"];
+        t.mint = parsed["mint"].as<String>();
+        t.owner = parsed["owner"].as<String>();
+        const char* amount = parsed["tokenAmount"]["amount"].as<const char*>();
+        t.amount = amount ? strtoull(amount, nullptr, 10) : 0;
+        t.decimals = parsed["tokenAmount"]["decimals"].as<uint8_t>();
+    }
+    return n;
+}
+
+template <typename Reader>
+size_t streamSignatureStatuses(Reader& in, SignatureStatus* buffer, size_t maxCount, size_t* skipped = nullptr) {
+    JsonScanner<Reader> scan(in);
+    if (!scan.openResult() || !scan.expect('{') || !scan.findMember("value") || !scan.expect('[')) return 0;
+
+    FilterDocument filter;
+    deserializeJson(filter, SIGNATURE_STATUS_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_ITEM_DOC_SIZE);
+
+    size_t n = 0;
+    while (n < maxCount && scan.nextElement()) {
+        SignatureStatus& s = buffer[n];
+        if (scan.peek() == 'n') {
+            if (!scan.skipValue()) break;
+            s.found = false;
+            s.slot = 0;
+            s.confirmations = -1;
+            s.confirmationStatus = "";
+            s.error = "";
+        } else {
+            if (!readElement(in, doc, filter)) {
+                // Keep the statuses in step with the signatures
+                if (skipped) (*skipped)++;
+                s.found = false;
+                s.slot = 0;
+                s.confirmations = -1;
+                s.confirmationStatus = "";
+                s.error = "";
+                n++;
+                continue;
+            }
+            s.found = true;
+            s.slot = doc["slot"].as<uint64_t>();
+            s.confirmations = doc["confirmations"].isNull() ? -1 : doc["confirmations"].as<int32_t>();
+            s.confirmationStatus = doc["confirmationStatus"].as<String>();
+            s.error = doc["err"].isNull() ? String() : doc["err"].as<String>();
+        }
+        n++;
+    }
+    return n;
+}
+
+template <typename Reader>
+size_t streamBlocks(Reader& in, uint64_t* buffer, size_t maxCount) {
+    JsonScanner<Reader> scan(in);
+    if (!scan.openResult() || !scan.expect('[')) return 0;
+
+    char text[24];
+    size_t n = 0;
+    while (n < maxCount && scan.nextElement() && scan.readScalar(text, sizeof(text))) {
+        buffer[n++] = strtoull(text, nullptr, 10);
+    }
+    return n;
+}
+
+// Reader contexts for RpcClient::streamRpcRequest()
+template <typename T>
+struct ItemRead {
+    T* out;
+    bool ok;
+};
+
+template <typename T>
+struct ListRead {
+    T* buffer;
+    size_t maxCount;
+    size_t count;
+    size_t skipped;
+};
+
+} // namespace
+
 // ============================================================================
 // Balances / chain state
 // ============================================================================
 
 bool RpcClient::getAccountInfo(const String& publicKey, AccountInfo& info) {
-    String params = "[\"" + publicKey + "\", {\"encoding\": \"base64\"}]";
-    String response = makeRpcRequest("getAccountInfo", params);
-    return parseAccountInfo(response, info);
+    ItemRead<AccountInfo> read = { &info, false };
+    streamRpcRequest("getAccountInfo", [](RpcBodyStream& body, void* context) {
+        ItemRead<AccountInfo>* r = (ItemRead<AccountInfo>*)context;
+        r->ok = streamAccountInfo(body, *r->out);
+    }, &read, publicKey, RpcOptions{"base64", -1});
+    return read.ok;
+}
+
+bool RpcClient::getAddressLookupTable(const String& address, AddressLookupTable& table, bool refresh) {
+    uint8_t key[SOLDUINO_PUBKEY_SIZE];
+    if (!addressToPublicKey(address.c_str(), key)) return false;
+    if (!refresh && table.isLoaded() && memcmp(table.getKey(), key, SOLDUINO_PUBKEY_SIZE) == 0) {
+        return true;
+    }
+
+    AccountInfo info;
+    if (!getAccountInfo(address, info) || info.owner != SOLDUINO_ALT_PROGRAM_ID) return false;
+
+    size_t maxLen = (info.data.length() / 4) * 3;
+    if (maxLen < SOLDUINO_ALT_META_SIZE) return false;
+    uint8_t* data = (uint8_t*)malloc(maxLen);
+    if (!data) return false;
+    size_t len = Base64::decode(info.data.c_str(), data, maxLen);
+    bool ok = table.load(key, data, len);
+    free(data);
+    return ok;
 }
 
 uint64_t RpcClient::getBalanceLamports(const String& publicKey) {
-    String params = "[\"" + publicKey + "\"]";
-    String response = makeRpcRequest("getBalance", params);
+    String response = makeRpcRequest("getBalance", publicKey);
 
     DynamicJsonDocument doc(512);
     if (!extractResult(response, doc)) return 0;
@@ -148,8 +928,7 @@ uint64_t RpcClient::getBalanceLamports(const String& publicKey) {
 }
 
 float RpcClient::getBalance(const String& publicKey) {
-    String params = "[\"" + publicKey + "\"]";
-    String response = makeRpcRequest("getBalance", params);
+    String response = makeRpcRequest("getBalance", publicKey);
 
     DynamicJsonDocument doc(512);
     if (!extractResult(response, doc)) return -1.0f;
@@ -201,8 +980,7 @@ bool RpcClient::getHealth() {
 // ============================================================================
 
 String RpcClient::sendTransaction(const String& transaction) {
-    String params = "[\"" + transaction + "\", {\"encoding\": \"base64\"}]";
-    String response = makeRpcRequest("sendTransaction", params);
+    String response = makeRpcRequest("sendTransaction", transaction, RpcOptions{"base64", -1});
 
     DynamicJsonDocument doc(1024);
     if (!extractResult(response, doc)) return "";
@@ -210,28 +988,73 @@ String RpcClient::sendTransaction(const String& transaction) {
 }
 
 String RpcClient::sendTransactionBase58(const String& transaction) {
-    String params = "[\"" + transaction + "\", {\"encoding\": \"base58\"}]";
-    String response = makeRpcRequest("sendTransaction", params);
+    String response = makeRpcRequest("sendTransaction", transaction, RpcOptions{"base58", -1});
 
     DynamicJsonDocument doc(1024);
     if (!extractResult(response, doc)) return "";
     return doc["result"].as<String>();
 }
 
-bool RpcClient::getTransaction(const String& signature, TransactionResponse& tx) {
-    String params = "[\"" + signature + "\", {\"encoding\": \"base64\"}]";
-    String response = makeRpcRequest("getTransaction", params);
+static void readTransactionBody(RpcBodyStream& body, void* context) {
+    ItemRead<TransactionResponse>* r = (ItemRead<TransactionResponse>*)context;
+    r->ok = streamTransaction(body, *r->out);
+}
 
+bool RpcClient::getTransaction(const String& signature, TransactionResponse& tx) {
     tx.signature = signature;
-    return parseTransaction(response, tx);
+    ItemRead<TransactionResponse> read = { &tx, false };
+    streamRpcRequest("getTransaction", readTransactionBody, &read, signature, RpcOptions{"base64", 0});
+    return read.ok;
 }
 
 bool RpcClient::getConfirmedTransaction(const String& signature, TransactionResponse& tx) {
-    String params = "[\"" + signature + "\", {\"encoding\": \"base64\"}]";
-    String response = makeRpcRequest("getConfirmedTransaction", params);
-
     tx.signature = signature;
-    return parseTransaction(response, tx);
+    ItemRead<TransactionResponse> read = { &tx, false };
+    streamRpcRequest("getConfirmedTransaction", readTransactionBody, &read, signature, RpcOptions{"base64", -1});
+    return read.ok;
+}
+
+size_t RpcClient::getSignatureStatuses(const String signatures[], size_t count, SignatureStatus* statuses) {
+    if (!signatures || !statuses || count == 0) return 0;
+
+    ListRead<SignatureStatus> read = { statuses, count, 0, 0 };
+    streamRpcRequest("getSignatureStatuses", [](RpcBodyStream& body, void* context) {
+        ListRead<SignatureStatus>* r = (ListRead<SignatureStatus>*)context;
+        r->count = streamSignatureStatuses(body, r->buffer, r->maxCount, &r->skipped);
+    }, &read, RpcStringArray{signatures, count});
+    if (read.skipped) logError(String((unsigned)read.skipped) + " statuses too large to parse, skipped");
+    return read.count;
+}
+
+bool RpcClient::send(RpcBatch& batch) {
+    if (batch.size() == 0) return true;
+    if (WiFi.status() != WL_CONNECTED) {
+        logError("WiFi not connected");
+        return false;
+    }
+
+    RpcRequestWriter measure(nullptr, 0);
+    batch.write(measure);
+    if (!reserveRequest(measure.length())) return false;
+
+    RpcRequestWriter writer(requestBuffer, requestCapacity);
+    batch.write(writer);
+
+    // Replies are read off the connection one at a time
+    ItemRead<RpcBatch> read = { &batch, false };
+    int httpResponseCode = post(requestBuffer, writer.length(), nullptr, [](RpcBodyStream& body, void* context) {
+        ItemRead<RpcBatch>* r = (ItemRead<RpcBatch>*)context;
+        r->ok = r->out->readResponse(body);
+    }, &read);
+    if (httpResponseCode != HTTP_CODE_OK) {
+        logError("HTTP Error: " + String(httpResponseCode));
+        return false;
+    }
+    if (!read.ok) {
+        logError("Invalid batch response");
+        return false;
+    }
+    return true;
 }
 
 // ============================================================================
@@ -239,28 +1062,33 @@ bool RpcClient::getConfirmedTransaction(const String& signature, TransactionResp
 // ============================================================================
 
 bool RpcClient::getBlock(uint64_t slot, BlockInfo& info) {
-    String params = "[" + String(slot) + ", {\"encoding\": \"base64\", \"maxSupportedTransactionVersion\": 0}]";
-    String response = makeRpcRequest("getBlock", params);
-    return parseBlockInfo(response, info);
+    ItemRead<BlockInfo> read = { &info, false };
+    streamRpcRequest("getBlock", [](RpcBodyStream& body, void* context) {
+        ItemRead<BlockInfo>* r = (ItemRead<BlockInfo>*)context;
+        r->ok = streamBlockInfo(body, *r->out);
+    }, &read, slot, RpcOptions{"base64", 0});
+    return read.ok;
 }
 
 bool RpcClient::getBlockCommitment(uint64_t slot, BlockCommitment& commitment) {
-    String params = "[" + String(slot) + "]";
-    String response = makeRpcRequest("getBlockCommitment", params);
+    String response = makeRpcRequest("getBlockCommitment", slot);
     return parseBlockCommitment(response, commitment);
 }
 
 size_t RpcClient::getBlocks(uint64_t startSlot, uint64_t endSlot, uint64_t* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
 
-    String params;
+    ListRead<uint64_t> read = { buffer, maxCount, 0 };
+    RpcResponseReader reader = [](RpcBodyStream& body, void* context) {
+        ListRead<uint64_t>* r = (ListRead<uint64_t>*)context;
+        r->count = streamBlocks(body, r->buffer, r->maxCount);
+    };
     if (endSlot > 0) {
-        params = "[" + String(startSlot) + ", " + String(endSlot) + "]";
+        streamRpcRequest("getBlocks", reader, &read, startSlot, endSlot);
     } else {
-        params = "[" + String(startSlot) + "]";
+        streamRpcRequest("getBlocks", reader, &read, startSlot);
     }
-    String response = makeRpcRequest("getBlocks", params);
-    return parseBlocks(response, buffer, maxCount);
+    return read.count;
 }
 
 // ============================================================================
@@ -270,27 +1098,31 @@ size_t RpcClient::getBlocks(uint64_t startSlot, uint64_t endSlot, uint64_t* buff
 size_t RpcClient::getProgramAccounts(const String& programId, ProgramAccount* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
 
-    String params = "[\"" + programId + "\", {\"encoding\": \"base64\"}]";
-    String response = makeRpcRequest("getProgramAccounts", params);
-    return parseProgramAccounts(response, buffer, maxCount);
+    ListRead<ProgramAccount> read = { buffer, maxCount, 0, 0 };
+    streamRpcRequest("getProgramAccounts", [](RpcBodyStream& body, void* context) {
+        ListRead<ProgramAccount>* r = (ListRead<ProgramAccount>*)context;
+        r->count = streamProgramAccounts(body, r->buffer, r->maxCount, &r->skipped);
+    }, &read, programId, RpcOptions{"base64", -1});
+    if (read.skipped) logError(String((unsigned)read.skipped) + " accounts too large to parse, skipped");
+    return read.count;
 }
 
 size_t RpcClient::getTokenAccountsByOwner(const String& owner, const String& mint, TokenAccount* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
 
-    String params;
-    if (mint.length() > 0) {
-        params = "[\"" + owner + "\", {\"mint\": \"" + mint + "\"}, {\"encoding\": \"jsonParsed\"}]";
-    } else {
-        params = "[\"" + owner + "\", {\"programId\": \"TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA\"}, {\"encoding\": \"jsonParsed\"}]";
-    }
-    String response = makeRpcRequest("getTokenAccountsByOwner", params);
-    return parseTokenAccounts(response, buffer, maxCount);
+    RpcField filter = mint.length() > 0 ? RpcField{"mint", mint.c_str()}
+                                        : RpcField{"programId", "TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA"};
+    ListRead<TokenAccount> read = { buffer, maxCount, 0, 0 };
+    streamRpcRequest("getTokenAccountsByOwner", [](RpcBodyStream& body, void* context) {
+        ListRead<TokenAccount>* r = (ListRead<TokenAccount>*)context;
+        r->count = streamTokenAccounts(body, r->buffer, r->maxCount, &r->skipped);
+    }, &read, owner, filter, RpcOptions{"jsonParsed", -1});
+    if (read.skipped) logError(String((unsigned)read.skipped) + " token accounts too large to parse, skipped");
+    return read.count;
 }
 
 bool RpcClient::getTokenSupply(const String& mint, TokenAmount& supply) {
-    String params = "[\"" + mint + "\"]";
-    String response = makeRpcRequest("getTokenSupply", params);
+    String response = makeRpcRequest("getTokenSupply", mint);
     return parseTokenAmount(response, supply);
 }
 
@@ -323,8 +1155,7 @@ bool RpcClient::getLatestBlockhashBytes(uint8_t* blockhash) {
 }
 
 uint64_t RpcClient::getMinimumBalanceForRentExemption(size_t dataSize) {
-    String params = "[" + String(dataSize) + "]";
-    String response = makeRpcRequest("getMinimumBalanceForRentExemption", params);
+    String response = makeRpcRequest("getMinimumBalanceForRentExemption", dataSize);
 
     DynamicJsonDocument doc(512);
     if (!extractResult(response, doc)) return 0;
@@ -332,8 +1163,7 @@ uint64_t RpcClient::getMinimumBalanceForRentExemption(size_t dataSize) {
 }
 
 uint64_t RpcClient::getFeeForMessage(const String& message) {
-    String params = "[\"" + message + "\"]";
-    String response = makeRpcRequest("getFeeForMessage", params);
+    String response = makeRpcRequest("getFeeForMessage", message);
 
     DynamicJsonDocument doc(512);
     if (!extractResult(response, doc)) return 0;
@@ -344,9 +1174,14 @@ uint64_t RpcClient::getFeeForMessage(const String& message) {
     return 0;
 }
 
+uint64_t RpcClient::getFeeForMessage(const MessageBase& message) {
+    char encoded[((MAX_MESSAGE_SIZE + 2) / 3) * 4 + 1];
+    if (!TransactionSerializer::encodeMessage(message, encoded, sizeof(encoded))) return 0;
+    return getFeeForMessage(String(encoded));
+}
+
 String RpcClient::requestAirdrop(const String& publicKey, uint64_t lamports) {
-    String params = "[\"" + publicKey + "\", " + String(lamports) + "]";
-    String response = makeRpcRequest("requestAirdrop", params);
+    String response = makeRpcRequest("requestAirdrop", publicKey, lamports);
 
     DynamicJsonDocument doc(1024);
     if (!extractResult(response, doc)) return "";
@@ -354,7 +1189,20 @@ String RpcClient::requestAirdrop(const String& publicKey, uint64_t lamports) {
 }
 
 String RpcClient::callRpc(const String& method, const String& params) {
-    return makeRpcRequest(method, params);
+    RpcRequestWriter measure(nullptr, 0);
+    measure.begin(requestId, method.c_str());
+    measure.rawParams(params.c_str());
+    measure.end();
+    if (!reserveRequest(measure.length())) return "";
+
+    RpcRequestWriter writer(requestBuffer, requestCapacity);
+    writer.begin(requestId, method.c_str());
+    writer.rawParams(params.c_str());
+    writer.end();
+
+    String response;
+    sendRequest(writer.length(), &response, nullptr, nullptr);
+    return response;
 }
 
 // ============================================================================
@@ -362,19 +1210,13 @@ String RpcClient::callRpc(const String& method, const String& params) {
 // ============================================================================
 
 bool parseAccountInfo(const String& jsonResponse, AccountInfo& info) {
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return false;
-
-    JsonObject result = doc["result"]["value"];
-    if (result.isNull()) return false;
+    StringReader in(jsonResponse);
+    return streamAccountInfo(in, info);
+}
 
-    info.owner = result["owner"].as<String>();
-    info.lamports = result["lamports"].as<uint64_t>();
-    info.data = result["data"][0].as<String>();
-    info.executable = result["executable"].as<bool>();
-    info.rentEpoch = result["rentEpoch"].as<uint64_t>();
-    return true;
+bool parseAccountInfo(Stream& body, AccountInfo& info) {
+    StreamReader in(body);
+    return streamAccountInfo(in, info);
 }
 
 bool parseBalance(const String& jsonResponse, Balance& balance) {
@@ -388,34 +1230,23 @@ bool parseBalance(const String& jsonResponse, Balance& balance) {
 }
 
 bool parseBlockInfo(const String& jsonResponse, BlockInfo& info) {
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return false;
+    StringReader in(jsonResponse);
+    return streamBlockInfo(in, info);
+}
 
-    JsonObject result = doc["result"];
-    info.slot = result["parentSlot"].as<uint64_t>() + 1;
-    info.blockhash = result["blockhash"].as<String>();
-    info.previousBlockhash = result["previousBlockhash"].as<String>();
-    info.blockTime = result["blockTime"].as<uint64_t>();
-    info.transactionCount = result["transactions"].size();
-    return true;
+bool parseBlockInfo(Stream& body, BlockInfo& info) {
+    StreamReader in(body);
+    return streamBlockInfo(in, info);
 }
 
 bool parseTransaction(const String& jsonResponse, TransactionResponse& tx) {
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return false;
-
-    JsonObject result = doc["result"];
-    tx.slot = result["slot"].as<int>();
-    tx.status = result["meta"]["status"].as<String>();
+    StringReader in(jsonResponse);
+    return streamTransaction(in, tx);
+}
 
-    if (result["meta"].containsKey("err") && !result["meta"]["err"].isNull()) {
-        tx.error = result["meta"]["err"].as<String>();
-    } else {
-        tx.error = "";
-    }
-    return true;
+bool parseTransaction(Stream& body, TransactionResponse& tx) {
+    StreamReader in(body);
+    return streamTransaction(in, tx);
 }
 
 bool parseTokenAmount(const String& jsonResponse, TokenAmount& supply) {
@@ -423,65 +1254,31 @@ bool parseTokenAmount(const String& jsonResponse, TokenAmount& supply) {
     DeserializationError error = deserializeJson(doc, jsonResponse);
     if (error || !doc.containsKey("result") || doc["result"].isNull()) return false;
 
-    JsonObject value = doc["result"]["value"];
-    if (value.isNull()) return false;
-
-    supply.amount = strtoull(value["amount"].as<const char*>(), nullptr, 10);
-    supply.decimals = value["decimals"].as<uint8_t>();
-    supply.uiAmountString = value["uiAmountString"].as<String>();
-    return true;
+    return readTokenAmount(doc["result"]["value"], supply);
 }
 
 size_t parseTokenAccounts(const String& jsonResponse, TokenAccount* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
+    StringReader in(jsonResponse);
+    return streamTokenAccounts(in, buffer, maxCount);
+}
 
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return 0;
-
-    JsonArray arr = doc["result"]["value"];
-    if (arr.isNull()) return 0;
-
-    size_t n = 0;
-    for (JsonObject entry : arr) {
-        if (n >= maxCount) break;
-        TokenAccount& t = buffer[n];
-        t.pubkey = entry["pubkey"].as<String>();
-        JsonObject parsed = entry["account"]["data"]["parsed"]["info"];
-        t.mint = parsed["mint"].as<String>();
-        t.owner = parsed["owner"].as<String>();
-        JsonObject amt = parsed["tokenAmount"];
-        t.amount = strtoull(amt["amount"].as<const char*>(), nullptr, 10);
-        t.decimals = amt["decimals"].as<uint8_t>();
-        n++;
-    }
-    return n;
+size_t parseTokenAccounts(Stream& body, TokenAccount* buffer, size_t maxCount) {
+    if (!buffer || maxCount == 0) return 0;
+    StreamReader in(body);
+    return streamTokenAccounts(in, buffer, maxCount);
 }
 
 size_t parseProgramAccounts(const String& jsonResponse, ProgramAccount* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
+    StringReader in(jsonResponse);
+    return streamProgramAccounts(in, buffer, maxCount);
+}
 
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return 0;
-
-    JsonArray arr = doc["result"];
-    if (arr.isNull()) return 0;
-
-    size_t n = 0;
-    for (JsonObject entry : arr) {
-        if (n >= maxCount) break;
-        ProgramAccount& p = buffer[n];
-        p.pubkey = entry["pubkey"].as<String>();
-        JsonObject acc = entry["account"];
-        p.account.owner = acc["owner"].as<String>();
-        p.account.lamports = acc["lamports"].as<uint64_t>();
-        p.account.data = acc["data"][0].as<String>();
-        p.account.executable = acc["executable"].as<bool>();
-        p.account.rentEpoch = acc["rentEpoch"].as<uint64_t>();
-        n++;
-    }
-    return n;
+size_t parseProgramAccounts(Stream& body, ProgramAccount* buffer, size_t maxCount) {
+    if (!buffer || maxCount == 0) return 0;
+    StreamReader in(body);
+    return streamProgramAccounts(in, buffer, maxCount);
 }
 
 bool parseBlockCommitment(const String& jsonResponse, BlockCommitment& commitment) {
@@ -507,18 +1304,277 @@ bool parseBlockCommitment(const String& jsonResponse, BlockCommitment& commitmen
 
 size_t parseBlocks(const String& jsonResponse, uint64_t* buffer, size_t maxCount) {
     if (!buffer || maxCount == 0) return 0;
+    StringReader in(jsonResponse);
+    return streamBlocks(in, buffer, maxCount);
+}
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, jsonResponse);
-    if (error || !doc.containsKey("result") || doc["result"].isNull()) return 0;
+size_t parseBlocks(Stream& body, uint64_t* buffer, size_t maxCount) {
+    if (!buffer || maxCount == 0) return 0;
+    StreamReader in(body);
+    return streamBlocks(in, buffer, maxCount);
+}
 
-    JsonArray arr = doc["result"];
-    if (arr.isNull()) return 0;
+size_t parseSignatureStatuses(const String& jsonResponse, SignatureStatus* buffer, size_t maxCount) {
+    if (!buffer || maxCount == 0) return 0;
+    StringReader in(jsonResponse);
+    return streamSignatureStatuses(in, buffer, maxCount);
+}
+
+size_t parseSignatureStatuses(Stream& body, SignatureStatus* buffer, size_t maxCount) {
+    if (!buffer || maxCount == 0) return 0;
+    StreamReader in(body);
+    return streamSignatureStatuses(in, buffer, maxCount);
+}
+
+// ============================================================================
+// RpcBatch
+// ============================================================================
+
+RpcBatch::RpcBatch() : count(0) {}
+
+RpcBatch::Call* RpcBatch::add(CallType type, const char* method, const String& key) {
+    if (count >= SOLDUINO_RPC_BATCH_MAX) return nullptr;
+
+    Call& call = calls[count];
+    call.type = type;
+    call.done = false;
+    call.outCount = 0;
+    call.method = method;
+    call.rawMethod = "";
+    call.key = key;
+    call.slot = 0;
+    call.signatures = nullptr;
+    call.error = "";
+    return &call;
+}
+
+int RpcBatch::getBalance(const String& publicKey, uint64_t& lamports) {
+    Call* call = add(CALL_BALANCE, "getBalance", publicKey);
+    if (!call) return -1;
+    call->out.u64 = &lamports;
+    return (int)count++;
+}
+
+int RpcBatch::getAccountInfo(const String& publicKey, AccountInfo& info) {
+    Call* call = add(CALL_ACCOUNT_INFO, "getAccountInfo", publicKey);
+    if (!call) return -1;
+    call->out.account = &info;
+    return (int)count++;
+}
+
+int RpcBatch::getSignatureStatuses(const String signatures[], size_t n, SignatureStatus* statuses) {
+    if (!signatures || !statuses || n == 0) return -1;
+    Call* call = add(CALL_SIGNATURE_STATUSES, "getSignatureStatuses", String());
+    if (!call) return -1;
+    call->signatures = signatures;
+    call->out.statuses = statuses;
+    call->outCount = n;
+    return (int)count++;
+}
+
+int RpcBatch::getTokenSupply(const String& mint, TokenAmount& supply) {
+    Call* call = add(CALL_TOKEN_SUPPLY, "getTokenSupply", mint);
+    if (!call) return -1;
+    call->out.tokenAmount = &supply;
+    return (int)count++;
+}
+
+int RpcBatch::getBlock(uint64_t slot, BlockInfo& info) {
+    Call* call = add(CALL_BLOCK, "getBlock", String());
+    if (!call) return -1;
+    call->slot = slot;
+    call->out.block = &info;
+    return (int)count++;
+}
+
+int RpcBatch::getLatestBlockhash(String& blockhash) {
+    Call* call = add(CALL_BLOCKHASH, "getLatestBlockhash", String());
+    if (!call) return -1;
+    call->out.text = &blockhash;
+    return (int)count++;
+}
+
+int RpcBatch::getSlot(uint64_t& slot) {
+    Call* call = add(CALL_U64, "getSlot", String());
+    if (!call) return -1;
+    call->out.u64 = &slot;
+    return (int)count++;
+}
+
+int RpcBatch::getBlockHeight(uint64_t& height) {
+    Call* call = add(CALL_U64, "getBlockHeight", String());
+    if (!call) return -1;
+    call->out.u64 = &height;
+    return (int)count++;
+}
+
+int RpcBatch::callRpc(const String& method, const String& params, String& result) {
+    Call* call = add(CALL_RAW, nullptr, params.length() > 0 ? params : String("[]"));
+    if (!call) return -1;
+    call->rawMethod = method;
+    call->out.text = &result;
+    return (int)count++;
+}
+
+void RpcBatch::clear() {
+    for (size_t i = 0; i < count; i++) {
+        calls[i].rawMethod = "";
+        calls[i].key = "";
+        calls[i].signatures = nullptr;
+        calls[i].error = "";
+    }
+    count = 0;
+}
+
+bool RpcBatch::ok(int index) const {
+    return index >= 0 && (size_t)index < count && calls[index].done;
+}
+
+String RpcBatch::getError(int index) const {
+    if (index < 0 || (size_t)index >= count) return "";
+    return calls[index].error;
+}
 
+size_t RpcBatch::getCompleted() const {
     size_t n = 0;
-    for (JsonVariant v : arr) {
-        if (n >= maxCount) break;
-        buffer[n++] = v.as<uint64_t>();
+    for (size_t i = 0; i < count; i++) {
+        if (calls[i].done) n++;
     }
     return n;
 }
+
+// Each call's id is its index, which is all the demultiplexing needs
+void RpcBatch::write(RpcRequestWriter& writer) {
+    writer.write("[");
+    for (size_t i = 0; i < count; i++) {
+        Call& call = calls[i];
+        call.done = false;
+        call.error = "";
+        if (i > 0) writer.write(",");
+        writer.begin((int)i, call.type == CALL_RAW ? call.rawMethod.c_str() : call.method);
+        switch (call.type) {
+        case CALL_BALANCE:
+        case CALL_TOKEN_SUPPLY:
+            writer.params(call.key);
+            break;
+        case CALL_ACCOUNT_INFO:
+            writer.params(call.key, RpcOptions{"base64", -1});
+            break;
+        case CALL_SIGNATURE_STATUSES:
+            writer.params(RpcStringArray{call.signatures, call.outCount});
+            break;
+        case CALL_BLOCK:
+            // The header is all BlockInfo keeps; transactions would make
+            // each reply megabytes
+            writer.params(call.slot, RpcOptions{nullptr, -1, "none", true});
+            break;
+        case CALL_RAW:
+            writer.rawParams(call.key.c_str());
+            break;
+        default:
+            writer.params();
+            break;
+        }
+        writer.end();
+    }
+    writer.write("]");
+}
+
+void RpcBatch::complete(Call& call, JsonVariantConst reply) {
+    if (!reply["error"].isNull()) {
+        call.error = reply["error"]["message"].as<String>();
+        return;
+    }
+    JsonVariantConst result = reply["result"];
+
+    switch (call.type) {
+    case CALL_BALANCE:
+        if (result["value"].isNull()) return;
+        *call.out.u64 = result["value"].as<uint64_t>();
+        call.done = true;
+        break;
+    case CALL_ACCOUNT_INFO:
+        call.done = readAccountInfo(result["value"], *call.out.account);
+        break;
+    case CALL_SIGNATURE_STATUSES:
+        call.done = readSignatureStatuses(result["value"], call.out.statuses, call.outCount) == call.outCount;
+        break;
+    case CALL_TOKEN_SUPPLY:
+        call.done = readTokenAmount(result["value"], *call.out.tokenAmount);
+        break;
+    case CALL_BLOCK:
+        call.done = readBlockInfo(result, *call.out.block);
+        break;
+    case CALL_BLOCKHASH:
+        if (result["value"]["blockhash"].isNull()) return;
+        *call.out.text = result["value"]["blockhash"].as<String>();
+        call.done = true;
+        break;
+    case CALL_U64:
+        if (result.isNull()) return;
+        *call.out.u64 = result.as<uint64_t>();
+        call.done = true;
+        break;
+    case CALL_RAW:
+        *call.out.text = "";
+        serializeJson(result, *call.out.text);
+        call.done = true;
+        break;
+    }
+}
+
+template <typename Reader>
+bool RpcBatch::readResponse(Reader& in) {
+    bool replied[SOLDUINO_RPC_BATCH_MAX] = {};
+    for (size_t i = 0; i < count; i++) {
+        calls[i].done = false;
+    }
+
+    FilterDocument filter;
+    deserializeJson(filter, BATCH_REPLY_FILTER);
+    DynamicJsonDocument doc(SOLDUINO_RPC_ACCOUNT_DOC_SIZE);
+
+    JsonScanner<Reader> scan(in);
+    if (scan.peek() == '{') {
+        // A batch the server rejects as a whole comes back as one error object
+        if (deserializeJson(doc, in, DeserializationOption::Filter(filter))) return false;
+        String message = doc["error"]["message"].as<String>();
+        for (size_t i = 0; i < count; i++) {
+            calls[i].error = message;
+        }
+        return false;
+    }
+    if (!scan.expect('[')) return false;
+
+    bool skipped = false;
+    while (scan.nextElement()) {
+        if (!readElement(in, doc, filter)) {
+            skipped = true;
+            continue;
+        }
+        int id = doc["id"] | -1;
+        if (id >= 0 && (size_t)id < count) {
+            replied[id] = true;
+            complete(calls[id], doc.as<JsonVariantConst>());
+        }
+    }
+
+    // A reply too large to parse has no id to go by
+    if (skipped) {
+        for (size_t i = 0; i < count; i++) {
+            if (!replied[i]) calls[i].error = "Reply too large";
+        }
+    }
+    return true;
+}
+
+bool RpcBatch::parseResponse(const String& jsonResponse) {
+    if (jsonResponse.length() == 0) {
+        for (size_t i = 0; i < count; i++) {
+            calls[i].done = false;
+        }
+        return false;
+    }
+    StringReader in(jsonResponse);
+    return readResponse(in);
+}
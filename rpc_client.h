@@ -7,6 +7,67 @@
 #include <WiFiClientSecure.h>
 #include <WiFiClient.h>
 #include <ArduinoJson.h>
+#include <type_traits>
+#include "tls_session.h"
+#include "rpc_stream.h"
+
+// connect(true) opens the connection on a std::thread worker on ESP32 and
+// hosted builds; other boards connect on the calling thread
+#ifndef SOLDUINO_RPC_THREADS
+#if defined(ESP32) || !defined(ARDUINO)
+#define SOLDUINO_RPC_THREADS 1
+#else
+#define SOLDUINO_RPC_THREADS 0
+#endif
+#endif
+
+// Stack of the connect(true) worker; a TLS handshake needs far more than
+// the pthread default
+#ifndef SOLDUINO_RPC_CONNECT_STACK
+#define SOLDUINO_RPC_CONNECT_STACK 8192
+#endif
+
+#if SOLDUINO_RPC_THREADS
+#include <thread>
+#endif
+
+// Initial size of the request buffer each RpcClient keeps; it grows once
+// if a request (say a large base64 transaction) needs more
+#ifndef SOLDUINO_RPC_REQUEST_SIZE
+#define SOLDUINO_RPC_REQUEST_SIZE 2048
+#endif
+
+// Calls one RpcBatch can queue
+#ifndef SOLDUINO_RPC_BATCH_MAX
+#define SOLDUINO_RPC_BATCH_MAX 16
+#endif
+
+// Document for one account while parsing; bounds the base64 data kept
+// per account (about 3/4 of this) in getAccountInfo/getProgramAccounts
+#ifndef SOLDUINO_RPC_ACCOUNT_DOC_SIZE
+#define SOLDUINO_RPC_ACCOUNT_DOC_SIZE 16384
+#endif
+
+// Document for a getTransaction result after filtering
+#ifndef SOLDUINO_RPC_TRANSACTION_DOC_SIZE
+#define SOLDUINO_RPC_TRANSACTION_DOC_SIZE 4096
+#endif
+
+// Document for one token account or signature status
+#ifndef SOLDUINO_RPC_ITEM_DOC_SIZE
+#define SOLDUINO_RPC_ITEM_DOC_SIZE 1024
+#endif
+
+class MessageBase;
+class AddressLookupTable;
+class RpcBatch;
+
+/**
+ * Consumes a response body straight off the connection (see
+ * RpcClient::streamRpcRequest). Whatever it leaves unread is drained
+ * or the connection is closed.
+ */
+typedef void (*RpcResponseReader)(RpcBodyStream& body, void* context);
 
 struct AccountInfo {
     String owner;
@@ -34,6 +95,7 @@ struct TransactionResponse {
     int slot;
     String status;
     String error;
+    String transaction;   // base64 wire format; decode and inspect with TransactionView
 };
 
 struct TokenAmount {
@@ -60,20 +122,224 @@ struct BlockCommitment {
     uint64_t totalStake;
 };
 
+struct SignatureStatus {
+    bool     found;                // false if the node has no record of the signature
+    uint64_t slot;
+    int32_t  confirmations;        // -1 once the block is rooted
+    String   confirmationStatus;   // "processed", "confirmed" or "finalized"
+    String   error;                // transaction error as JSON, empty on success
+};
+
+// ============================================================================
+// Request writer
+// ============================================================================
+
+/** Config object, e.g. {"encoding": "base64", "maxSupportedTransactionVersion": 0} */
+struct RpcOptions {
+    const char* encoding;                 // nullptr to omit
+    int maxSupportedTransactionVersion;   // -1 to omit
+    const char* transactionDetails;       // getBlock: "full", "signatures" or "none"; nullptr to omit
+    bool noRewards;                       // getBlock: true to send "rewards": false
+};
+
+/** One-field object, e.g. the {"mint": ...} filter of getTokenAccountsByOwner */
+struct RpcField {
+    const char* name;
+    const char* value;
+};
+
+/** Array of strings, e.g. the signatures of getSignatureStatuses */
+struct RpcStringArray {
+    const String* items;
+    size_t count;
+};
+
+/**
+ * Writes a JSON-RPC request straight into a caller buffer, with no JSON
+ * document or String in between. Params are typed: strings (String or
+ * const char*, quoted and escaped), integers, bool, RpcOptions, RpcField
+ * and RpcStringArray. Passing anything else does not compile.
+ *
+ * A writer over a nullptr buffer only counts, so a request can be sized
+ * exactly before it is written:
+ *
+ *   RpcRequestWriter w(buffer, capacity);
+ *   w.begin(id, "getBalance");
+ *   w.params(publicKey);
+ *   w.end();
+ *   // w.length() bytes; more than capacity means nothing past it was written
+ */
+class RpcRequestWriter {
+public:
+    RpcRequestWriter(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity), len(0), first(true) {}
+
+    /** {"jsonrpc":"2.0","id":<id>,"method":"<method>","params": */
+    void begin(int id, const char* method);
+
+    /** Write the params array */
+    template <typename... Params>
+    void params(const Params&... values) {
+        put('[');
+        first = true;
+        writeParams(values...);
+        put(']');
+    }
+
+    /** Write a params array that is already JSON text */
+    void rawParams(const char* json);
+
+    /** Close the request object */
+    void end() { put('}'); }
+
+    /** Write text as is, e.g. the brackets around a batch */
+    void write(const char* text);
+
+    /** @return Bytes the request takes, whether or not they fit */
+    size_t length() const { return len; }
+
+    /** @return true if the request fit in the buffer */
+    bool fits() const { return buffer && len <= capacity; }
+
+    void param(const String& value) { param(value.c_str()); }
+    void param(const char* value);
+    void param(const RpcOptions& options);
+    void param(const RpcField& field);
+    void param(const RpcStringArray& array);
+
+    // bool and the integers are templates so nothing converts into them:
+    // a double or a pointer would otherwise become true/false
+    template <typename T>
+    typename std::enable_if<std::is_same<T, bool>::value>::type param(T value) {
+        separator();
+        write(value ? "true" : "false");
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type param(T value) {
+        separator();
+        writeInteger(static_cast<typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>(value));
+    }
+
+    /** Any other type (floating point, byte pointers, enums) is a compile error */
+    template <typename T>
+    typename std::enable_if<!std::is_integral<T>::value && !std::is_convertible<T, const char*>::value>::type
+    param(const T&) = delete;
+
+private:
+    char* buffer;
+    size_t capacity;
+    size_t len;
+    bool first;
+
+    void writeParams() {}
+
+    template <typename First, typename... Rest>
+    void writeParams(const First& value, const Rest&... rest) {
+        param(value);
+        writeParams(rest...);
+    }
+
+    void put(char c) {
+        if (buffer && len < capacity) buffer[len] = c;
+        len++;
+    }
+    void writeString(const char* value);
+    void writeInteger(uint64_t value);
+    void writeInteger(int64_t value);
+    void separator();
+};
+
 /**
  * Solana RPC Client for Arduino
+ *
+ * Requests share one keep-alive connection: the TCP (and, for https, TLS)
+ * handshake happens on the first request and again only after the server
+ * closes the connection. A request that fails on a connection the server
+ * closed while it sat idle is retried once on a fresh one. connect()
+ * opens the connection ahead of time, optionally in the background while
+ * the device does other work.
+ *
+ * With a TlsSessionCache attached (setSessionCache()), https reconnects
+ * offer the endpoint's last TLS session and resume it with an abbreviated
+ * handshake when the server agrees (SOLDUINO_TLS_SESSIONS, ESP32).
+ *
+ * Methods whose results can grow large (accounts, program and token
+ * accounts, blocks, transactions, signature statuses) parse the response
+ * as it comes off the connection, keeping only what their structs need.
  */
 class RpcClient {
 private:
     String rpcEndpoint;
+    String host;
+    uint16_t port;
     HTTPClient http;
-    WiFiClientSecure* secureClient;
+    RpcSecureClient* secureClient;
+    TlsSessionCache* sessionCache;
     WiFiClient* httpClient;
     bool useSecure;
+    bool keepAlive;
+    bool connectionUsed;                  // the open connection has carried a request
     int requestId;
     int timeoutMs;
+    uint32_t handshakeCount;
+    uint32_t reusedCount;
+    uint32_t resumedCount;
+    uint32_t lastHandshakeUs;
+    uint32_t handshakeTimeUs;
+#if SOLDUINO_RPC_THREADS
+    std::thread connector;                // connect(true) worker, joined before the next use
+#endif
+    char*  requestBuffer;                 // reused by every request, grown on demand
+    size_t requestCapacity;
+
+    /**
+     * Size the request and write it into requestBuffer. Params go
+     * through RpcRequestWriter::param(), so an unsupported type is a
+     * compile error.
+     */
+    template <typename... Params>
+    bool writeRequest(const char* method, size_t& length, const Params&... params) {
+        RpcRequestWriter measure(nullptr, 0);
+        measure.begin(requestId, method);
+        measure.params(params...);
+        measure.end();
+        if (!reserveRequest(measure.length())) return false;
+
+        RpcRequestWriter writer(requestBuffer, requestCapacity);
+        writer.begin(requestId, method);
+        writer.params(params...);
+        writer.end();
+        length = writer.length();
+        return true;
+    }
 
-    String makeRpcRequest(const String& method, const String& params = "[]");
+    /** Send a request and return the whole response body */
+    template <typename... Params>
+    String makeRpcRequest(const char* method, const Params&... params) {
+        String response;
+        size_t length;
+        if (writeRequest(method, length, params...)) {
+            sendRequest(length, &response, nullptr, nullptr);
+        }
+        return response;
+    }
+
+    /**
+     * Send a request and hand the response body to reader as it arrives
+     * off the connection, without buffering it
+     */
+    template <typename... Params>
+    bool streamRpcRequest(const char* method, RpcResponseReader reader, void* context, const Params&... params) {
+        size_t length;
+        return writeRequest(method, length, params...) && sendRequest(length, nullptr, reader, context);
+    }
+
+    bool reserveRequest(size_t length);
+    bool sendRequest(size_t length, String* response, RpcResponseReader reader, void* context);
+    int  post(const char* body, size_t length, String* response, RpcResponseReader reader, void* context);
+    WiFiClient* transport() const { return useSecure ? secureClient : httpClient; }
+    bool openConnection();
+    void waitForConnection();
     bool extractResult(const String& response, DynamicJsonDocument& doc);
     void logError(const String& message);
 
@@ -82,10 +348,71 @@ public:
     ~RpcClient();
 
     bool begin();
+
+    /** Close the connection; the next request opens a new one */
     void end();
     void setTimeout(int timeout);
 
+    /**
+     * Keep the connection open between requests (default on). Turning it
+     * off closes the connection after every request; one opened by
+     * connect() is still used for the next request.
+     */
+    void setKeepAlive(bool keepAlive) { this->keepAlive = keepAlive; }
+    bool getKeepAlive() const { return keepAlive; }
+
+    /**
+     * Open the connection now so the next request skips the handshake,
+     * e.g. right before sampling a sensor.
+     * @param background With SOLDUINO_RPC_THREADS, handshake on a worker
+     *                   thread and return at once; the next request waits
+     *                   for it to finish
+     * @return true if connected (or, in the background, started)
+     */
+    bool connect(bool background = false);
+
+    /** @return Connections opened (one TCP, and for https TLS, handshake each) */
+    uint32_t getHandshakeCount() const { return handshakeCount; }
+
+    /** @return Requests sent on a connection an earlier request already used */
+    uint32_t getReusedCount() const { return reusedCount; }
+
+    /** @return Handshakes that resumed a cached TLS session */
+    uint32_t getResumedCount() const { return resumedCount; }
+
+    /** @return Time the last connection took to open (TCP + TLS), in us */
+    uint32_t getLastHandshakeUs() const { return lastHandshakeUs; }
+
+    /** @return Time spent opening connections since the last reset, in us */
+    uint32_t getHandshakeTimeUs() const { return handshakeTimeUs; }
+
+    void resetConnectionStats();
+
+    /**
+     * Resume TLS sessions from this cache on https reconnects, and store
+     * the session each handshake ends with. The cache may be shared by
+     * several clients and must outlive them; nullptr turns resumption off.
+     * Without SOLDUINO_TLS_SESSIONS the cache is kept but never consulted.
+     */
+    void setSessionCache(TlsSessionCache* cache);
+    TlsSessionCache* getSessionCache() const { return sessionCache; }
+
+    /** @return Host the client connects to, as parsed from the endpoint */
+    const String& getHost() const { return host; }
+    uint16_t getPort() const { return port; }
+
     bool     getAccountInfo(const String& publicKey, AccountInfo& info);
+
+    /**
+     * Fetch an address lookup table through getAccountInfo. Tables only
+     * grow, so a table that already holds this address is reused as is
+     * unless refresh is set (e.g. after extending it).
+     * @param address Table address (Base58)
+     * @param table   Destination; doubles as the cache
+     * @param refresh Re-fetch even if table already holds this address
+     * @return true if table holds the lookup table
+     */
+    bool     getAddressLookupTable(const String& address, AddressLookupTable& table, bool refresh = false);
     float    getBalance(const String& publicKey);
     uint64_t getBalanceLamports(const String& publicKey);
     uint64_t getBlockHeight();
@@ -93,11 +420,25 @@ public:
     String   getVersion();
     bool     getHealth();
 
+    /**
+     * Send every call queued in a batch as one JSON array in one POST and
+     * fill each call's destination from the reply with its id.
+     * @return false if the request failed as a whole; check individual
+     *         calls with RpcBatch::ok()
+     */
+    bool   send(RpcBatch& batch);
+
     String sendTransaction(const String& transaction);
     String sendTransactionBase58(const String& transaction);
     bool   getTransaction(const String& signature, TransactionResponse& tx);
     bool   getConfirmedTransaction(const String& signature, TransactionResponse& tx);
 
+    /**
+     * Look up up to 256 signatures in one call.
+     * @return Number of statuses written (count on success, 0 on error)
+     */
+    size_t getSignatureStatuses(const String signatures[], size_t count, SignatureStatus* statuses);
+
     bool   getBlock(uint64_t slot, BlockInfo& info);
     bool   getBlockCommitment(uint64_t slot, BlockCommitment& commitment);
     size_t getBlocks(uint64_t startSlot, uint64_t endSlot, uint64_t* buffer, size_t maxCount);
@@ -110,6 +451,7 @@ public:
     bool     getLatestBlockhashBytes(uint8_t* blockhash);
     uint64_t getMinimumBalanceForRentExemption(size_t dataSize);
     uint64_t getFeeForMessage(const String& message);
+    uint64_t getFeeForMessage(const MessageBase& message);   // reuses the message's serialized bytes
 
     /**
      * Request an airdrop of SOL to an account
@@ -134,6 +476,136 @@ size_t parseTokenAccounts(const String& jsonResponse, TokenAccount* buffer, size
 size_t parseProgramAccounts(const String& jsonResponse, ProgramAccount* buffer, size_t maxCount);
 bool   parseBlockCommitment(const String& jsonResponse, BlockCommitment& commitment);
 size_t parseBlocks(const String& jsonResponse, uint64_t* buffer, size_t maxCount);
+size_t parseSignatureStatuses(const String& jsonResponse, SignatureStatus* buffer, size_t maxCount);
+
+// Incremental versions of the parsers above, for responses read from a
+// Stream (a file, a recorded capture). Only the fields the structs need
+// are kept and array results are parsed one element at a time, so memory
+// stays bounded however long the response is. An element too large for
+// its document is skipped (a signature status in its place reads as not
+// found) and the rest are still parsed; RpcClient logs how many were
+bool   parseAccountInfo(Stream& body, AccountInfo& info);
+bool   parseBlockInfo(Stream& body, BlockInfo& info);
+bool   parseTransaction(Stream& body, TransactionResponse& tx);
+size_t parseTokenAccounts(Stream& body, TokenAccount* buffer, size_t maxCount);
+size_t parseProgramAccounts(Stream& body, ProgramAccount* buffer, size_t maxCount);
+size_t parseBlocks(Stream& body, uint64_t* buffer, size_t maxCount);
+size_t parseSignatureStatuses(Stream& body, SignatureStatus* buffer, size_t maxCount);
+
+/**
+ * A JSON-RPC batch: calls queued here go out as one array in a single
+ * POST through RpcClient::send(), so N round trips become one. Each
+ * queue method records where its result goes and returns the call's
+ * index (or -1 when the batch is full); after send(), ok(index) tells
+ * whether that call got a result.
+ *
+ * Usage:
+ *   RpcBatch batch;
+ *   String blockhash;
+ *   uint64_t slot, lamports;
+ *   batch.getLatestBlockhash(blockhash);
+ *   batch.getSlot(slot);
+ *   int balance = batch.getBalance(wallet, lamports);
+ *   if (rpc.send(batch) && batch.ok(balance)) { ... }
+ *
+ * Destinations, and the signatures passed to getSignatureStatuses(),
+ * must stay valid until send() returns. The batch can be reused after
+ * clear().
+ */
+class RpcBatch {
+public:
+    RpcBatch();
+
+    int getBalance(const String& publicKey, uint64_t& lamports);
+    int getAccountInfo(const String& publicKey, AccountInfo& info);
+    int getSignatureStatuses(const String signatures[], size_t count, SignatureStatus* statuses);
+    int getTokenSupply(const String& mint, TokenAmount& supply);
+
+    /**
+     * Block header only: the block is requested without transactions or
+     * rewards, so transactionCount is -1. RpcClient::getBlock() counts them.
+     */
+    int getBlock(uint64_t slot, BlockInfo& info);
+    int getLatestBlockhash(String& blockhash);
+    int getSlot(uint64_t& slot);
+    int getBlockHeight(uint64_t& height);
+
+    /**
+     * Queue any method.
+     * @param params The params array as JSON text, sent as is
+     * @param result Receives the call's "result" value as JSON text
+     */
+    int callRpc(const String& method, const String& params, String& result);
+
+    /**
+     * Fill destinations from a batch reply (what send() does with the
+     * response body). Call i is sent with id i; replies may come back in
+     * any order. Replies are parsed one at a time into a document of
+     * SOLDUINO_RPC_ACCOUNT_DOC_SIZE; a call whose reply does not fit gets
+     * an error instead of a result.
+     * @return false if the reply is not a JSON-RPC batch response
+     */
+    bool parseResponse(const String& jsonResponse);
+
+    /** Forget every queued call */
+    void clear();
+
+    /** @return Queued calls */
+    size_t size() const { return count; }
+
+    /** @return true if the call at index got a result */
+    bool ok(int index) const;
+
+    /** @return The RPC error message for the call at index, if it got one */
+    String getError(int index) const;
+
+    /** @return Calls that got a result in the last reply */
+    size_t getCompleted() const;
+
+private:
+    friend class RpcClient;
+
+    enum CallType : uint8_t {
+        CALL_BALANCE,
+        CALL_ACCOUNT_INFO,
+        CALL_SIGNATURE_STATUSES,
+        CALL_TOKEN_SUPPLY,
+        CALL_BLOCK,
+        CALL_BLOCKHASH,
+        CALL_U64,
+        CALL_RAW
+    };
+
+    struct Call {
+        CallType type;
+        bool     done;
+        size_t   outCount;        // statuses for CALL_SIGNATURE_STATUSES
+        const char* method;       // string literal; callRpc() uses rawMethod
+        String   rawMethod;
+        String   key;             // public key or mint; callRpc() params as JSON
+        uint64_t slot;            // CALL_BLOCK
+        const String* signatures; // CALL_SIGNATURE_STATUSES, outCount of them
+        String   error;
+        union {
+            uint64_t*        u64;
+            AccountInfo*     account;
+            SignatureStatus* statuses;
+            TokenAmount*     tokenAmount;
+            BlockInfo*       block;
+            String*          text;
+        } out;
+    };
+
+    Call   calls[SOLDUINO_RPC_BATCH_MAX];
+    size_t count;
+
+    Call* add(CallType type, const char* method, const String& key);
+    void   write(RpcRequestWriter& writer);
+    void   complete(Call& call, JsonVariantConst reply);
+
+    template <typename Reader>
+    bool   readResponse(Reader& in);
+};
 
 enum RpcClientStatus {
     RPC_DISCONNECTED,
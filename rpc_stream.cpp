@@ -0,0 +1,120 @@
+#include "rpc_stream.h"
+
+RpcBodyStream::RpcBodyStream(Client& client, int contentLength, bool chunked, uint32_t timeoutMs)
+    : client(client), remaining(chunked ? 0 : contentLength), chunked(chunked), firstChunk(true),
+      done(!chunked && contentLength == 0), peeked(-1), count(0), timeoutMs(timeoutMs) {
+    setTimeout(timeoutMs);
+}
+
+int RpcBodyStream::rawRead() {
+    uint32_t start = millis();
+    while (client.available() <= 0) {
+        if (!client.connected() || millis() - start >= timeoutMs) return -1;
+        delay(1);
+    }
+    return client.read();
+}
+
+/**
+ * Read the next chunk header ("<hex size>[;ext]\r\n"). A zero-size chunk
+ * ends the body; its trailer section is read up to the blank line.
+ */
+bool RpcBodyStream::nextChunk() {
+    if (!firstChunk) {
+        // CRLF closing the previous chunk's data
+        if (rawRead() != '\r' || rawRead() != '\n') return false;
+    }
+    firstChunk = false;
+
+    int64_t size = 0;
+    bool digits = false;
+    bool extension = false;
+    for (;;) {
+        int c = rawRead();
+        if (c < 0) return false;
+        if (c == '\n') break;
+        if (c == '\r' || extension) continue;
+        if (c == ';') {
+            extension = true;
+            continue;
+        }
+        int v = (c >= '0' && c <= '9') ? c - '0'
+              : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+              : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+        if (v < 0 || size > (INT64_MAX >> 4)) return false;
+        size = (size << 4) | v;
+        digits = true;
+    }
+    if (!digits) return false;
+
+    if (size == 0) {
+        // Trailers, then an empty line
+        int lineLength = 0;
+        for (;;) {
+            int c = rawRead();
+            if (c < 0) return false;
+            if (c == '\n') {
+                if (lineLength == 0) break;
+                lineLength = 0;
+            } else if (c != '\r') {
+                lineLength++;
+            }
+        }
+        return false;
+    }
+    remaining = size;
+    return true;
+}
+
+int RpcBodyStream::next() {
+    if (done) return -1;
+    if (chunked && remaining == 0 && !nextChunk()) {
+        done = true;
+        return -1;
+    }
+
+    int c = rawRead();
+    if (c < 0) {
+        // A close is the end of a body of unknown length; anything else
+        // was cut short, which the parser will notice
+        done = true;
+        return -1;
+    }
+    count++;
+    if (remaining > 0) {
+        remaining--;
+        if (remaining == 0 && !chunked) done = true;
+    }
+    return c;
+}
+
+int RpcBodyStream::read() {
+    if (peeked >= 0) {
+        int c = peeked;
+        peeked = -1;
+        return c;
+    }
+    return next();
+}
+
+int RpcBodyStream::peek() {
+    if (peeked < 0) peeked = next();
+    return peeked;
+}
+
+int RpcBodyStream::available() {
+    if (peeked >= 0) return 1;
+    if (done) return 0;
+    int n = client.available();
+    if (n <= 0) return 0;
+    if (remaining > 0 && remaining < n) return (int)remaining;
+    return chunked && remaining == 0 ? 0 : n;
+}
+
+bool RpcBodyStream::drain(size_t limit) {
+    peeked = -1;
+    for (size_t i = 0; i < limit && !done; i++) {
+        next();
+    }
+    return done;
+}
@@ -0,0 +1,71 @@
+#ifndef SOLDUINO_RPC_STREAM_H
+#define SOLDUINO_RPC_STREAM_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <stdint.h>
+
+// ============================================================================
+// Solduino RPC Response Stream
+// ============================================================================
+// The body of an HTTP response read straight off the connection, so JSON
+// parsers can consume it as it arrives instead of buffering it whole:
+// - Content-Length bodies end after that many bytes
+// - Chunked bodies are de-chunked on the fly
+// - Bodies with neither end when the server closes the connection
+// ============================================================================
+
+// Bytes drain() reads past what a parser consumed to keep a keep-alive
+// connection usable; a longer unread tail closes the connection instead
+#ifndef SOLDUINO_RPC_DRAIN_LIMIT
+#define SOLDUINO_RPC_DRAIN_LIMIT 1024
+#endif
+
+class RpcBodyStream : public Stream {
+public:
+    /**
+     * @param client        Connection positioned at the start of the body
+     * @param contentLength Content-Length, or -1 if absent
+     * @param chunked       Transfer-Encoding: chunked
+     * @param timeoutMs     Longest wait for the next byte
+     */
+    RpcBodyStream(Client& client, int contentLength, bool chunked, uint32_t timeoutMs);
+
+    /** Bytes that can be read without waiting, capped at the body's end */
+    int available() override;
+
+    /** Next body byte, waiting up to the timeout; -1 at the end */
+    int read() override;
+    int peek() override;
+
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+
+    /** @return true once the whole body has been read */
+    bool finished() const { return done; }
+
+    /** @return Body bytes read so far */
+    size_t consumed() const { return count; }
+
+    /**
+     * Read and discard the rest of the body, up to limit bytes.
+     * @return true if the body ended within the limit
+     */
+    bool drain(size_t limit = SOLDUINO_RPC_DRAIN_LIMIT);
+
+private:
+    Client& client;
+    int64_t remaining;      // in the body or the current chunk; -1 = unknown
+    bool chunked;
+    bool firstChunk;
+    bool done;
+    int peeked;
+    size_t count;
+    uint32_t timeoutMs;
+
+    int rawRead();
+    bool nextChunk();
+    int next();
+};
+
+#endif // SOLDUINO_RPC_STREAM_H
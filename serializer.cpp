@@ -38,23 +38,17 @@ bool TransactionSerializer::serializeHeader(uint8_t* buffer, uint16_t& offset, u
 }
 
 bool TransactionSerializer::serializeAccountKeys(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                                 const uint8_t accountKeys[][SOLDUINO_PUBKEY_SIZE],
-                                                 uint8_t accountCount) {
-    if (!buffer || offset + 1 >= maxLen) {
+                                                 const MessageBase& message) {
+    // Static keys only; the rest are loaded through v0 lookups
+    uint8_t accountCount = message.staticAccountCount;
+    if (!buffer || !writeCompactU16(buffer, offset, maxLen, accountCount) ||
+        offset + (uint16_t)accountCount * SOLDUINO_PUBKEY_SIZE > maxLen) {
         return false;
     }
     
-    // Write account count as compact u16
-    if (!writeCompactU16(buffer, offset, maxLen, accountCount)) {
-        return false;
-    }
-    
-    // Write each account key (32 bytes each)
+    // Each key straight from the message's key table, in compiled order
     for (uint8_t i = 0; i < accountCount; i++) {
-        if (offset + SOLDUINO_PUBKEY_SIZE > maxLen) {
-            return false;
-        }
-        memcpy(buffer + offset, accountKeys[i], SOLDUINO_PUBKEY_SIZE);
+        memcpy(buffer + offset, message.accountKeys[message.accountOrder[i]], SOLDUINO_PUBKEY_SIZE);
         offset += SOLDUINO_PUBKEY_SIZE;
     }
     
@@ -73,13 +67,17 @@ bool TransactionSerializer::serializeBlockhash(uint8_t* buffer, uint16_t& offset
 }
 
 bool TransactionSerializer::serializeInstruction(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                                 const CompiledInstruction& instruction) {
+                                                 const MessageBase& message, uint8_t index) {
     if (!buffer || offset + 1 >= maxLen) {
         return false;
     }
     
+    // Recorded key table indexes: program, then accounts
+    const MessageInstruction& instruction = message.instructions[index];
+    const uint8_t* keys = message.keysOf(index);
+    
     // Write program ID index
-    buffer[offset++] = instruction.programIdIndex;
+    buffer[offset++] = message.accountPosition[keys[0]];
     
     // Write account indices count as compact u16
     if (!writeCompactU16(buffer, offset, maxLen, instruction.accountCount)) {
@@ -91,7 +89,7 @@ bool TransactionSerializer::serializeInstruction(uint8_t* buffer, uint16_t& offs
         return false;
     }
     for (uint8_t i = 0; i < instruction.accountCount; i++) {
-        buffer[offset++] = instruction.accountIndices[i];
+        buffer[offset++] = message.accountPosition[keys[i + 1]];
     }
     
     // Write data length as compact u16
@@ -104,7 +102,7 @@ bool TransactionSerializer::serializeInstruction(uint8_t* buffer, uint16_t& offs
         return false;
     }
     if (instruction.dataLength > 0) {
-        memcpy(buffer + offset, instruction.data, instruction.dataLength);
+        memcpy(buffer + offset, message.instructionData + instruction.dataOffset, instruction.dataLength);
         offset += instruction.dataLength;
     }
     
@@ -112,20 +110,19 @@ bool TransactionSerializer::serializeInstruction(uint8_t* buffer, uint16_t& offs
 }
 
 bool TransactionSerializer::serializeInstructions(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                                  const CompiledInstruction* instructions,
-                                                  uint8_t instructionCount) {
-    if (!buffer || !instructions || offset + 1 >= maxLen) {
+                                                  const MessageBase& message) {
+    if (!buffer || offset + 1 >= maxLen) {
         return false;
     }
     
     // Write instruction count as compact u16
-    if (!writeCompactU16(buffer, offset, maxLen, instructionCount)) {
+    if (!writeCompactU16(buffer, offset, maxLen, message.instructionCount)) {
         return false;
     }
     
     // Serialize each instruction
-    for (uint8_t i = 0; i < instructionCount; i++) {
-        if (!serializeInstruction(buffer, offset, maxLen, instructions[i])) {
+    for (uint8_t i = 0; i < message.instructionCount; i++) {
+        if (!serializeInstruction(buffer, offset, maxLen, message, i)) {
             return false;
         }
     }
@@ -133,44 +130,73 @@ bool TransactionSerializer::serializeInstructions(uint8_t* buffer, uint16_t& off
     return true;
 }
 
-bool TransactionSerializer::serializeMessage(const Message& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen) {
+bool TransactionSerializer::serializeMessage(const MessageBase& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen) {
     if (!buffer || bufferLen == 0) {
         return false;
     }
     
-    uint16_t offset = 0;
+    // A cached wire form is copied; otherwise write straight into the
+    // caller's buffer rather than filling the cache first
+    if (message.serializedLength == 0) {
+        return writeMessage(message, buffer, bufferLen, serializedLen);
+    }
+    if (message.serializedLength > bufferLen) {
+        return false;
+    }
+    memcpy(buffer, message.serialized, message.serializedLength);
+    serializedLen = message.serializedLength;
+    return true;
+}
+
+bool TransactionSerializer::encodeMessage(const MessageBase& message, char* output, size_t outputLen) {
+    if (!output || outputLen == 0) {
+        return false;
+    }
     
-    // Serialize header
-    TransactionHeader header = message.getHeader();
-    if (!serializeHeader(buffer, offset, bufferLen, header)) {
+    uint16_t messageLen = 0;
+    const uint8_t* bytes = message.serialize(messageLen);
+    if (!bytes) {
+        return false;
+    }
+    return Base64::encode(bytes, messageLen, output, outputLen) > 0;
+}
+
+bool TransactionSerializer::writeMessage(const MessageBase& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen) {
+    if (!buffer || bufferLen == 0) {
         return false;
     }
     
-    // Serialize account keys
-    // Get account keys one by one (friend access allows direct access, but we'll use safer method)
-    uint8_t accountKeysBuffer[MAX_ACCOUNTS][SOLDUINO_PUBKEY_SIZE];
-    uint8_t accountCount = message.getAccountCount();
-    for (uint8_t i = 0; i < accountCount; i++) {
-        if (!message.getAccount(i, accountKeysBuffer[i])) {
+    uint16_t offset = 0;
+    
+    // Header and key order come from compile()
+    message.compile();
+    
+    // v0 messages start with the version prefix (high bit set, version 0)
+    if (message.isVersioned()) {
+        if (offset + 1 > bufferLen) {
             return false;
         }
+        buffer[offset++] = MESSAGE_VERSION_PREFIX | 0;
     }
     
-    if (!serializeAccountKeys(buffer, offset, bufferLen, accountKeysBuffer, accountCount)) {
+    // Serialize header
+    TransactionHeader header = message.getHeader();
+    if (!serializeHeader(buffer, offset, bufferLen, header)) {
         return false;
     }
     
-    // Serialize recent blockhash
-    uint8_t blockhash[BLOCKHASH_SIZE];
-    if (!message.getRecentBlockhash(blockhash)) {
+    // Serialize account keys and recent blockhash
+    if (!serializeAccountKeys(buffer, offset, bufferLen, message) ||
+        !serializeBlockhash(buffer, offset, bufferLen, message.recentBlockhash)) {
         return false;
     }
-    if (!serializeBlockhash(buffer, offset, bufferLen, blockhash)) {
+    
+    // Serialize instructions
+    if (!serializeInstructions(buffer, offset, bufferLen, message)) {
         return false;
     }
     
-    // Serialize instructions
-    if (!serializeInstructions(buffer, offset, bufferLen, message.instructions, message.instructionCount)) {
+    if (message.isVersioned() && !serializeAddressTableLookups(buffer, offset, bufferLen, message)) {
         return false;
     }
     
@@ -178,39 +204,98 @@ bool TransactionSerializer::serializeMessage(const Message& message, uint8_t* bu
     return true;
 }
 
-bool TransactionSerializer::serializeTransaction(const Transaction& transaction, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen) {
-    if (!buffer || bufferLen == 0) {
+bool TransactionSerializer::serializeAddressTableLookups(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
+                                                         const MessageBase& message) {
+    // Tables that load no keys are left out
+    uint8_t used = 0;
+    for (uint8_t t = 0; t < message.lookupTableCount; t++) {
+        if (message.lookupWritableCounts[t] + message.lookupReadonlyCounts[t] > 0) {
+            used++;
+        }
+    }
+    if (!writeCompactU16(buffer, offset, maxLen, used)) {
         return false;
     }
     
-    uint16_t offset = 0;
+    // lookupIndexes holds every table's writable entries, then every
+    // table's readonly entries, matching the loaded account order
+    uint8_t loadedWritable = 0;
+    for (uint8_t t = 0; t < message.lookupTableCount; t++) {
+        loadedWritable += message.lookupWritableCounts[t];
+    }
+    const uint8_t* writable = message.lookupIndexes;
+    const uint8_t* readonly = message.lookupIndexes + loadedWritable;
     
+    for (uint8_t t = 0; t < message.lookupTableCount; t++) {
+        uint8_t writableCount = message.lookupWritableCounts[t];
+        uint8_t readonlyCount = message.lookupReadonlyCounts[t];
+        if (writableCount + readonlyCount == 0) {
+            continue;
+        }
+        
+        if (offset + SOLDUINO_PUBKEY_SIZE > maxLen) {
+            return false;
+        }
+        memcpy(buffer + offset, message.lookupTables[t]->getKey(), SOLDUINO_PUBKEY_SIZE);
+        offset += SOLDUINO_PUBKEY_SIZE;
+        
+        if (!writeCompactU16(buffer, offset, maxLen, writableCount) || offset + writableCount > maxLen) {
+            return false;
+        }
+        memcpy(buffer + offset, writable, writableCount);
+        offset += writableCount;
+        writable += writableCount;
+        
+        if (!writeCompactU16(buffer, offset, maxLen, readonlyCount) || offset + readonlyCount > maxLen) {
+            return false;
+        }
+        memcpy(buffer + offset, readonly, readonlyCount);
+        offset += readonlyCount;
+        readonly += readonlyCount;
+    }
+    return true;
+}
+
+// Unsigned slots are left zeroed; Solana rejects them
+static bool isBlankSignature(const uint8_t* signature) {
+    for (uint8_t j = 0; j < SIGNATURE_SIZE; j++) {
+        if (signature[j] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TransactionSerializer::writeSignatures(const TransactionBase& transaction, uint8_t* buffer, uint16_t bufferLen,
+                                            uint16_t& offset) {
     // Serialize signatures count as compact u16
-    if (!writeCompactU16(buffer, offset, bufferLen, transaction.signatureCount)) {
+    if (!writeCompactU16(buffer, offset, bufferLen, transaction.signatureCount) ||
+        offset + (uint16_t)transaction.signatureCount * SIGNATURE_SIZE > bufferLen) {
         return false;
     }
     
     // Serialize each signature (64 bytes each)
     // Note: All signatures must be present and valid (non-zero) for Solana
     for (uint8_t i = 0; i < transaction.signatureCount; i++) {
-        if (offset + SIGNATURE_SIZE > bufferLen) {
-            return false;
-        }
-        // Verify signature is not all zeros (basic validation)
-        bool isZero = true;
-        for (uint8_t j = 0; j < SIGNATURE_SIZE; j++) {
-            if (transaction.signatures[i][j] != 0) {
-                isZero = false;
-                break;
-            }
-        }
-        if (isZero && transaction.signatureCount > 0) {
-            // All signatures must be valid - zero signature is invalid
+        // All signatures must be valid - zero signature is invalid
+        if (isBlankSignature(transaction.signatures[i])) {
             return false;
         }
         memcpy(buffer + offset, transaction.signatures[i], SIGNATURE_SIZE);
         offset += SIGNATURE_SIZE;
     }
+    return true;
+}
+
+bool TransactionSerializer::serializeTransaction(const TransactionBase& transaction, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen) {
+    if (!buffer || bufferLen == 0) {
+        return false;
+    }
+    
+    uint16_t offset = 0;
+    if (!writeSignatures(transaction, buffer, bufferLen, offset)) {
+        return false;
+    }
     
     // Serialize message
     uint16_t messageLen = 0;
@@ -224,92 +309,215 @@ bool TransactionSerializer::serializeTransaction(const Transaction& transaction,
     return true;
 }
 
-uint16_t TransactionSerializer::calculateMessageSize(const Message& message) {
-    // Header: 3 bytes
-    uint16_t size = 3;
-    
-    // Account keys: compact u16 count + 32 bytes per account
-    size += 2; // compact u16
-    size += message.accountCount * SOLDUINO_PUBKEY_SIZE;
-    
-    // Blockhash: 32 bytes
+bool TransactionSerializer::readCompactU16(const uint8_t* buffer, uint16_t length, uint16_t& offset, uint16_t& value) {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (offset >= length) {
+            return false;
+        }
+        uint8_t b = buffer[offset++];
+        // A zero continuation byte would alias a shorter encoding
+        if (i > 0 && b == 0) {
+            return false;
+        }
+        result |= (uint32_t)(b & 0x7F) << (i * 7);
+        if (!(b & 0x80)) {
+            if (result > 0xFFFF) {
+                return false;
+            }
+            value = (uint16_t)result;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t TransactionSerializer::compactU16Size(uint16_t value) {
+    return value < 0x80 ? 1 : (value < 0x4000 ? 2 : 3);
+}
+
+uint16_t TransactionSerializer::instructionSize(uint8_t accountCount, uint16_t dataLength) {
+    return 1 + compactU16Size(accountCount) + accountCount + compactU16Size(dataLength) + dataLength;
+}
+
+uint32_t TransactionSerializer::signaturesSize(uint8_t count) {
+    return compactU16Size(count) + (uint32_t)count * SIGNATURE_SIZE;
+}
+
+uint32_t TransactionSerializer::messageSize(bool versioned, uint8_t staticKeys, uint8_t instructionCount,
+                                            uint32_t instructionBytes, const uint8_t* loadedWritable,
+                                            const uint8_t* loadedReadonly, uint8_t tableCount) {
+    // Version prefix (v0), header, static keys, blockhash, instructions
+    uint32_t size = (versioned ? 1 : 0) + 3;
+    size += compactU16Size(staticKeys) + (uint32_t)staticKeys * SOLDUINO_PUBKEY_SIZE;
     size += BLOCKHASH_SIZE;
-    
-    // Instructions: compact u16 count + each instruction
-    size += 2; // compact u16
-    for (uint8_t i = 0; i < message.instructionCount; i++) {
-        const CompiledInstruction& inst = message.instructions[i];
-        size += 1; // programIdIndex
-        size += 2; // compact u16 for account count
-        size += inst.accountCount; // account indices
-        size += 2; // compact u16 for data length
-        size += inst.dataLength; // instruction data
+    size += compactU16Size(instructionCount) + instructionBytes;
+    
+    // v0: one lookup (table key, writable and readonly indexes) per table
+    // that loads a key
+    if (versioned) {
+        uint8_t used = 0;
+        for (uint8_t t = 0; t < tableCount; t++) {
+            if (loadedWritable[t] + loadedReadonly[t] == 0) {
+                continue;
+            }
+            used++;
+            size += SOLDUINO_PUBKEY_SIZE + compactU16Size(loadedWritable[t]) + loadedWritable[t] +
+                    compactU16Size(loadedReadonly[t]) + loadedReadonly[t];
+        }
+        size += compactU16Size(used);
     }
-    
     return size;
 }
 
-uint16_t TransactionSerializer::calculateTransactionSize(const Transaction& transaction) {
-    // Signatures: compact u16 count + 64 bytes per signature
-    uint16_t size = 2; // compact u16
-    size += transaction.signatureCount * SIGNATURE_SIZE;
-    
-    // Message size
-    size += calculateMessageSize(transaction.message);
+uint16_t TransactionSerializer::calculateMessageSize(const MessageBase& message) {
+    // The cached wire form already has the answer
+    if (message.serializedLength != 0) {
+        return message.serializedLength;
+    }
+    message.compile();
     
-    return size;
+    uint32_t instructionBytes = 0;
+    for (uint8_t i = 0; i < message.instructionCount; i++) {
+        instructionBytes += instructionSize(message.instructions[i].accountCount, message.instructions[i].dataLength);
+    }
+    uint32_t size = messageSize(message.isVersioned(), message.staticAccountCount, message.instructionCount,
+                                instructionBytes, message.lookupWritableCounts, message.lookupReadonlyCounts,
+                                message.lookupTableCount);
+    return size > 0xFFFF ? 0xFFFF : (uint16_t)size;
+}
+
+uint16_t TransactionSerializer::calculateTransactionSize(const TransactionBase& transaction) {
+    uint32_t size = signaturesSize(transaction.signatureCount) + calculateMessageSize(transaction.message);
+    return size > 0xFFFF ? 0xFFFF : (uint16_t)size;
+}
+
+size_t TransactionSerializer::calculateEncodedSize(const TransactionBase& transaction, TransactionEncoding encoding) {
+    size_t size = calculateTransactionSize(transaction);
+    switch (encoding) {
+        case TX_ENCODING_BASE64:
+            return (size + 2) / 3 * 4 + 1;
+        case TX_ENCODING_BASE58:
+            // log(256) / log(58) < 1.38, plus the terminator
+            return size * 138 / 100 + 2;
+    }
+    return 0;
+}
+
+/**
+ * Base64 encoder fed in pieces, so a transaction can be encoded straight
+ * from its signatures and cached message with no contiguous copy.
+ */
+struct Base64Stream {
+    char* output;
+    size_t outputLen;
+    size_t length;
+    uint8_t pending[3];
+    uint8_t pendingCount;
+
+    void emit(const uint8_t* in, uint8_t count);
+    void feed(const uint8_t* data, size_t len);
+    size_t finish();
+};
+
+void Base64Stream::emit(const uint8_t* in, uint8_t count) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t group = ((uint32_t)in[0] << 16) | ((count > 1 ? (uint32_t)in[1] : 0) << 8) | (count > 2 ? in[2] : 0);
+    char* out = output + length;
+    out[0] = chars[(group >> 18) & 0x3F];
+    out[1] = chars[(group >> 12) & 0x3F];
+    out[2] = count > 1 ? chars[(group >> 6) & 0x3F] : '=';
+    out[3] = count > 2 ? chars[group & 0x3F] : '=';
+    length += 4;
+}
+
+void Base64Stream::feed(const uint8_t* data, size_t len) {
+    while (len > 0 && pendingCount > 0 && pendingCount < 3) {
+        pending[pendingCount++] = *data++;
+        len--;
+    }
+    if (pendingCount == 3) {
+        emit(pending, 3);
+        pendingCount = 0;
+    }
+    for (; len >= 3; data += 3, len -= 3) {
+        emit(data, 3);
+    }
+    while (len > 0) {
+        pending[pendingCount++] = *data++;
+        len--;
+    }
+}
+
+size_t Base64Stream::finish() {
+    if (pendingCount > 0) {
+        emit(pending, pendingCount);
+        pendingCount = 0;
+    }
+    output[length] = '\0';
+    return length;
 }
 
-bool TransactionSerializer::encodeTransaction(const Transaction& transaction, char* output, size_t outputLen) {
+bool TransactionSerializer::encodeTransaction(const TransactionBase& transaction, char* output, size_t outputLen) {
     if (!output || outputLen == 0) {
         return false;
     }
 
-    // Calculate required buffer size
-    uint16_t estimatedSize = calculateTransactionSize(transaction);
-    uint8_t* buffer = (uint8_t*)malloc(estimatedSize + 100); // Add padding
-    if (!buffer) {
+    // The message comes from its cache; signatures from the transaction
+    uint16_t messageLen = 0;
+    const uint8_t* messageBytes = transaction.message.serialize(messageLen);
+    if (!messageBytes) {
         return false;
     }
     
-    // Serialize transaction
-    uint16_t serializedLen = 0;
-    if (!serializeTransaction(transaction, buffer, estimatedSize + 100, serializedLen)) {
-        free(buffer);
+    uint8_t prefix[3];
+    uint16_t prefixLen = 0;
+    if (!writeCompactU16(prefix, prefixLen, sizeof(prefix), transaction.signatureCount)) {
+        return false;
+    }
+    size_t total = prefixLen + (size_t)transaction.signatureCount * SIGNATURE_SIZE + messageLen;
+    if ((total + 2) / 3 * 4 + 1 > outputLen) {
         return false;
     }
     
-    // Encode to base64
-    size_t encodedLen = Base64::encode(buffer, serializedLen, output, outputLen);
-    free(buffer);
-    
-    return encodedLen > 0;
+    Base64Stream stream = {output, outputLen, 0, {0, 0, 0}, 0};
+    stream.feed(prefix, prefixLen);
+    for (uint8_t i = 0; i < transaction.signatureCount; i++) {
+        if (isBlankSignature(transaction.signatures[i])) {
+            return false;
+        }
+        stream.feed(transaction.signatures[i], SIGNATURE_SIZE);
+    }
+    stream.feed(messageBytes, messageLen);
+    return stream.finish() > 0;
 }
 
-bool TransactionSerializer::encodeTransactionBase58(const Transaction& transaction, char* output, size_t outputLen) {
+bool TransactionSerializer::encodeTransactionBase58(const TransactionBase& transaction, char* output, size_t outputLen) {
     if (!output || outputLen == 0) {
         return false;
     }
 
-    // Calculate required buffer size
-    uint16_t estimatedSize = calculateTransactionSize(transaction);
-    uint8_t* buffer = (uint8_t*)malloc(estimatedSize + 100); // Add padding
-    if (!buffer) {
-        return false;
-    }
-    
-    // Serialize transaction
+    // Base58 converts the whole transaction as one number, so it needs the
+    // bytes contiguous; a packet-sized stack buffer replaces the old malloc
+    uint8_t buffer[SOLDUINO_MAX_TRANSACTION_SIZE];
     uint16_t serializedLen = 0;
-    if (!serializeTransaction(transaction, buffer, estimatedSize + 100, serializedLen)) {
-        free(buffer);
+    if (!serializeTransaction(transaction, buffer, sizeof(buffer), serializedLen)) {
         return false;
     }
     
-    // Encode to base58
-    size_t encodedLen = base58Encode(buffer, serializedLen, output, outputLen);
-    free(buffer);
-    
-    return encodedLen > 0;
+    // Encode to base58 (block engine: transactions are hundreds of bytes)
+    return base58EncodeLarge(buffer, serializedLen, output, outputLen) > 0;
+}
+
+bool TransactionSerializer::encodeTransaction(const TransactionBase& transaction, char* output, size_t outputLen,
+                                              TransactionEncoding encoding) {
+    switch (encoding) {
+        case TX_ENCODING_BASE64:
+            return encodeTransaction(transaction, output, outputLen);
+        case TX_ENCODING_BASE58:
+            return encodeTransactionBase58(transaction, output, outputLen);
+    }
+    return false;
 }
 
 // ============================================================================
@@ -329,7 +537,7 @@ size_t Base64::encode(const uint8_t* data, size_t dataLen, char* output, size_t
     }
     
     size_t i = 0, j = 0;
-    for (i = 0; i < dataLen - 2; i += 3) {
+    for (i = 0; i + 2 < dataLen; i += 3) {
         output[j++] = base64_chars[(data[i] >> 2) & 0x3F];
         output[j++] = base64_chars[((data[i] & 0x3) << 4) | ((data[i + 1] & 0xF0) >> 4)];
         output[j++] = base64_chars[((data[i + 1] & 0xF) << 2) | ((data[i + 2] & 0xC0) >> 6)];
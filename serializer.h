@@ -14,22 +14,23 @@
 // - Message serialization
 // ============================================================================
 
+// First byte of a versioned message: high bit set, version in the low bits
+#define MESSAGE_VERSION_PREFIX 0x80
+
+/**
+ * Transaction wire encodings accepted by the sendTransaction RPC
+ */
+enum TransactionEncoding {
+    TX_ENCODING_BASE64 = 0,
+    TX_ENCODING_BASE58 = 1
+};
+
 /**
  * Transaction Serializer
  * Handles serialization of Solana transactions to wire format
  */
 class TransactionSerializer {
 private:
-    /**
-     * Write a compact u16 value (variable-length encoding)
-     * @param buffer Output buffer
-     * @param offset Current offset (updated)
-     * @param maxLen Maximum buffer length
-     * @param value Value to write
-     * @return true if successful
-     */
-    static bool writeCompactU16(uint8_t* buffer, uint16_t& offset, uint16_t maxLen, uint16_t value);
-    
     /**
      * Serialize transaction header
      * @param buffer Output buffer
@@ -41,17 +42,15 @@ private:
     static bool serializeHeader(uint8_t* buffer, uint16_t& offset, uint16_t maxLen, const TransactionHeader& header);
     
     /**
-     * Serialize account keys array
+     * Serialize the static account keys, read straight from the message
      * @param buffer Output buffer
      * @param offset Current offset (updated)
      * @param maxLen Maximum buffer length
-     * @param accountKeys Array of account keys
-     * @param accountCount Number of accounts
+     * @param message Compiled message
      * @return true if successful
      */
     static bool serializeAccountKeys(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                     const uint8_t accountKeys[][SOLDUINO_PUBKEY_SIZE],
-                                     uint8_t accountCount);
+                                     const MessageBase& message);
     
     /**
      * Serialize recent blockhash
@@ -64,39 +63,69 @@ private:
     static bool serializeBlockhash(uint8_t* buffer, uint16_t& offset, uint16_t maxLen, const uint8_t* blockhash);
     
     /**
-     * Serialize compiled instructions
+     * Serialize the instructions of a message
      * @param buffer Output buffer
      * @param offset Current offset (updated)
      * @param maxLen Maximum buffer length
-     * @param instructions Array of instructions
-     * @param instructionCount Number of instructions
+     * @param message Compiled message
      * @return true if successful
      */
     static bool serializeInstructions(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                     const CompiledInstruction* instructions,
-                                     uint8_t instructionCount);
+                                     const MessageBase& message);
     
     /**
-     * Serialize a compiled instruction
+     * Serialize one instruction, mapping its keys to compiled indices
      * @param buffer Output buffer
      * @param offset Current offset (updated)
      * @param maxLen Maximum buffer length
-     * @param instruction Instruction to serialize
+     * @param message Compiled message
+     * @param index Instruction index
      * @return true if successful
      */
     static bool serializeInstruction(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
-                                    const CompiledInstruction& instruction);
+                                    const MessageBase& message, uint8_t index);
+    
+    /**
+     * Serialize the address table lookups of a v0 message
+     * @param buffer Output buffer
+     * @param offset Current offset (updated)
+     * @param maxLen Maximum buffer length
+     * @param message Compiled v0 message
+     * @return true if successful
+     */
+    static bool serializeAddressTableLookups(uint8_t* buffer, uint16_t& offset, uint16_t maxLen,
+                                             const MessageBase& message);
+    
+    /**
+     * Write the signature count and signatures of a transaction
+     * @param transaction Transaction whose signatures to write
+     * @param buffer Output buffer
+     * @param bufferLen Maximum buffer length
+     * @param offset Current offset (updated)
+     * @return false if the buffer is too small or a signature is missing
+     */
+    static bool writeSignatures(const TransactionBase& transaction, uint8_t* buffer, uint16_t bufferLen,
+                                uint16_t& offset);
+    
+    /**
+     * Write a message to wire format, bypassing its cache
+     * (used by Message::serialize() to fill that cache)
+     */
+    static bool writeMessage(const MessageBase& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen);
+    
+    friend class MessageBase;
 
 public:
     /**
-     * Serialize a message to wire format
+     * Serialize a message to wire format. The message's cache is copied
+     * when current; otherwise the message is written straight into buffer.
      * @param message Message to serialize
      * @param buffer Output buffer
      * @param bufferLen Maximum buffer length
      * @param serializedLen Output: actual serialized length
      * @return true if successful
      */
-    static bool serializeMessage(const Message& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen);
+    static bool serializeMessage(const MessageBase& message, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen);
     
     /**
      * Serialize a transaction to wire format
@@ -106,16 +135,27 @@ public:
      * @param serializedLen Output: actual serialized length
      * @return true if successful
      */
-    static bool serializeTransaction(const Transaction& transaction, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen);
+    static bool serializeTransaction(const TransactionBase& transaction, uint8_t* buffer, uint16_t bufferLen, uint16_t& serializedLen);
     
     /**
-     * Encode transaction to base64 string for RPC submission
-     * @param transaction Transaction to encode
+     * Encode a message to base64, as taken by getFeeForMessage
+     * @param message Message to encode
      * @param output Output string buffer
      * @param outputLen Maximum output length
      * @return true if successful
      */
-    static bool encodeTransaction(const Transaction& transaction, char* output, size_t outputLen);
+    static bool encodeMessage(const MessageBase& message, char* output, size_t outputLen);
+    
+    /**
+     * Encode transaction to base64 string for RPC submission. Encodes
+     * straight from the signatures and the cached message, with no
+     * intermediate buffer.
+     * @param transaction Transaction to encode
+     * @param output Output string buffer (see calculateEncodedSize())
+     * @param outputLen Maximum output length
+     * @return true if successful
+     */
+    static bool encodeTransaction(const TransactionBase& transaction, char* output, size_t outputLen);
     
     /**
      * Encode transaction to base58 string for RPC submission
@@ -124,21 +164,96 @@ public:
      * @param outputLen Maximum output length
      * @return true if successful
      */
-    static bool encodeTransactionBase58(const Transaction& transaction, char* output, size_t outputLen);
+    static bool encodeTransactionBase58(const TransactionBase& transaction, char* output, size_t outputLen);
+    
+    /**
+     * Encode transaction with an encoding chosen at runtime
+     * @param transaction Transaction to encode
+     * @param output Output string buffer
+     * @param outputLen Maximum output length
+     * @param encoding TX_ENCODING_BASE64 or TX_ENCODING_BASE58
+     * @return true if successful
+     */
+    static bool encodeTransaction(const TransactionBase& transaction, char* output, size_t outputLen,
+                                  TransactionEncoding encoding);
     
     /**
-     * Calculate serialized message size (for buffer allocation)
+     * Exact serialized message size
      * @param message Message to measure
-     * @return Estimated size in bytes
+     * @return Size in bytes
      */
-    static uint16_t calculateMessageSize(const Message& message);
+    static uint16_t calculateMessageSize(const MessageBase& message);
     
     /**
-     * Calculate serialized transaction size (for buffer allocation)
+     * Exact serialized transaction size, with the signatures placed so far
      * @param transaction Transaction to measure
-     * @return Estimated size in bytes
+     * @return Size in bytes
+     */
+    static uint16_t calculateTransactionSize(const TransactionBase& transaction);
+    
+    /**
+     * Output buffer size encodeTransaction() needs, terminator included
+     * (exact for Base64, an upper bound for Base58)
+     * @param transaction Transaction to encode
+     * @param encoding TX_ENCODING_BASE64 or TX_ENCODING_BASE58
+     * @return Size in bytes
+     */
+    static size_t calculateEncodedSize(const TransactionBase& transaction, TransactionEncoding encoding);
+    
+    /**
+     * Length of a compact-u16 (shortvec) encoding of value
+     * @return 1, 2 or 3
+     */
+    static uint8_t compactU16Size(uint16_t value);
+    
+    /**
+     * Wire size of a compiled instruction: program index, account
+     * indices, data
+     */
+    static uint16_t instructionSize(uint8_t accountCount, uint16_t dataLength);
+    
+    /**
+     * Wire size of the signature count and signatures
+     */
+    static uint32_t signaturesSize(uint8_t count);
+    
+    /**
+     * Wire size of a message from its compiled shape, as shared by
+     * calculateMessageSize() and InstructionPacker, which sizes messages
+     * before they are built
+     * @param versioned        v0 message (lookup tables attached)
+     * @param staticKeys       Account keys written in full
+     * @param instructionCount Number of instructions
+     * @param instructionBytes Sum of instructionSize() over them
+     * @param loadedWritable   Writable keys loaded from each table
+     * @param loadedReadonly   Readonly keys loaded from each table
+     * @param tableCount       Lookup tables attached
+     * @return Size in bytes, unclamped
+     */
+    static uint32_t messageSize(bool versioned, uint8_t staticKeys, uint8_t instructionCount,
+                                uint32_t instructionBytes, const uint8_t* loadedWritable,
+                                const uint8_t* loadedReadonly, uint8_t tableCount);
+    
+    /**
+     * Write a compact u16 value (variable-length encoding)
+     * @param buffer Output buffer
+     * @param offset Current offset (updated)
+     * @param maxLen Maximum buffer length
+     * @param value Value to write
+     * @return true if successful
+     */
+    static bool writeCompactU16(uint8_t* buffer, uint16_t& offset, uint16_t maxLen, uint16_t value);
+    
+    /**
+     * Read a compact u16 value. Strict, as validators are: at most 3
+     * bytes, no value above 0xFFFF and no redundant continuation bytes.
+     * @param buffer Input buffer
+     * @param length Input length
+     * @param offset Current offset (updated)
+     * @param value Output: value read
+     * @return false if the encoding is malformed or runs past length
      */
-    static uint16_t calculateTransactionSize(const Transaction& transaction);
+    static bool readCompactU16(const uint8_t* buffer, uint16_t length, uint16_t& offset, uint16_t& value);
 };
 
 /**
@@ -26,10 +26,8 @@ int Solduino::getVersionPatch() {
 }
 
 // Initialize library
-bool Solduino::begin() {
-    // Placeholder for future initialization logic
-    // e.g., setting up default configurations, checking prerequisites
-    return true;
+bool Solduino::begin(const CryptoBackend* backend) {
+    return cryptoBegin(backend);
 }
 
 // Cleanup library resources
@@ -44,6 +44,8 @@ enum SolduinoCommitment {
 // Forward declarations
 class RpcClient;
 
+struct CryptoBackend;
+
 /**
  * Solduino Core SDK Class
  * 
@@ -83,10 +85,13 @@ public:
     static int getVersionPatch();
     
     /**
-     * Initialize library (placeholder for future initialization logic)
+     * Initialize library: starts the crypto backend (one-time init and
+     * table warm-up) so no later crypto call pays for it.
+     * @param backend Crypto backend to select, e.g. &CRYPTO_BACKEND_REFERENCE;
+     *                nullptr keeps the SOLDUINO_CRYPTO_BACKEND default
      * @return true if initialization successful
      */
-    bool begin();
+    bool begin(const CryptoBackend* backend = nullptr);
     
     /**
      * Cleanup library resources
@@ -106,19 +111,26 @@ public:
 
 // RPC Communication Module
 #include "rpc_client.h"
+#include "tls_session.h"
 
 // Connection Management Module
 #include "connection.h"
 
 // Wallet Generation and Management Module
 #include "crypto.h"
+#include "crypto_backend.h"
 #include "keypair.h"
+#include "vanity.h"
 
 #include "instruction.h"
 
 // Transaction Signing Module
+#include "lookup_table.h"
 #include "transaction.h"
 #include "serializer.h"
+#include "transaction_template.h"
+#include "transaction_view.h"
+#include "packer.h"
 
 // Program Helpers & PDA Derivation
 #include "programs.h"
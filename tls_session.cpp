@@ -0,0 +1,407 @@
+#include "tls_session.h"
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef ESP32
+#include <Preferences.h>
+#else
+#include <stdio.h>
+#endif
+
+#if SOLDUINO_TLS_SESSIONS
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/version.h>
+#endif
+
+// ============================================================================
+// TLS Session Cache
+// ============================================================================
+
+// Serialized layout: "TLSC" | version | count | count x
+// [hostLen(1) | host | port (u16 LE) | length (u16 LE) | session],
+// oldest entry first.
+static const uint8_t TLS_CACHE_MAGIC[4] = {'T', 'L', 'S', 'C'};
+static const uint8_t TLS_CACHE_VERSION = 1;
+static const size_t TLS_CACHE_HEADER_LEN = 6;
+static const size_t TLS_CACHE_RECORD_HEADER_LEN = 5;
+
+#ifdef ESP32
+static const char TLS_CACHE_NVS_KEY[] = "tls";
+#endif
+
+TlsSessionCache::TlsSessionCache() {
+    clear();
+}
+
+int TlsSessionCache::lookup(const char* host, uint16_t port) const {
+    for (int i = 0; i < SOLDUINO_TLS_SESSION_SLOTS; i++) {
+        const Entry& e = entries[i];
+        if (e.length && e.port == port && strcmp(e.host, host) == 0) return i;
+    }
+    return -1;
+}
+
+const uint8_t* TlsSessionCache::find(const char* host, uint16_t port, size_t& length) {
+    int i = host ? lookup(host, port) : -1;
+    if (i < 0) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    entries[i].lastUsed = ++tick;
+    length = entries[i].length;
+    return entries[i].session;
+}
+
+bool TlsSessionCache::put(const char* host, uint16_t port, const uint8_t* session, size_t length) {
+    if (!host || !session || length == 0 || length > SOLDUINO_TLS_SESSION_SIZE) return false;
+    size_t hostLen = strlen(host);
+    if (hostLen >= SOLDUINO_TLS_SESSION_HOST_LEN) return false;
+
+    int slot = lookup(host, port);
+    if (slot < 0) {
+        // Free slot, else the least recently used one
+        slot = 0;
+        for (int i = 0; i < SOLDUINO_TLS_SESSION_SLOTS; i++) {
+            if (entries[i].length == 0) {
+                slot = i;
+                break;
+            }
+            if (entries[i].lastUsed < entries[slot].lastUsed) slot = i;
+        }
+    }
+
+    Entry& e = entries[slot];
+    memcpy(e.host, host, hostLen + 1);
+    e.port = port;
+    e.length = (uint16_t)length;
+    e.lastUsed = ++tick;
+    memcpy(e.session, session, length);
+    dirty = true;
+    return true;
+}
+
+void TlsSessionCache::remove(const char* host, uint16_t port) {
+    int i = host ? lookup(host, port) : -1;
+    if (i < 0) return;
+    memset(&entries[i], 0, sizeof(Entry));
+    dirty = true;
+}
+
+void TlsSessionCache::clear() {
+    memset(entries, 0, sizeof(entries));
+    tick = 0;
+    hits = 0;
+    misses = 0;
+    dirty = false;
+}
+
+size_t TlsSessionCache::size() const {
+    size_t n = 0;
+    for (int i = 0; i < SOLDUINO_TLS_SESSION_SLOTS; i++) {
+        if (entries[i].length) n++;
+    }
+    return n;
+}
+
+size_t TlsSessionCache::savedSize() const {
+    size_t len = TLS_CACHE_HEADER_LEN;
+    for (int i = 0; i < SOLDUINO_TLS_SESSION_SLOTS; i++) {
+        const Entry& e = entries[i];
+        if (e.length) len += TLS_CACHE_RECORD_HEADER_LEN + strlen(e.host) + e.length;
+    }
+    return len;
+}
+
+size_t TlsSessionCache::saveTo(uint8_t* buffer, size_t length) const {
+    size_t len = savedSize();
+    if (!buffer || length < len) return 0;
+
+    // Oldest first, so loading re-inserts in LRU order
+    int order[SOLDUINO_TLS_SESSION_SLOTS];
+    size_t n = 0;
+    for (int i = 0; i < SOLDUINO_TLS_SESSION_SLOTS; i++) {
+        if (!entries[i].length) continue;
+        size_t j = n++;
+        while (j > 0 && entries[order[j - 1]].lastUsed > entries[i].lastUsed) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    memcpy(buffer, TLS_CACHE_MAGIC, 4);
+    buffer[4] = TLS_CACHE_VERSION;
+    buffer[5] = (uint8_t)n;
+    uint8_t* p = buffer + TLS_CACHE_HEADER_LEN;
+    for (size_t i = 0; i < n; i++) {
+        const Entry& e = entries[order[i]];
+        size_t hostLen = strlen(e.host);
+        p[0] = (uint8_t)hostLen;
+        memcpy(p + 1, e.host, hostLen);
+        p += 1 + hostLen;
+        p[0] = (uint8_t)e.port;
+        p[1] = (uint8_t)(e.port >> 8);
+        p[2] = (uint8_t)e.length;
+        p[3] = (uint8_t)(e.length >> 8);
+        memcpy(p + 4, e.session, e.length);
+        p += 4 + e.length;
+    }
+    return len;
+}
+
+bool TlsSessionCache::loadFrom(const uint8_t* buffer, size_t length) {
+    if (!buffer || length < TLS_CACHE_HEADER_LEN ||
+        memcmp(buffer, TLS_CACHE_MAGIC, 4) != 0 || buffer[4] != TLS_CACHE_VERSION ||
+        buffer[5] > SOLDUINO_TLS_SESSION_SLOTS) {
+        return false;
+    }
+
+    // Validate every record before touching the table
+    size_t n = buffer[5];
+    const uint8_t* end = buffer + length;
+    const uint8_t* p = buffer + TLS_CACHE_HEADER_LEN;
+    for (size_t i = 0; i < n; i++) {
+        if (end - p < (ptrdiff_t)TLS_CACHE_RECORD_HEADER_LEN) return false;
+        size_t hostLen = p[0];
+        if (hostLen >= SOLDUINO_TLS_SESSION_HOST_LEN ||
+            end - p < (ptrdiff_t)(TLS_CACHE_RECORD_HEADER_LEN + hostLen)) {
+            return false;
+        }
+        const uint8_t* q = p + 1 + hostLen;
+        size_t sessionLen = (size_t)q[2] | ((size_t)q[3] << 8);
+        if (sessionLen == 0 || sessionLen > SOLDUINO_TLS_SESSION_SIZE || end - (q + 4) < (ptrdiff_t)sessionLen) {
+            return false;
+        }
+        p = q + 4 + sessionLen;
+    }
+    // The header's record count ends the table; whatever follows in a
+    // fixed-size buffer (an RTC array) is ignored
+
+    clear();
+    p = buffer + TLS_CACHE_HEADER_LEN;
+    for (size_t i = 0; i < n; i++) {
+        char host[SOLDUINO_TLS_SESSION_HOST_LEN];
+        size_t hostLen = p[0];
+        memcpy(host, p + 1, hostLen);
+        host[hostLen] = '\0';
+        const uint8_t* q = p + 1 + hostLen;
+        uint16_t port = (uint16_t)(q[0] | (q[1] << 8));
+        size_t sessionLen = (size_t)q[2] | ((size_t)q[3] << 8);
+        put(host, port, q + 4, sessionLen);
+        p = q + 4 + sessionLen;
+    }
+    dirty = false;
+    return true;
+}
+
+bool TlsSessionCache::save(const char* name) {
+    if (!name) return false;
+    if (!dirty) return true;
+
+    size_t len = savedSize();
+    uint8_t* buf = (uint8_t*)malloc(len);
+    if (!buf) return false;
+    saveTo(buf, len);
+
+    bool ok = false;
+#ifdef ESP32
+    Preferences prefs;
+    if (prefs.begin(name, false)) {
+        ok = prefs.putBytes(TLS_CACHE_NVS_KEY, buf, len) == len;
+        prefs.end();
+    }
+#else
+    FILE* f = fopen(name, "wb");
+    if (f) {
+        ok = fwrite(buf, 1, len, f) == len;
+        ok = (fclose(f) == 0) && ok;
+    }
+#endif
+    memset(buf, 0, len);
+    free(buf);
+
+    if (ok) dirty = false;
+    return ok;
+}
+
+bool TlsSessionCache::load(const char* name) {
+    if (!name) return false;
+
+    size_t maxLen = TLS_CACHE_HEADER_LEN + SOLDUINO_TLS_SESSION_SLOTS *
+        (TLS_CACHE_RECORD_HEADER_LEN + SOLDUINO_TLS_SESSION_HOST_LEN + SOLDUINO_TLS_SESSION_SIZE);
+    uint8_t* buf = (uint8_t*)malloc(maxLen);
+    if (!buf) return false;
+
+    size_t len = 0;
+#ifdef ESP32
+    Preferences prefs;
+    if (prefs.begin(name, true)) {
+        size_t stored = prefs.getBytesLength(TLS_CACHE_NVS_KEY);
+        if (stored > 0 && stored <= maxLen) {
+            len = prefs.getBytes(TLS_CACHE_NVS_KEY, buf, stored);
+        }
+        prefs.end();
+    }
+#else
+    FILE* f = fopen(name, "rb");
+    if (f) {
+        len = fread(buf, 1, maxLen, f);
+        // Anything beyond maxLen means the file is not ours (or too big)
+        if (fgetc(f) != EOF) len = 0;
+        fclose(f);
+    }
+#endif
+
+    bool ok = len > 0 && loadFrom(buf, len);
+    memset(buf, 0, maxLen);
+    free(buf);
+    return ok;
+}
+
+#if SOLDUINO_TLS_SESSIONS
+
+// ============================================================================
+// Resumable WiFiClientSecure
+// ============================================================================
+
+#if MBEDTLS_VERSION_MAJOR >= 3
+#define SESSION_MASTER(s) ((s).MBEDTLS_PRIVATE(master))
+#else
+#define SESSION_MASTER(s) ((s).master)
+#endif
+
+int ResumableClientSecure::connect(const char* host, uint16_t port, int32_t timeout) {
+    _timeout = timeout;
+    return connect(host, port);
+}
+
+int ResumableClientSecure::connect(const char* host, uint16_t port) {
+    resumed = false;
+    if (!cache || !_use_insecure || (_pskIdent && _psKey)) {
+        return WiFiClientSecure::connect(host, port);
+    }
+
+    int ret = handshake(host, port);
+    _lastError = ret;
+    if (ret < 0) {
+        stop();
+        return 0;
+    }
+    _connected = true;
+    return 1;
+}
+
+/**
+ * start_ssl_client() for setInsecure() connections, with the cached
+ * session set between mbedtls_ssl_setup() and the handshake.
+ */
+int ResumableClientSecure::handshake(const char* host, uint16_t port) {
+    stop();
+
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) return -1;
+
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return -1;
+    sslclient->socket = fd;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+
+    struct timeval tv;
+    tv.tv_sec = _timeout / 1000;
+    tv.tv_usec = (_timeout % 1000) * 1000;
+    lwip_setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    lwip_setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    if (lwip_connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) return -1;
+
+    int enable = 1;
+    lwip_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    lwip_setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable));
+    lwip_fcntl(fd, F_SETFL, lwip_fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    mbedtls_ssl_init(&sslclient->ssl_ctx);
+    mbedtls_ssl_config_init(&sslclient->ssl_conf);
+    mbedtls_ctr_drbg_init(&sslclient->drbg_ctx);
+    mbedtls_entropy_init(&sslclient->entropy_ctx);
+
+    static const char pers[] = "solduino_tls";
+    int ret = mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func, &sslclient->entropy_ctx,
+                                    (const unsigned char*)pers, sizeof(pers) - 1);
+    if (ret != 0) return ret;
+    ret = mbedtls_ssl_config_defaults(&sslclient->ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0) return ret;
+    mbedtls_ssl_conf_authmode(&sslclient->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&sslclient->ssl_conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    mbedtls_ssl_conf_session_tickets(&sslclient->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    if (_alpn_protos) {
+        mbedtls_ssl_conf_alpn_protocols(&sslclient->ssl_conf, _alpn_protos);
+    }
+
+    ret = mbedtls_ssl_setup(&sslclient->ssl_ctx, &sslclient->ssl_conf);
+    if (ret != 0) return ret;
+    ret = mbedtls_ssl_set_hostname(&sslclient->ssl_ctx, host);
+    if (ret != 0) return ret;
+    mbedtls_ssl_set_bio(&sslclient->ssl_ctx, &sslclient->socket, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+    // Offer the cached session; the server either resumes it or falls
+    // back to a full handshake
+    mbedtls_ssl_session offered;
+    mbedtls_ssl_session_init(&offered);
+    bool offering = false;
+    size_t savedLen = 0;
+    const uint8_t* saved = cache->find(host, port, savedLen);
+    if (saved) {
+        offering = mbedtls_ssl_session_load(&offered, saved, savedLen) == 0 &&
+                   mbedtls_ssl_set_session(&sslclient->ssl_ctx, &offered) == 0;
+        if (!offering) cache->remove(host, port);
+    }
+
+    unsigned long start = millis();
+    while ((ret = mbedtls_ssl_handshake(&sslclient->ssl_ctx)) != 0) {
+        if ((ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+            millis() - start > (unsigned long)_timeout) {
+            mbedtls_ssl_session_free(&offered);
+            if (offering) cache->remove(host, port);
+            return ret != 0 ? ret : -1;
+        }
+        vTaskDelay(2);
+    }
+
+    // Resumption keeps the master secret; a full handshake derives a new one
+    mbedtls_ssl_session current;
+    mbedtls_ssl_session_init(&current);
+    if (mbedtls_ssl_get_session(&sslclient->ssl_ctx, &current) == 0) {
+        resumed = offering && memcmp(SESSION_MASTER(current), SESSION_MASTER(offered),
+                                     sizeof(SESSION_MASTER(current))) == 0;
+
+        // Stored even when resumed: the server may have issued a new ticket
+        uint8_t* buf = (uint8_t*)malloc(SOLDUINO_TLS_SESSION_SIZE);
+        size_t len = 0;
+        if (buf && mbedtls_ssl_session_save(&current, buf, SOLDUINO_TLS_SESSION_SIZE, &len) == 0) {
+            cache->put(host, port, buf, len);
+        }
+        if (buf) {
+            memset(buf, 0, SOLDUINO_TLS_SESSION_SIZE);
+            free(buf);
+        }
+    }
+    mbedtls_ssl_session_free(&current);
+    mbedtls_ssl_session_free(&offered);
+    return 0;
+}
+
+#endif // SOLDUINO_TLS_SESSIONS
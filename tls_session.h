@@ -0,0 +1,173 @@
+#ifndef SOLDUINO_TLS_SESSION_H
+#define SOLDUINO_TLS_SESSION_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <WiFiClientSecure.h>
+
+// Resuming needs a hook between mbedtls_ssl_setup() and the handshake,
+// which only the mbedTLS-based ESP32 WiFiClientSecure lets us reach
+#ifndef SOLDUINO_TLS_SESSIONS
+#ifdef ESP32
+#define SOLDUINO_TLS_SESSIONS 1
+#else
+#define SOLDUINO_TLS_SESSIONS 0
+#endif
+#endif
+
+// Endpoints remembered at once; the least recently used one is evicted
+#ifndef SOLDUINO_TLS_SESSION_SLOTS
+#define SOLDUINO_TLS_SESSION_SLOTS 2
+#endif
+
+// Largest serialized session kept. mbedTLS stores the server's leaf
+// certificate in it (MBEDTLS_SSL_KEEP_PEER_CERTIFICATE), so allow ~2 KB
+#ifndef SOLDUINO_TLS_SESSION_SIZE
+#define SOLDUINO_TLS_SESSION_SIZE 2048
+#endif
+
+#ifndef SOLDUINO_TLS_SESSION_HOST_LEN
+#define SOLDUINO_TLS_SESSION_HOST_LEN 64
+#endif
+
+/**
+ * TLS sessions (session ID or ticket, master secret) per host and port,
+ * so a reconnect after deep sleep or a Wi-Fi drop can resume with an
+ * abbreviated handshake instead of a full key exchange.
+ *
+ * Entries are opaque serialized sessions (mbedtls_ssl_session_save());
+ * a session the server no longer accepts just costs one full handshake,
+ * after which the fresh session replaces it.
+ *
+ * The table lives in RAM. save()/load() persist it like PdaCache: an NVS
+ * blob on ESP32, a file elsewhere. saveTo()/loadFrom() copy it to a
+ * caller buffer, e.g. RTC memory that survives deep sleep:
+ *
+ *   RTC_DATA_ATTR uint8_t rtcSessions[2400];
+ *   TlsSessionCache sessions;
+ *   sessions.loadFrom(rtcSessions, sizeof(rtcSessions));   // after wake
+ *   rpc.setSessionCache(&sessions);
+ *   ...
+ *   sessions.saveTo(rtcSessions, sizeof(rtcSessions));     // before sleep
+ *
+ * Sessions hold the master secret: keep saved copies as private as keys.
+ */
+class TlsSessionCache {
+public:
+    TlsSessionCache();
+
+    /**
+     * Look up the session for an endpoint and mark it recently used.
+     * @param length Set to the session's length on a hit
+     * @return Pointer into the cache, valid until the next put()/remove(),
+     *         or nullptr
+     */
+    const uint8_t* find(const char* host, uint16_t port, size_t& length);
+
+    /**
+     * Store (or replace) the session for an endpoint.
+     * @return false if host or session exceed the configured sizes
+     */
+    bool put(const char* host, uint16_t port, const uint8_t* session, size_t length);
+
+    /** Forget an endpoint, e.g. after the server rejected its session */
+    void remove(const char* host, uint16_t port);
+
+    /** Drop every entry and reset the counters */
+    void clear();
+
+    /** @return number of cached sessions */
+    size_t size() const;
+
+    /** @return lookups that found a session */
+    uint32_t getHits() const { return hits; }
+
+    /** @return lookups that found none */
+    uint32_t getMisses() const { return misses; }
+
+    /**
+     * Persist the table.
+     * @param name NVS namespace on ESP32, file path elsewhere
+     * @return true on success (or if nothing changed since the last save/load)
+     */
+    bool save(const char* name);
+
+    /**
+     * Restore a table written by save(). Existing entries are replaced.
+     * @param name NVS namespace on ESP32, file path elsewhere
+     * @return true if a valid table was loaded
+     */
+    bool load(const char* name);
+
+    /**
+     * Serialize the table into a caller buffer.
+     * @return bytes written, or 0 if the buffer is too small
+     */
+    size_t saveTo(uint8_t* buffer, size_t length) const;
+
+    /**
+     * Restore a table written by saveTo(); existing entries are replaced.
+     * length may exceed what saveTo() wrote: bytes after the table are
+     * ignored, so a fixed buffer can be passed whole.
+     */
+    bool loadFrom(const uint8_t* buffer, size_t length);
+
+    /** @return bytes saveTo() needs for the current entries */
+    size_t savedSize() const;
+
+private:
+    struct Entry {
+        char host[SOLDUINO_TLS_SESSION_HOST_LEN];
+        uint16_t port;
+        uint16_t length;     // 0 = free slot
+        uint32_t lastUsed;   // LRU tick
+        uint8_t session[SOLDUINO_TLS_SESSION_SIZE];
+    };
+
+    Entry entries[SOLDUINO_TLS_SESSION_SLOTS];
+    uint32_t tick;
+    uint32_t hits;
+    uint32_t misses;
+    bool dirty;
+
+    int lookup(const char* host, uint16_t port) const;
+};
+
+#if SOLDUINO_TLS_SESSIONS
+
+/**
+ * WiFiClientSecure that offers a cached session on connect and stores the
+ * session it ends up with. With no cache set, or with certificate
+ * validation configured (only setInsecure() connections are handled
+ * here), it behaves exactly like WiFiClientSecure.
+ */
+class ResumableClientSecure : public WiFiClientSecure {
+public:
+    using WiFiClientSecure::connect;
+
+    void setSessionCache(TlsSessionCache* cache) { this->cache = cache; }
+    TlsSessionCache* getSessionCache() const { return cache; }
+
+    int connect(const char* host, uint16_t port) override;
+    int connect(const char* host, uint16_t port, int32_t timeout) override;
+
+    /** @return true if the last connect() resumed a cached session */
+    bool isResumed() const { return resumed; }
+
+private:
+    TlsSessionCache* cache = nullptr;
+    bool resumed = false;
+
+    int handshake(const char* host, uint16_t port);
+};
+
+typedef ResumableClientSecure RpcSecureClient;
+
+#else
+
+typedef WiFiClientSecure RpcSecureClient;
+
+#endif // SOLDUINO_TLS_SESSIONS
+
+#endif // SOLDUINO_TLS_SESSION_H
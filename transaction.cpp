@@ -2,45 +2,91 @@
 #include "serializer.h"
 #include "crypto.h"
 #include "keypair.h"
+#include "crypto_backend.h"
 #include <string.h>
 
+#if SOLDUINO_SIGN_THREADS
+#include <atomic>
+#include "worker_pool.h"
+#endif
+
 // ============================================================================
 // Message Implementation
 // ============================================================================
 
-Message::Message() {
-    memset(&header, 0, sizeof(header));
-    memset(accountKeys, 0, sizeof(accountKeys));
-    accountCount = 0;
-    memset(recentBlockhash, 0, sizeof(recentBlockhash));
-    memset(instructions, 0, sizeof(instructions));
-    instructionCount = 0;
+bool MessageBase::isValidAccountIndex(uint8_t index) const {
+    return index < accountCount;
 }
 
-bool Message::isValidAccountIndex(uint8_t index) const {
-    return index < accountCount;
+// Slot for a key in keySlots. Pubkeys are hashes or curve points, so their
+// leading bytes are already uniform; the all-zero System Program lands on 0.
+static uint8_t keySlotFor(const uint8_t* pubkey, uint16_t slotCount) {
+    uint32_t h = (uint32_t)pubkey[0] | ((uint32_t)pubkey[1] << 8) |
+                 ((uint32_t)pubkey[2] << 16) | ((uint32_t)pubkey[3] << 24);
+    return h % slotCount;
+}
+
+uint8_t MessageBase::lookupKey(const uint8_t* pubkey) const {
+    for (uint16_t slot = keySlotFor(pubkey, keySlotCount());; slot = (slot + 1) % keySlotCount()) {
+        uint8_t entry = keySlots[slot];
+        if (entry == 0) {
+            return 255; // Not found
+        }
+        if (memcmp(accountKeys[entry - 1], pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
+            return entry - 1;
+        }
+    }
 }
 
-uint8_t Message::findAccountIndex(const uint8_t* pubkey) const {
+uint8_t MessageBase::recordKey(const uint8_t* pubkey, uint8_t flags) {
+    uint16_t slot = keySlotFor(pubkey, keySlotCount());
+    for (;; slot = (slot + 1) % keySlotCount()) {
+        uint8_t entry = keySlots[slot];
+        if (entry == 0) {
+            break;
+        }
+        if (memcmp(accountKeys[entry - 1], pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
+            // Already present: keep the strongest privileges asked for
+            if ((accountFlags[entry - 1] | flags) != accountFlags[entry - 1]) {
+                accountFlags[entry - 1] |= flags;
+                markDirty();
+            }
+            return entry - 1;
+        }
+    }
+    
+    if (accountCount >= maxAccounts) {
+        return 255;
+    }
+    memcpy(accountKeys[accountCount], pubkey, SOLDUINO_PUBKEY_SIZE);
+    accountFlags[accountCount] = flags;
+    keySlots[slot] = ++accountCount;
+    markDirty();
+    return accountCount - 1;
+}
+
+uint8_t MessageBase::findAccountIndex(const uint8_t* pubkey) const {
     if (!pubkey) return 255;
     
-    for (uint8_t i = 0; i < accountCount; i++) {
-        if (memcmp(accountKeys[i], pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
-            return i;
-        }
+    uint8_t key = lookupKey(pubkey);
+    if (key == 255) {
+        return 255;
     }
-    return 255; // Not found
+    compile();
+    return accountPosition[key];
 }
 
-int8_t Message::addAccount(const uint8_t* pubkey, bool isSigner, bool isWritable) {
-    if (!pubkey || accountCount >= MAX_ACCOUNTS) {
+int8_t MessageBase::addAccount(const uint8_t* pubkey, bool isSigner, bool isWritable) {
+    if (!pubkey) {
         return -1;
     }
-    
-    // Check if account already exists
-    uint8_t existingIndex = findAccountIndex(pubkey);
-    if (existingIndex != 255) {
-        return existingIndex;
+    uint8_t key = recordKey(pubkey, (isSigner ? KEY_SIGNER : 0) | (isWritable ? KEY_WRITABLE : 0));
+    return key == 255 ? -1 : (int8_t)key;
+}
+
+void MessageBase::compile() const {
+    if (compiled) {
+        return;
     }
     
     // Solana requires accounts to be ordered as:
@@ -48,148 +94,348 @@ int8_t Message::addAccount(const uint8_t* pubkey, bool isSigner, bool isWritable
     // 2. Readonly signers
     // 3. Writable non-signers
     // 4. Readonly non-signers
-    // Find the correct insertion point
-    uint8_t insertIndex = accountCount;
-    
-    if (isSigner) {
-        if (isWritable) {
-            // Writable signer: insert at position (numRequiredSignatures - numReadonlySignedAccounts)
-            // This is after existing writable signers, before readonly signers
-            insertIndex = header.numRequiredSignatures - header.numReadonlySignedAccounts;
-        } else {
-            // Readonly signer: insert at position numRequiredSignatures (after all signers)
-            insertIndex = header.numRequiredSignatures;
-        }
-    } else {
-        if (isWritable) {
-            // Writable non-signer: insert after all signers, before readonly non-signers
-            // Position: accountCount - numReadonlyUnsignedAccounts
-            insertIndex = accountCount - header.numReadonlyUnsignedAccounts;
-        } else {
-            // Readonly non-signer: insert at the end
-            insertIndex = accountCount;
-        }
+    // followed, in v0 messages, by keys loaded from lookup tables: bucket
+    // 4 + t holds writable keys from table t, 4 + T + t readonly ones.
+    // A counting sort keeps insertion order within each bucket, so the
+    // first writable signer added (the fee payer) ends up at index 0.
+    const uint8_t T = SOLDUINO_MAX_LOOKUP_TABLES;
+    uint8_t bucketStart[4 + 2 * SOLDUINO_MAX_LOOKUP_TABLES + 1];
+    uint8_t keyBucket[SOLDUINO_ACCOUNT_LIMIT];
+    uint8_t keyEntry[SOLDUINO_ACCOUNT_LIMIT];
+    memset(bucketStart, 0, sizeof(bucketStart));
+    for (uint8_t i = 0; i < accountCount; i++) {
+        keyBucket[i] = classifyKey(accountKeys[i], accountFlags[i], keyEntry[i]);
+        bucketStart[keyBucket[i] + 1]++;
     }
     
-    // Shift existing accounts to make room if needed
-    if (insertIndex < accountCount) {
-        for (uint8_t i = accountCount; i > insertIndex; i--) {
-            memcpy(accountKeys[i], accountKeys[i-1], SOLDUINO_PUBKEY_SIZE);
-        }
+    header.numRequiredSignatures = bucketStart[1] + bucketStart[2];
+    header.numReadonlySignedAccounts = bucketStart[2];
+    header.numReadonlyUnsignedAccounts = bucketStart[4];
+    staticAccountCount = bucketStart[1] + bucketStart[2] + bucketStart[3] + bucketStart[4];
+    for (uint8_t t = 0; t < T; t++) {
+        lookupWritableCounts[t] = bucketStart[4 + t + 1];
+        lookupReadonlyCounts[t] = bucketStart[4 + T + t + 1];
     }
     
-    // Insert the new account
-    memcpy(accountKeys[insertIndex], pubkey, SOLDUINO_PUBKEY_SIZE);
-    accountCount++;
-    
-    // Update header based on account type
-    if (isSigner) {
-        header.numRequiredSignatures++;
-        if (!isWritable) {
-            header.numReadonlySignedAccounts++;
-        }
-    } else {
-        if (!isWritable) {
-            header.numReadonlyUnsignedAccounts++;
+    for (uint8_t b = 1; b < sizeof(bucketStart); b++) {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+    for (uint8_t i = 0; i < accountCount; i++) {
+        uint8_t position = bucketStart[keyBucket[i]]++;
+        accountOrder[position] = i;
+        accountPosition[i] = position;
+        if (position >= staticAccountCount) {
+            lookupIndexes[position - staticAccountCount] = keyEntry[i];
         }
     }
     
-    return insertIndex;
+    compiled = true;
 }
 
-bool Message::setRecentBlockhash(const uint8_t* blockhash) {
+uint8_t MessageBase::classifyKey(const uint8_t* pubkey, uint8_t flags, uint8_t& entry) const {
+    if (!(flags & (KEY_SIGNER | KEY_INVOKED))) {
+        for (uint8_t t = 0; t < lookupTableCount; t++) {
+            int16_t found = lookupTables[t]->find(pubkey);
+            if (found >= 0) {
+                entry = (uint8_t)found;
+                return 4 + ((flags & KEY_WRITABLE) ? t : SOLDUINO_MAX_LOOKUP_TABLES + t);
+            }
+        }
+    }
+    return ((flags & KEY_SIGNER) ? 0 : 2) + ((flags & KEY_WRITABLE) ? 0 : 1);
+}
+
+const uint8_t* MessageBase::serialize(uint16_t& length) const {
+    if (serializedLength == 0 &&
+        !TransactionSerializer::writeMessage(*this, serialized, serializedCapacity, serializedLength)) {
+        serializedLength = 0;
+        return nullptr;
+    }
+    length = serializedLength;
+    return serialized;
+}
+
+bool MessageBase::setRecentBlockhash(const uint8_t* blockhash) {
     if (!blockhash) return false;
     memcpy(recentBlockhash, blockhash, BLOCKHASH_SIZE);
+    serializedLength = 0;
     return true;
 }
 
-bool Message::addInstruction(const uint8_t* programId,
-                             const uint8_t* accounts[],
-                             uint8_t accountCount,
-                             const uint8_t* data,
-                             uint16_t dataLength) {
-    if (!programId || instructionCount >= MAX_INSTRUCTIONS) {
-        return false;
-    }
+bool MessageBase::recordInstruction(uint8_t programKey,
+                                    const uint8_t* accountKeyIndices,
+                                    uint8_t accountCount,
+                                    const uint8_t* data,
+                                    uint16_t dataLength) {
+    memcpy(keysOf(instructionCount) + 1, accountKeyIndices, accountCount);
+    if (!data) {
+        dataLength = 0;
+    }
+    if (dataLength > 0) {
+        memcpy(instructionData + dataUsed, data, dataLength);
+    }
+    return commitInstruction(programKey, accountCount, dataLength);
+}
+
+bool MessageBase::commitInstruction(uint8_t programKey, uint8_t accountCount, uint16_t dataLength) {
+    // The account keys are already in the instruction's row and the data
+    // at the free end of the pool; claim them
+    MessageInstruction& inst = instructions[instructionCount];
+    keysOf(instructionCount)[0] = programKey;
+    accountFlags[programKey] |= KEY_INVOKED;
+    inst.accountCount = accountCount;
+    inst.dataOffset = dataUsed;
+    inst.dataLength = dataLength;
+    dataUsed += dataLength;
     
-    if (dataLength > MAX_INSTRUCTION_DATA) {
+    instructionCount++;
+    markDirty();
+    return true;
+}
+
+bool MessageBase::addInstruction(const uint8_t* programId,
+                                 const uint8_t* accounts[],
+                                 uint8_t accountCount,
+                                 const uint8_t* data,
+                                 uint16_t dataLength) {
+    if (!programId || instructionCount >= maxInstructions) {
         return false;
     }
     
-    CompiledInstruction& inst = instructions[instructionCount];
-    
-    // Find or add program ID account
-    int8_t programIdIndex = findAccountIndex(programId);
-    if (programIdIndex == 255) {
-        // Add program ID as readonly unsigned account
-        programIdIndex = addAccount(programId, false, false);
-        if (programIdIndex < 0) {
-            return false;
-        }
+    if (dataLength > maxData - dataUsed) {
+        return false;
     }
-    inst.programIdIndex = programIdIndex;
     
-    // Add instruction accounts
-    inst.accountCount = 0;
-    for (uint8_t i = 0; i < accountCount && inst.accountCount < MAX_ACCOUNTS; i++) {
+    // Resolve instruction accounts before touching the key table
+    uint8_t keys[SOLDUINO_ACCOUNT_LIMIT];
+    uint8_t keyCount = 0;
+    for (uint8_t i = 0; i < accountCount && keyCount < maxAccounts; i++) {
         if (accounts[i]) {
-            int8_t accountIndex = findAccountIndex(accounts[i]);
-            if (accountIndex == 255) {
+            uint8_t key = lookupKey(accounts[i]);
+            if (key == 255) {
                 // Account not found - this is an error, accounts must be added first
                 return false;
             }
-            inst.accountIndices[inst.accountCount++] = accountIndex;
+            keys[keyCount++] = key;
         }
     }
     
-    // Copy instruction data
-    if (data && dataLength > 0) {
-        memcpy(inst.data, data, dataLength);
-        inst.dataLength = dataLength;
-    } else {
-        inst.dataLength = 0;
+    // Find or add program ID as readonly unsigned account
+    uint8_t programKey = recordKey(programId, 0);
+    if (programKey == 255) {
+        return false;
     }
     
-    instructionCount++;
-    return true;
+    return recordInstruction(programKey, keys, keyCount, data, dataLength);
 }
 
-bool Message::getAccount(uint8_t index, uint8_t* pubkey) const {
+bool MessageBase::getAccount(uint8_t index, uint8_t* pubkey) const {
     if (!pubkey || !isValidAccountIndex(index)) {
         return false;
     }
-    memcpy(pubkey, accountKeys[index], SOLDUINO_PUBKEY_SIZE);
+    compile();
+    memcpy(pubkey, accountKeys[accountOrder[index]], SOLDUINO_PUBKEY_SIZE);
     return true;
 }
 
-bool Message::getRecentBlockhash(uint8_t* blockhash) const {
+bool MessageBase::getRecentBlockhash(uint8_t* blockhash) const {
     if (!blockhash) return false;
     memcpy(blockhash, recentBlockhash, BLOCKHASH_SIZE);
     return true;
 }
 
-void Message::reset() {
+void MessageBase::reset() {
     memset(&header, 0, sizeof(header));
-    memset(accountKeys, 0, sizeof(accountKeys));
+    memset(accountKeys, 0, (size_t)maxAccounts * SOLDUINO_PUBKEY_SIZE);
+    memset(accountFlags, 0, maxAccounts);
     accountCount = 0;
+    memset(keySlots, 0, keySlotCount());
     memset(recentBlockhash, 0, sizeof(recentBlockhash));
-    memset(instructions, 0, sizeof(instructions));
+    memset(instructionKeys, 0, (size_t)maxInstructions * (maxAccounts + 1));
+    memset(instructions, 0, maxInstructions * sizeof(MessageInstruction));
     instructionCount = 0;
+    dataUsed = 0;
+    memset(lookupTables, 0, sizeof(lookupTables));
+    lookupTableCount = 0;
+    staticAccountCount = 0;
+    memset(lookupWritableCounts, 0, sizeof(lookupWritableCounts));
+    memset(lookupReadonlyCounts, 0, sizeof(lookupReadonlyCounts));
+    compiled = true;
+    serializedLength = 0;
+}
+
+bool MessageBase::assign(const MessageBase& other) {
+    if (&other == this) {
+        return true;
+    }
+    
+    // Re-recording in the same order rebuilds this message's hash slots
+    // and reproduces the other's key table indexes, so instruction keys
+    // carry over unchanged
+    reset();
+    for (uint8_t i = 0; i < other.accountCount; i++) {
+        if (recordKey(other.accountKeys[i], other.accountFlags[i]) == 255) {
+            reset();
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < other.instructionCount; i++) {
+        const MessageInstruction& inst = other.instructions[i];
+        const uint8_t* keys = other.keysOf(i);
+        if (instructionCount >= maxInstructions || inst.accountCount > maxAccounts ||
+            inst.dataLength > maxData - dataUsed) {
+            reset();
+            return false;
+        }
+        recordInstruction(keys[0], keys + 1, inst.accountCount,
+                          other.instructionData + inst.dataOffset, inst.dataLength);
+    }
+    memcpy(lookupTables, other.lookupTables, sizeof(lookupTables));
+    lookupTableCount = other.lookupTableCount;
+    memcpy(recentBlockhash, other.recentBlockhash, BLOCKHASH_SIZE);
+    markDirty();
+    return true;
+}
+
+bool MessageBase::addLookupTable(const AddressLookupTable* table) {
+    if (!table || !table->isLoaded() || !table->isActive()) {
+        return false;
+    }
+    for (uint8_t t = 0; t < lookupTableCount; t++) {
+        if (lookupTables[t] == table) {
+            return true;
+        }
+    }
+    if (lookupTableCount >= SOLDUINO_MAX_LOOKUP_TABLES) {
+        return false;
+    }
+    lookupTables[lookupTableCount++] = table;
+    markDirty();
+    return true;
+}
+
+// ============================================================================
+// InstructionEncoder Implementation
+// ============================================================================
+
+InstructionEncoder::InstructionEncoder(MessageBase& message) : message(message) {
+    memset(programId, 0, sizeof(programId));
+    hasProgram = false;
+    keyCount = 0;
+    dataLength = 0;
+    failed = message.instructionCount >= message.maxInstructions;
+}
+
+bool InstructionEncoder::setProgram(const uint8_t* programId) {
+    if (!programId || failed) {
+        failed = true;
+        return false;
+    }
+    // Copied: the program is recorded after the accounts, as add() does
+    memcpy(this->programId, programId, SOLDUINO_PUBKEY_SIZE);
+    hasProgram = true;
+    return true;
+}
+
+bool InstructionEncoder::addKey(const uint8_t* pubkey, bool isSigner, bool isWritable) {
+    uint8_t key = 255;
+    if (pubkey && !failed && keyCount < message.maxAccounts) {
+        key = message.recordKey(pubkey, (isSigner ? MessageBase::KEY_SIGNER : 0) |
+                                        (isWritable ? MessageBase::KEY_WRITABLE : 0));
+    }
+    if (key == 255) {
+        failed = true;
+        return false;
+    }
+    message.keysOf(message.instructionCount)[1 + keyCount++] = key;
+    return true;
+}
+
+bool InstructionEncoder::writeBytes(const uint8_t* bytes, uint16_t len) {
+    if (!bytes || failed || len > message.maxData - message.dataUsed - dataLength) {
+        failed = true;
+        return false;
+    }
+    memcpy(message.instructionData + message.dataUsed + dataLength, bytes, len);
+    dataLength += len;
+    return true;
+}
+
+bool InstructionEncoder::writeLE(uint64_t value, uint8_t size) {
+    uint8_t bytes[8];
+    for (uint8_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)((value >> (i * 8)) & 0xFF);
+    }
+    return writeBytes(bytes, size);
+}
+
+bool InstructionEncoder::writeU8(uint8_t value) {
+    return writeLE(value, 1);
+}
+
+bool InstructionEncoder::writeU16LE(uint16_t value) {
+    return writeLE(value, 2);
+}
+
+bool InstructionEncoder::writeU32LE(uint32_t value) {
+    return writeLE(value, 4);
+}
+
+bool InstructionEncoder::writeU64LE(uint64_t value) {
+    return writeLE(value, 8);
+}
+
+bool InstructionEncoder::writeI64LE(int64_t value) {
+    return writeLE((uint64_t)value, 8);
+}
+
+bool InstructionEncoder::writeBool(bool value) {
+    return writeLE(value ? 1 : 0, 1);
+}
+
+bool InstructionEncoder::writePubkey(const uint8_t* pubkey) {
+    return writeBytes(pubkey, pubkey ? SOLDUINO_PUBKEY_SIZE : 0);
+}
+
+bool InstructionEncoder::finish() {
+    if (failed || !hasProgram) {
+        return false;
+    }
+    uint8_t programKey = message.recordKey(programId, 0);
+    if (programKey == 255) {
+        return false;
+    }
+    return message.commitInstruction(programKey, keyCount, dataLength);
 }
 
 // ============================================================================
 // Transaction Implementation
 // ============================================================================
 
-Transaction::Transaction() {
-    memset(signatures, 0, sizeof(signatures));
+void TransactionBase::clearSignatures() {
+    memset(signatures, 0, (size_t)maxSignatures * SIGNATURE_SIZE);
     signatureCount = 0;
     isValid = false;
 }
 
-bool Transaction::addTransferInstruction(const uint8_t* from,
-                                        const uint8_t* to,
-                                        uint64_t amount) {
+bool TransactionBase::assign(const TransactionBase& other) {
+    if (&other == this) {
+        return true;
+    }
+    clearSignatures();
+    if (other.signatureCount > maxSignatures || !message.assign(other.message)) {
+        message.reset();
+        return false;
+    }
+    memcpy(signatures, other.signatures, (size_t)other.signatureCount * SIGNATURE_SIZE);
+    signatureCount = other.signatureCount;
+    isValid = other.isValid;
+    return true;
+}
+
+bool TransactionBase::addTransferInstruction(const uint8_t* from,
+                                             const uint8_t* to,
+                                             uint64_t amount) {
     if (!from || !to) {
         return false;
     }
@@ -201,7 +447,7 @@ bool Transaction::addTransferInstruction(const uint8_t* from,
     uint8_t systemProgramId[SOLDUINO_PUBKEY_SIZE];
     memset(systemProgramId, 0, SOLDUINO_PUBKEY_SIZE); // System program is all-zero pubkey
 
-    // Add accounts in correct order using addAccount to ensure proper header updates
+    // Record accounts; MessageBase::compile() orders them and builds the header
     int8_t fromIndex = message.addAccount(from, true, true);   // signer, writable
     if (fromIndex < 0) {
         return false;
@@ -237,99 +483,102 @@ bool Transaction::addTransferInstruction(const uint8_t* from,
     return true;
 }
 
-bool Transaction::add(const Instruction& instruction) {
+bool TransactionBase::add(const InstructionBase& instruction) {
+    return add(instruction.ref());
+}
+
+bool TransactionBase::add(const InstructionRef& instruction) {
     // Validate instruction has a program set
-    if (!instruction.hasProgram()) {
+    if (!instruction.programId || (instruction.keyCount > 0 && !instruction.keys) ||
+        (instruction.dataLength > 0 && !instruction.data)) {
         return false;
     }
     
-    // 1. Register all account keys from the instruction into the message.
-    //    addAccount handles deduplication and correct ordering automatically.
-    for (uint8_t i = 0; i < instruction.getKeyCount(); i++) {
-        const AccountMeta* meta = instruction.getKey(i);
-        if (!meta) return false;
-        
-        int8_t idx = message.addAccount(meta->pubkey, meta->isSigner, meta->isWritable);
-        if (idx < 0) {
+    uint8_t keyCount = instruction.keyCount;
+    if (message.instructionCount >= message.maxInstructions || keyCount > message.maxAccounts ||
+        instruction.dataLength > message.getDataCapacity()) {
+        return false;
+    }
+    
+    // Record every AccountMeta; the key table dedups them and merges
+    // privileges, and ordering is left to MessageBase::compile().
+    uint8_t keys[SOLDUINO_ACCOUNT_LIMIT];
+    for (uint8_t i = 0; i < keyCount; i++) {
+        const AccountMeta& meta = instruction.keys[i];
+        int8_t key = message.addAccount(meta.pubkey, meta.isSigner, meta.isWritable);
+        if (key < 0) {
             return false;
         }
+        keys[i] = key;
     }
     
-    // 2. Build a pointer array of account pubkeys for the legacy addInstruction path
-    const uint8_t* accountPtrs[MAX_IX_ACCOUNTS];
-    for (uint8_t i = 0; i < instruction.getKeyCount(); i++) {
-        const AccountMeta* meta = instruction.getKey(i);
-        accountPtrs[i] = meta->pubkey;
+    int8_t programKey = message.addAccount(instruction.programId, false, false);
+    if (programKey < 0) {
+        return false;
     }
     
-    // 3. Delegate to the existing Message::addInstruction which handles
-    //    program ID registration and CompiledInstruction creation.
-    return message.addInstruction(
-        instruction.getProgram(),
-        accountPtrs,
-        instruction.getKeyCount(),
-        instruction.getData(),
-        instruction.getDataLength()
-    );
+    return message.recordInstruction(programKey, keys, keyCount, instruction.data, instruction.dataLength);
 }
 
-bool Transaction::addInstruction(const uint8_t* programId,
-                                const uint8_t* accounts[],
-                                uint8_t accountCount,
-                                const uint8_t* data,
-                                uint16_t dataLength) {
+bool TransactionBase::addInstruction(const uint8_t* programId,
+                                     const uint8_t* accounts[],
+                                     uint8_t accountCount,
+                                     const uint8_t* data,
+                                     uint16_t dataLength) {
     return message.addInstruction(programId, accounts, accountCount, data, dataLength);
 }
 
-bool Transaction::setRecentBlockhash(const uint8_t* blockhash) {
+bool TransactionBase::setRecentBlockhash(const uint8_t* blockhash) {
     return message.setRecentBlockhash(blockhash);
 }
 
-bool Transaction::sign(const uint8_t* privateKey, const uint8_t* publicKey) {
+bool TransactionBase::sign(const uint8_t* privateKey, const uint8_t* publicKey) {
     // Low-level single-signer entrypoint. Clears any previously placed
     // signatures, then writes this signer's signature at its slot.
     // For multi-signer flows, use `signMultiple(...)` or build up partial
     // signatures via `partialSign(const Keypair&)`.
-    memset(signatures, 0, sizeof(signatures));
-    signatureCount = 0;
-    isValid = false;
+    clearSignatures();
     return partialSignRaw(privateKey, publicKey);
 }
 
-bool Transaction::partialSignRaw(const uint8_t* privateKey, const uint8_t* publicKey) {
-    if (!privateKey || !publicKey) {
+bool TransactionBase::partialSignRaw(const uint8_t* privateKey, const uint8_t* publicKey) {
+    if (!privateKey) {
+        return false;
+    }
+    return placeSignature(publicKey, privateKey, nullptr);
+}
+
+bool TransactionBase::placeSignature(const uint8_t* publicKey, const uint8_t* privateKey, const Keypair* signer) {
+    if (!publicKey || (!privateKey && !signer)) {
         return false;
     }
     
-    // Ensure the signer account is part of the message
-    uint8_t signerIndex = message.findAccountIndex(publicKey);
-    if (signerIndex == 255) {
-        // Account doesn't exist - add it as a writable signer
-        // This will add it at the correct position (beginning for writable signers)
-        signerIndex = message.addAccount(publicKey, true, true);
-        if (signerIndex == 255) {
-            return false;
-        }
+    // Ensure the signer account is part of the message; a missing key is
+    // added as a writable signer, which compile() orders among the signers
+    if (message.lookupKey(publicKey) == 255 && message.addAccount(publicKey, true, true) < 0) {
+        return false;
     }
+    uint8_t signerIndex = message.findAccountIndex(publicKey);
     
     // Critical: In Solana, the fee payer (first signer) MUST be at account index 0.
     // Signers must live in the first `numRequiredSignatures` account slots, in order.
     TransactionHeader header = message.getHeader();
-    if (signerIndex >= header.numRequiredSignatures) {
+    if (signerIndex >= header.numRequiredSignatures || header.numRequiredSignatures > maxSignatures) {
         return false;
     }
     
-    // Serialize message for signing
-    uint8_t messageBuffer[2048];
+    // Serialized once and shared by every signer until the message changes
     uint16_t messageLen = 0;
-
-    if (!TransactionSerializer::serializeMessage(message, messageBuffer, sizeof(messageBuffer), messageLen)) {
+    const uint8_t* messageBuffer = message.serialize(messageLen);
+    if (!messageBuffer) {
         return false;
     }
 
     // Sign the serialized message
     uint8_t signature[SIGNATURE_SIZE];
-    if (!signMessage(messageBuffer, messageLen, privateKey, signature)) {
+    bool signedOk = signer ? signer->sign(messageBuffer, messageLen, signature)
+                           : signMessage(messageBuffer, messageLen, privateKey, signature);
+    if (!signedOk) {
         return false;
     }
     
@@ -351,60 +600,144 @@ bool Transaction::partialSignRaw(const uint8_t* privateKey, const uint8_t* publi
     return true;
 }
 
-bool Transaction::sign(const Keypair& signer) {
+bool TransactionBase::sign(const Keypair& signer) {
     if (!signer.isInitialized()) {
         return false;
     }
     
-    uint8_t priv[SOLDUINO_SECRETKEY_SIZE];
-    uint8_t pub[SOLDUINO_PUBKEY_SIZE];
-    bool ok = signer.getPrivateKey(priv) && signer.getPublicKey(pub);
-    if (ok) {
-        ok = this->sign(priv, pub);
-    }
-    // Scrub private key from stack regardless of outcome.
-    memset(priv, 0, sizeof(priv));
-    return ok;
+    clearSignatures();
+    return partialSign(signer);
 }
 
-bool Transaction::partialSign(const Keypair& signer) {
+bool TransactionBase::partialSign(const Keypair& signer) {
     if (!signer.isInitialized()) {
         return false;
     }
     
-    uint8_t priv[SOLDUINO_SECRETKEY_SIZE];
+    // Signs with the keypair's expanded key; the private key is never copied out
     uint8_t pub[SOLDUINO_PUBKEY_SIZE];
-    bool ok = signer.getPrivateKey(priv) && signer.getPublicKey(pub);
-    if (ok) {
-        ok = this->partialSignRaw(priv, pub);
+    if (!signer.getPublicKey(pub)) {
+        return false;
     }
-    memset(priv, 0, sizeof(priv));
-    return ok;
+    return placeSignature(pub, nullptr, &signer);
 }
 
-bool Transaction::sign(const Keypair* const signers[], uint8_t count) {
+/**
+ * Shared by every signing worker: signers are claimed one at a time through
+ * `next`, and each writes only its own, distinct signature slot.
+ */
+struct SignJob {
+    const uint8_t* message;
+    uint16_t messageLen;
+    const Keypair* signers[SOLDUINO_MAX_SIGNERS];
+    uint8_t* slots[SOLDUINO_MAX_SIGNERS];
+    bool ok[SOLDUINO_MAX_SIGNERS];
+    uint8_t count;
+#if SOLDUINO_SIGN_THREADS
+    std::atomic<uint8_t> next;
+#else
+    uint8_t next;
+#endif
+};
+
+static void signWorker(void* context, unsigned) {
+    SignJob* job = (SignJob*)context;
+    for (;;) {
+        uint8_t i = job->next++;
+        if (i >= job->count) break;
+
+        job->ok[i] = job->signers[i]->sign(job->message, job->messageLen, job->slots[i]);
+    }
+}
+
+bool TransactionBase::sign(const Keypair* const signers[], uint8_t count, unsigned threads) {
     if (!signers || count == 0) {
         return false;
     }
     
     // Start from a clean slate so a multi-signer sign() matches the
     // single-signer sign() semantics.
-    memset(signatures, 0, sizeof(signatures));
-    signatureCount = 0;
-    isValid = false;
+    clearSignatures();
     
+    // Register every signer before serializing, so the bytes signed below
+    // are final and no signature is invalidated by a later signer's key.
     bool allSuccess = true;
+    uint8_t pubs[SOLDUINO_MAX_SIGNERS][SOLDUINO_PUBKEY_SIZE];
+    const Keypair* valid[SOLDUINO_MAX_SIGNERS];
+    uint8_t validCount = 0;
     for (uint8_t i = 0; i < count; i++) {
-        if (!signers[i] || !partialSign(*signers[i])) {
+        if (!signers[i] || !signers[i]->isInitialized() || validCount >= SOLDUINO_MAX_SIGNERS ||
+            !signers[i]->getPublicKey(pubs[validCount])) {
             allSuccess = false;
+            continue;
         }
+        if (message.lookupKey(pubs[validCount]) == 255 &&
+            message.addAccount(pubs[validCount], true, true) < 0) {
+            allSuccess = false;
+            continue;
+        }
+        valid[validCount++] = signers[i];
     }
-    return allSuccess;
+    
+    TransactionHeader header = message.getHeader();
+    SignJob job;
+    job.messageLen = 0;
+    job.message = message.serialize(job.messageLen);
+    job.count = 0;
+    job.next = 0;
+    if (!job.message || header.numRequiredSignatures == 0 || header.numRequiredSignatures > maxSignatures) {
+        return false;
+    }
+    
+    // One job entry per distinct signer slot; a keypair listed twice is signed once
+    bool claimed[SOLDUINO_MAX_SIGNERS] = {false};
+    for (uint8_t i = 0; i < validCount; i++) {
+        uint8_t signerIndex = message.findAccountIndex(pubs[i]);
+        if (signerIndex >= header.numRequiredSignatures) {
+            allSuccess = false;
+            continue;
+        }
+        if (claimed[signerIndex]) {
+            continue;
+        }
+        claimed[signerIndex] = true;
+        job.signers[job.count] = valid[i];
+        job.slots[job.count] = signatures[signerIndex];
+        job.count++;
+    }
+    
+#if SOLDUINO_SIGN_THREADS
+    // Start the crypto backend here rather than racing on it in the workers
+    if (!cryptoBegin()) return false;
+    
+    unsigned maxThreads = job.count < SOLDUINO_SIGN_MAX_THREADS ? job.count : SOLDUINO_SIGN_MAX_THREADS;
+    runWorkers(signWorker, &job, threads, maxThreads, SOLDUINO_SIGN_STACK);
+#else
+    (void)threads;
+    signWorker(&job, 0);
+#endif
+    
+    // As with partialSign(), successful signatures stay in place when
+    // another signer fails; the failed slot is left zeroed.
+    bool anySigned = false;
+    for (uint8_t i = 0; i < job.count; i++) {
+        if (job.ok[i]) {
+            anySigned = true;
+        } else {
+            memset(job.slots[i], 0, SIGNATURE_SIZE);
+            allSuccess = false;
+        }
+    }
+    if (anySigned) {
+        signatureCount = header.numRequiredSignatures;
+        isValid = true;
+    }
+    return allSuccess && anySigned;
 }
 
-bool Transaction::signMultiple(const uint8_t* privateKeys[],
-                               const uint8_t* publicKeys[],
-                               uint8_t count) {
+bool TransactionBase::signMultiple(const uint8_t* privateKeys[],
+                                   const uint8_t* publicKeys[],
+                                   uint8_t count) {
     if (!privateKeys || !publicKeys || count == 0) {
         return false;
     }
@@ -412,9 +745,7 @@ bool Transaction::signMultiple(const uint8_t* privateKeys[],
     // Clear once up front, then accumulate partial signatures. The previous
     // implementation called sign() in a loop, which wiped each prior
     // signature and left only the last signer's signature on the transaction.
-    memset(signatures, 0, sizeof(signatures));
-    signatureCount = 0;
-    isValid = false;
+    clearSignatures();
     
     bool allSuccess = true;
     for (uint8_t i = 0; i < count; i++) {
@@ -426,7 +757,7 @@ bool Transaction::signMultiple(const uint8_t* privateKeys[],
     return allSuccess;
 }
 
-bool Transaction::getSignature(uint8_t index, uint8_t* signature) const {
+bool TransactionBase::getSignature(uint8_t index, uint8_t* signature) const {
     if (!signature || index >= signatureCount) {
         return false;
     }
@@ -434,10 +765,8 @@ bool Transaction::getSignature(uint8_t index, uint8_t* signature) const {
     return true;
 }
 
-void Transaction::reset() {
-    memset(signatures, 0, sizeof(signatures));
-    signatureCount = 0;
+void TransactionBase::reset() {
+    clearSignatures();
     message.reset();
-    isValid = false;
 }
 
@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include "crypto.h"
 #include "instruction.h"
+#include "lookup_table.h"
 
 // ============================================================================
 // Solduino Transaction Module
@@ -16,9 +17,11 @@
 // ============================================================================
 
 // Constants
-// These defaults are tuned for embedded targets to avoid excessive stack usage
-// when instantiating a Transaction on the stack. They can be overridden at
-// compile time by defining the macros before including this header.
+// Capacity of the Message and Transaction aliases. These defaults are tuned
+// for embedded targets to avoid excessive stack usage when instantiating a
+// Transaction on the stack. They can be overridden at compile time by
+// defining the macros before including this header, or a BasicTransaction
+// of exactly the capacity needed can be declared instead.
 #ifndef MAX_ACCOUNTS
 #define MAX_ACCOUNTS 16
 #endif
@@ -27,16 +30,58 @@
 #define MAX_INSTRUCTIONS 8
 #endif
 
+// Instruction data bytes per message, shared by all of its instructions
 #ifndef MAX_INSTRUCTION_DATA
-#define MAX_INSTRUCTION_DATA 256
+#define MAX_INSTRUCTION_DATA 1024
+#endif
+
+// Serialized message cache. Solana rejects transactions over 1232 bytes,
+// so a message that does not fit here could never be sent anyway.
+#ifndef MAX_MESSAGE_SIZE
+#define MAX_MESSAGE_SIZE 1232
+#endif
+
+// Largest serialized transaction Solana accepts (one packet)
+#ifndef SOLDUINO_MAX_TRANSACTION_SIZE
+#define SOLDUINO_MAX_TRANSACTION_SIZE 1232
 #endif
 #define BLOCKHASH_SIZE 32
 #define SIGNATURE_SIZE 64
 
+// Largest MaxAccounts a BasicMessage accepts: key indexes are uint8_t and
+// the dedup hash keeps two slots per key
+#define SOLDUINO_ACCOUNT_LIMIT 128
+
+// Signers one transaction can carry. Each costs a 64-byte signature and a
+// 32-byte key, so no more than 12 fit in a 1232-byte packet.
+#ifndef SOLDUINO_MAX_SIGNERS
+#define SOLDUINO_MAX_SIGNERS 12
+#endif
+
+// sign(signers, count) spreads signatures over std::thread workers on ESP32
+// (both cores) and hosted builds; other boards sign on the calling thread
+#ifndef SOLDUINO_SIGN_THREADS
+#if defined(ESP32) || !defined(ARDUINO)
+#define SOLDUINO_SIGN_THREADS 1
+#else
+#define SOLDUINO_SIGN_THREADS 0
+#endif
+#endif
+
+// Upper bound on sign() worker threads
+#ifndef SOLDUINO_SIGN_MAX_THREADS
+#define SOLDUINO_SIGN_MAX_THREADS 8
+#endif
+
+// Stack of each sign() worker on ESP32; Ed25519 signing (and the reference
+// backend's point arithmetic) needs more than the 3 KB pthread default
+#ifndef SOLDUINO_SIGN_STACK
+#define SOLDUINO_SIGN_STACK 8192
+#endif
+
 // Forward declarations
-class Transaction;
-class Message;
-class Instruction;
+class TransactionBase;
+class MessageBase;
 class TransactionSerializer;
 class Keypair;
 
@@ -51,42 +96,184 @@ struct TransactionHeader {
 };
 
 /**
- * Compiled Instruction
- * Represents a Solana instruction in wire format
+ * Instruction as recorded in a message. Its program and account keys are
+ * key table indexes in the message's instruction key table, and its data
+ * is a slice of the message's shared data pool.
  */
-struct CompiledInstruction {
-    uint8_t programIdIndex;
-    uint8_t accountIndices[MAX_ACCOUNTS];
-    uint8_t accountCount;
-    uint8_t data[MAX_INSTRUCTION_DATA];
+struct MessageInstruction {
+    uint16_t dataOffset;
     uint16_t dataLength;
+    uint8_t accountCount;
+};
+
+// Address lookup tables a v0 message can reference
+#ifndef SOLDUINO_MAX_LOOKUP_TABLES
+#define SOLDUINO_MAX_LOOKUP_TABLES 4
+#endif
+
+/**
+ * Storage of a BasicMessage, constructed ahead of the MessageBase that
+ * works in it
+ */
+template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+struct MessageStorage {
+    // Longest wire form these capacities allow: version prefix, header,
+    // keys, blockhash, instructions, and lookups of every table
+    static constexpr uint32_t WIRE_BOUND =
+        1 + 3 + 3 + (uint32_t)MaxAccounts * (SOLDUINO_PUBKEY_SIZE + 1) + BLOCKHASH_SIZE +
+        3 + (uint32_t)MaxInstructions * (1 + 3 + MaxAccounts + 3) + MaxData +
+        3 + SOLDUINO_MAX_LOOKUP_TABLES * (SOLDUINO_PUBKEY_SIZE + 3 + 3);
+    static constexpr uint16_t SERIALIZED_SIZE = WIRE_BOUND < MAX_MESSAGE_SIZE ? WIRE_BOUND : MAX_MESSAGE_SIZE;
+
+    uint8_t accountKeys[MaxAccounts][SOLDUINO_PUBKEY_SIZE];
+    uint8_t accountFlags[MaxAccounts];
+    uint8_t keySlots[2 * MaxAccounts];
+    uint8_t instructionKeys[MaxInstructions][MaxAccounts + 1];
+    MessageInstruction instructions[MaxInstructions];
+    uint8_t data[MaxData];
+    uint8_t accountOrder[MaxAccounts];
+    uint8_t accountPosition[MaxAccounts];
+    uint8_t lookupIndexes[MaxAccounts];
+    uint8_t serialized[SERIALIZED_SIZE];
 };
 
 /**
  * Transaction Message
  * Contains the transaction instructions and metadata
+ *
+ * Building a message is two-phase. addAccount(), addInstruction() and
+ * Transaction::add() only record keys: each key lands once in an
+ * insertion-ordered table (deduplicated through a small open-addressing
+ * hash) and repeat uses merge their signer/writable flags. compile() then
+ * orders the keys into the four Solana classes (writable signers, readonly
+ * signers, writable non-signers, readonly non-signers) and emits the header
+ * in one pass; the serializer maps each instruction's keys through that
+ * order as it writes them. Getters, signing and serialization compile on
+ * demand, so compiled indices are never stale.
+ *
+ * The wire form is cached the same way: serialize() builds it once after a
+ * change, and every signer, the serializer and fee estimation reuse it.
+ *
+ * Attaching an address lookup table with addLookupTable() turns the message
+ * into a v0 message. compile() then loads every non-signer, non-program key
+ * found in an attached table through the table (one index byte instead of
+ * 32 key bytes), ordered as Solana requires: static keys, then writable
+ * loaded keys, then readonly loaded keys, each grouped by table in the
+ * order the tables were attached.
+ *
+ * MessageBase holds the logic and works in storage owned by a
+ * BasicMessage<MaxAccounts, MaxInstructions, MaxData>, so every capacity
+ * shares one implementation. Instruction data is packed back to back in
+ * one pool of MaxData bytes rather than reserved per instruction, and the
+ * serialized-message cache is only as large as the capacities allow.
+ * `Message` is the BasicMessage of MAX_ACCOUNTS, MAX_INSTRUCTIONS and
+ * MAX_INSTRUCTION_DATA.
  */
-class Message {
+class MessageBase {
 private:
-    TransactionHeader header;
-    uint8_t accountKeys[MAX_ACCOUNTS][SOLDUINO_PUBKEY_SIZE];
+    static const uint8_t KEY_SIGNER = 0x01;
+    static const uint8_t KEY_WRITABLE = 0x02;
+    static const uint8_t KEY_INVOKED = 0x04;          // a program ID; never loaded from a table
+
+    // Capacity of the BasicMessage storage the arrays below point into
+    uint8_t maxAccounts;
+    uint8_t maxInstructions;
+    uint16_t maxData;
+    uint16_t serializedCapacity;
+
+    // Recorded state, in insertion order
+    uint8_t (*accountKeys)[SOLDUINO_PUBKEY_SIZE];
+    uint8_t* accountFlags;                            // KEY_SIGNER | KEY_WRITABLE, merged
     uint8_t accountCount;
+    uint8_t* keySlots;                                // 2 * maxAccounts, key table index + 1, 0 = empty
     uint8_t recentBlockhash[BLOCKHASH_SIZE];
-    CompiledInstruction instructions[MAX_INSTRUCTIONS];
+    uint8_t* instructionKeys;                         // maxAccounts + 1 per instruction: program, then accounts
+    MessageInstruction* instructions;
     uint8_t instructionCount;
+    uint8_t* instructionData;                         // every instruction's data, back to back
+    uint16_t dataUsed;
+    const AddressLookupTable* lookupTables[SOLDUINO_MAX_LOOKUP_TABLES];
+    uint8_t lookupTableCount;
+
+    // Compiled state, rebuilt by compile() after any change
+    mutable TransactionHeader header;
+    uint8_t* accountOrder;                            // compiled index -> key table index
+    uint8_t* accountPosition;                         // key table index -> compiled index
+    mutable uint8_t staticAccountCount;               // keys written in full
+    uint8_t* lookupIndexes;                           // table entry of each loaded key, in compiled order
+    mutable uint8_t lookupWritableCounts[SOLDUINO_MAX_LOOKUP_TABLES];
+    mutable uint8_t lookupReadonlyCounts[SOLDUINO_MAX_LOOKUP_TABLES];
+    mutable bool compiled;
+
+    // Serialized form, rebuilt by serialize() after any change
+    uint8_t* serialized;                              // serializedCapacity bytes
+    mutable uint16_t serializedLength;                // 0 = stale
     
+    void markDirty() { compiled = false; serializedLength = 0; }
+    uint8_t* keysOf(uint8_t instruction) const { return instructionKeys + instruction * (maxAccounts + 1); }
+    uint16_t keySlotCount() const { return 2 * maxAccounts; }
     bool isValidAccountIndex(uint8_t index) const;
     uint8_t findAccountIndex(const uint8_t* pubkey) const;
+    uint8_t lookupKey(const uint8_t* pubkey) const;
+    uint8_t recordKey(const uint8_t* pubkey, uint8_t flags);
+    // Bucket compile() puts a key in: 0-3 static (writable signer, readonly
+    // signer, writable, readonly), 4 + t writable and 4 + T + t readonly
+    // loaded from table t. entry is then its index in the table.
+    uint8_t classifyKey(const uint8_t* pubkey, uint8_t flags, uint8_t& entry) const;
+    bool recordInstruction(uint8_t programKey, const uint8_t* accountKeyIndices, uint8_t accountCount,
+                           const uint8_t* data, uint16_t dataLength);
+    bool commitInstruction(uint8_t programKey, uint8_t accountCount, uint16_t dataLength);
+
+protected:
+    template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+    explicit MessageBase(MessageStorage<MaxAccounts, MaxInstructions, MaxData>& storage)
+        : maxAccounts(MaxAccounts), maxInstructions(MaxInstructions), maxData(MaxData),
+          serializedCapacity(MessageStorage<MaxAccounts, MaxInstructions, MaxData>::SERIALIZED_SIZE),
+          accountKeys(storage.accountKeys), accountFlags(storage.accountFlags), keySlots(storage.keySlots),
+          instructionKeys(storage.instructionKeys[0]), instructions(storage.instructions),
+          instructionData(storage.data), accountOrder(storage.accountOrder),
+          accountPosition(storage.accountPosition), lookupIndexes(storage.lookupIndexes),
+          serialized(storage.serialized) {
+        reset();
+    }
+
+    // Copies go through assign(), which keeps each object in its own storage
+    MessageBase(const MessageBase&) = delete;
+    MessageBase& operator=(const MessageBase&) = delete;
 
 public:
-    Message();
+    /**
+     * Copy another message's keys, blockhash, lookup tables and
+     * instructions. The copy compiles and serializes identically.
+     * @return false if they exceed this message's capacity (left reset)
+     */
+    bool assign(const MessageBase& other);
+    
     
     /**
-     * Add an account key to the message
+     * Add an account key to the message. Adding a key that is already
+     * present upgrades it to the union of both privileges.
      * @param pubkey Public key (32 bytes)
-     * @return Account index, or -1 on error
+     * @return Position of the key in insertion order (not its compiled
+     *         index, which depends on the other keys), or -1 on error
      */
     int8_t addAccount(const uint8_t* pubkey, bool isSigner, bool isWritable);
+
+    /**
+     * Order the recorded keys and emit the header and instruction indices.
+     * Idempotent and cheap when nothing changed; called implicitly by the
+     * getters, signing and serialization.
+     */
+    void compile() const;
+
+    /**
+     * Serialized message (the bytes every signer signs). Built on first use
+     * after a change and reused until the next one.
+     * @param length Output: serialized length
+     * @return Serialized bytes, or nullptr if the message exceeds MAX_MESSAGE_SIZE
+     *         or the serialized-message cache of this capacity
+     */
+    const uint8_t* serialize(uint16_t& length) const;
     
     /**
      * Set the recent blockhash
@@ -96,7 +283,9 @@ public:
     bool setRecentBlockhash(const uint8_t* blockhash);
     
     /**
-     * Add an instruction to the message
+     * Add an instruction to the message. Every account must already be
+     * present (see addAccount()); the program ID is added as a readonly
+     * non-signer if missing.
      * @param programId Program ID public key (32 bytes)
      * @param accounts Array of account public keys
      * @param accountCount Number of accounts
@@ -111,17 +300,46 @@ public:
                        uint16_t dataLength);
     
     /**
-     * Get message account count
+     * Attach an address lookup table and switch to the v0 format. The
+     * table is not copied and must outlive the message (or the next reset()).
+     * @param table Loaded lookup table
+     * @return false if the table is not loaded, has been deactivated, or
+     *         SOLDUINO_MAX_LOOKUP_TABLES are already attached
+     */
+    bool addLookupTable(const AddressLookupTable* table);
+    
+    /**
+     * True for v0 messages (at least one lookup table attached)
+     */
+    bool isVersioned() const { return lookupTableCount > 0; }
+    
+    /**
+     * Get message account count, including keys loaded from lookup tables
      */
     uint8_t getAccountCount() const { return accountCount; }
     
+    /**
+     * Get the number of keys serialized in full; the rest are loaded
+     * from lookup tables
+     */
+    uint8_t getStaticAccountCount() const { compile(); return staticAccountCount; }
+    
     /**
      * Get instruction count
      */
     uint8_t getInstructionCount() const { return instructionCount; }
     
     /**
-     * Get account public key by index
+     * Capacity: keys (loaded ones included), instructions, and instruction
+     * data bytes still free in the shared pool
+     */
+    uint8_t getAccountCapacity() const { return maxAccounts; }
+    uint8_t getInstructionCapacity() const { return maxInstructions; }
+    uint16_t getDataCapacity() const { return maxData - dataUsed; }
+    
+    /**
+     * Get account public key by index. Indexes past the static keys
+     * resolve to keys loaded from lookup tables.
      * @param index Account index
      * @param pubkey Output buffer (32 bytes)
      * @return true if successful
@@ -138,7 +356,7 @@ public:
     /**
      * Get transaction header
      */
-    TransactionHeader getHeader() const { return header; }
+    TransactionHeader getHeader() const { compile(); return header; }
     
     /**
      * Reset the message (clear all instructions and accounts)
@@ -147,25 +365,131 @@ public:
     
     // Friend classes for access to private members
     friend class TransactionSerializer;
-    friend class Transaction;
+    friend class TransactionBase;
+    friend class InstructionPacker;
+    friend class InstructionEncoder;
+};
+
+/**
+ * Message with room for MaxAccounts keys, MaxInstructions instructions and
+ * MaxData bytes of instruction data in total
+ */
+template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+class BasicMessage : private MessageStorage<MaxAccounts, MaxInstructions, MaxData>, public MessageBase {
+    static_assert(MaxAccounts > 0 && MaxAccounts <= SOLDUINO_ACCOUNT_LIMIT,
+                  "BasicMessage holds 1 to SOLDUINO_ACCOUNT_LIMIT accounts");
+    static_assert(MaxInstructions > 0 && MaxData > 0, "BasicMessage needs room for an instruction");
+
+public:
+    BasicMessage()
+        : MessageBase(static_cast<MessageStorage<MaxAccounts, MaxInstructions, MaxData>&>(*this)) {}
+    BasicMessage(const BasicMessage& other) : BasicMessage() { assign(other); }
+    BasicMessage& operator=(const BasicMessage& other) {
+        assign(other);
+        return *this;
+    }
+};
+
+typedef BasicMessage<MAX_ACCOUNTS, MAX_INSTRUCTIONS, MAX_INSTRUCTION_DATA> Message;
+
+/**
+ * Writes one instruction straight into a message: each key is recorded in
+ * the message's key table as it is added, and data lands in the free end
+ * of its data pool, so no Instruction is built and copied on the way.
+ * Transaction::emplace() creates one and hands it to the instruction
+ * type's encode(); it offers the same building calls as Instruction.
+ * Nothing is committed until encode() succeeds, although keys added
+ * before a failure stay recorded, as with Transaction::add().
+ */
+class InstructionEncoder {
+public:
+    bool setProgram(const uint8_t* programId);
+    bool addKey(const uint8_t* pubkey, bool isSigner, bool isWritable);
+    bool writeU8(uint8_t value);
+    bool writeU16LE(uint16_t value);
+    bool writeU32LE(uint32_t value);
+    bool writeU64LE(uint64_t value);
+    bool writeI64LE(int64_t value);
+    bool writeBool(bool value);
+    bool writeBytes(const uint8_t* bytes, uint16_t len);
+    bool writePubkey(const uint8_t* pubkey);
+
+private:
+    MessageBase& message;
+    uint8_t programId[SOLDUINO_PUBKEY_SIZE];
+    bool hasProgram;
+    uint8_t keyCount;
+    uint16_t dataLength;
+    bool failed;                                      // a call was rejected; finish() refuses
+
+    explicit InstructionEncoder(MessageBase& message);
+    bool writeLE(uint64_t value, uint8_t size);
+    bool finish();
+
+    friend class TransactionBase;
+};
+
+
+/**
+ * Storage of a BasicTransaction, constructed ahead of the TransactionBase
+ * that works in it
+ */
+template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+struct TransactionStorage {
+    static constexpr uint8_t SIGNATURE_SLOTS = MaxAccounts < SOLDUINO_MAX_SIGNERS ? MaxAccounts : SOLDUINO_MAX_SIGNERS;
+
+    uint8_t signatures[SIGNATURE_SLOTS][SIGNATURE_SIZE];
+    BasicMessage<MaxAccounts, MaxInstructions, MaxData> message;
 };
 
 /**
  * Solana Transaction
  * Contains signatures and message
+ *
+ * TransactionBase holds the logic and works in storage owned by a
+ * BasicTransaction<MaxAccounts, MaxInstructions, MaxData>; serialization,
+ * packing and templates take `const TransactionBase&`, so they accept
+ * every capacity. A transaction keeps min(MaxAccounts, SOLDUINO_MAX_SIGNERS)
+ * signature slots. `Transaction` is the BasicTransaction of MAX_ACCOUNTS,
+ * MAX_INSTRUCTIONS and MAX_INSTRUCTION_DATA; a single transfer fits in
+ * BasicTransaction<3, 1, 12>.
  */
-class Transaction {
+class TransactionBase {
 private:
-    uint8_t signatures[MAX_ACCOUNTS][SIGNATURE_SIZE];
+    uint8_t (*signatures)[SIGNATURE_SIZE];
+    uint8_t maxSignatures;
     uint8_t signatureCount;
-    Message message;
+    MessageBase& message;
     bool isValid;
     
+    void clearSignatures();
+    
     // Used by partialSign() and signMultiple() to accumulate signatures.
     bool partialSignRaw(const uint8_t* privateKey, const uint8_t* publicKey);
+    
+    // Places publicKey's signature, made with either the raw privateKey or
+    // the signer's expanded key (exactly one of the two is non-null).
+    bool placeSignature(const uint8_t* publicKey, const uint8_t* privateKey, const Keypair* signer);
+
+protected:
+    template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+    explicit TransactionBase(TransactionStorage<MaxAccounts, MaxInstructions, MaxData>& storage)
+        : signatures(storage.signatures),
+          maxSignatures(TransactionStorage<MaxAccounts, MaxInstructions, MaxData>::SIGNATURE_SLOTS),
+          message(storage.message) {
+        clearSignatures();
+    }
+
+    // Copies go through assign(), which keeps each object in its own storage
+    TransactionBase(const TransactionBase&) = delete;
+    TransactionBase& operator=(const TransactionBase&) = delete;
 
 public:
-    Transaction();
+    /**
+     * Copy another transaction's message and signatures
+     * @return false if they exceed this transaction's capacity (left reset)
+     */
+    bool assign(const TransactionBase& other);
     
     /**
      * Create a transfer instruction and add it to the transaction
@@ -195,7 +519,32 @@ public:
      * @param instruction The Instruction to add
      * @return true if successful
      */
-    bool add(const Instruction& instruction);
+    bool add(const InstructionBase& instruction);
+
+    /**
+     * Add an instruction whose program ID, account metas and data the
+     * caller holds; they are read once and need not outlive the call.
+     * @param instruction Spans over the instruction's parts
+     * @return true if successful
+     */
+    bool add(const InstructionRef& instruction);
+
+    /**
+     * Encode an instruction straight into the message, without building
+     * an Instruction first. Spec is an instruction type with a static
+     * `template <typename Writer> bool encode(Writer&, Args...)`, such as
+     * SystemProgram::Transfer or TokenProgram::Transfer.
+     *
+     * Usage:
+     *   tx.emplace<SystemProgram::Transfer>(from, to, lamports);
+     *
+     * @return false if encode() fails or the message is out of room
+     */
+    template <typename Spec, typename... Args>
+    bool emplace(Args... args) {
+        InstructionEncoder encoder(message);
+        return Spec::encode(encoder, args...) && encoder.finish();
+    }
     
     /**
      * Add a custom instruction to the transaction (legacy API).
@@ -247,14 +596,18 @@ public:
     /**
      * Sign the transaction with multiple Keypairs (recommended API).
      *
-     * Clears existing signatures, then applies each signer in order. All
-     * signers must already be registered as signer accounts on the message.
+     * Clears existing signatures, resolves every signer's slot (adding
+     * missing ones as writable signers), serializes the message once, and
+     * then signs. With SOLDUINO_SIGN_THREADS the signatures are computed
+     * concurrently, each worker writing only its signers' slots; Ed25519
+     * is deterministic, so the result is byte-identical to threads = 1.
      *
      * @param signers Array of pointers to initialized keypairs
      * @param count   Number of signers
+     * @param threads Worker count including the caller; 0 = one per hardware thread
      * @return true if all signatures succeeded
      */
-    bool sign(const Keypair* const signers[], uint8_t count);
+    bool sign(const Keypair* const signers[], uint8_t count, unsigned threads = 0);
     
     /**
      * Sign the transaction with raw key bytes (low-level / legacy API).
@@ -285,8 +638,8 @@ public:
     /**
      * Get the transaction message
      */
-    Message& getMessage() { return message; }
-    const Message& getMessage() const { return message; }
+    MessageBase& getMessage() { return message; }
+    const MessageBase& getMessage() const { return message; }
     
     /**
      * Get signature count
@@ -315,5 +668,23 @@ public:
     friend class TransactionSerializer;
 };
 
+/**
+ * Transaction with the capacity of a BasicMessage<MaxAccounts,
+ * MaxInstructions, MaxData>
+ */
+template <uint8_t MaxAccounts, uint8_t MaxInstructions, uint16_t MaxData>
+class BasicTransaction : private TransactionStorage<MaxAccounts, MaxInstructions, MaxData>, public TransactionBase {
+public:
+    BasicTransaction()
+        : TransactionBase(static_cast<TransactionStorage<MaxAccounts, MaxInstructions, MaxData>&>(*this)) {}
+    BasicTransaction(const BasicTransaction& other) : BasicTransaction() { assign(other); }
+    BasicTransaction& operator=(const BasicTransaction& other) {
+        assign(other);
+        return *this;
+    }
+};
+
+typedef BasicTransaction<MAX_ACCOUNTS, MAX_INSTRUCTIONS, MAX_INSTRUCTION_DATA> Transaction;
+
 #endif // SOLDUINO_TRANSACTION_H
 
@@ -0,0 +1,235 @@
+#include "transaction_template.h"
+#include "crypto.h"
+#include "keypair.h"
+#include <string.h>
+
+// ============================================================================
+// TransactionTemplate Implementation
+// ============================================================================
+
+TransactionTemplate::TransactionTemplate() {
+    wireLength = 0;
+    messageOffset = 0;
+    keysOffset = 0;
+    blockhashOffset = 0;
+    instructionCount = 0;
+    signerCount = 0;
+    signedMask = 0;
+    fieldCount = 0;
+}
+
+bool TransactionTemplate::compile(const MessageBase& message) {
+    wireLength = 0;
+    messageOffset = 0;
+    instructionCount = 0;
+    signerCount = 0;
+    signedMask = 0;
+    fieldCount = 0;
+    
+    TransactionHeader header = message.getHeader();
+    if (header.numRequiredSignatures == 0 || header.numRequiredSignatures > 32 ||
+        message.getInstructionCount() == 0) {
+        return false;
+    }
+    
+    // Signature slots stay zeroed until sign()
+    uint16_t offset = 0;
+    TransactionSerializer::writeCompactU16(wire, offset, SOLDUINO_TEMPLATE_MAX_SIZE, header.numRequiredSignatures);
+    uint16_t signaturesLen = header.numRequiredSignatures * SIGNATURE_SIZE;
+    if (offset + signaturesLen >= SOLDUINO_TEMPLATE_MAX_SIZE) {
+        return false;
+    }
+    memset(wire + offset, 0, signaturesLen);
+    offset += signaturesLen;
+    
+    uint16_t messageLen = 0;
+    if (!TransactionSerializer::serializeMessage(message, wire + offset, SOLDUINO_TEMPLATE_MAX_SIZE - offset, messageLen)) {
+        return false;
+    }
+    
+    messageOffset = offset;
+    wireLength = offset + messageLen;
+    signerCount = header.numRequiredSignatures;
+    if (!locateMessageParts()) {
+        wireLength = 0;
+        return false;
+    }
+    return true;
+}
+
+bool TransactionTemplate::locateMessageParts() {
+    // Walk the serialized message once: version prefix (v0), header, keys,
+    // blockhash, each instruction's program index, account indices and
+    // data, then the v0 address table lookups
+    const uint8_t* msg = wire + messageOffset;
+    uint16_t msgLen = messageLength();
+    bool versioned = msgLen > 0 && (msg[0] & MESSAGE_VERSION_PREFIX);
+    uint16_t pos = versioned ? 4 : 3;
+    
+    uint16_t keyCount;
+    if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, keyCount)) {
+        return false;
+    }
+    keysOffset = messageOffset + pos;
+    pos += keyCount * SOLDUINO_PUBKEY_SIZE;
+    blockhashOffset = messageOffset + pos;
+    pos += BLOCKHASH_SIZE;
+    
+    uint16_t count;
+    if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, count) ||
+        count > SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS) {
+        return false;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t accountCount, dataLength;
+        pos += 1; // programIdIndex
+        if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, accountCount)) {
+            return false;
+        }
+        pos += accountCount;
+        if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, dataLength)) {
+            return false;
+        }
+        dataOffsets[i] = messageOffset + pos;
+        dataLengths[i] = dataLength;
+        pos += dataLength;
+    }
+    instructionCount = count;
+    
+    if (versioned) {
+        uint16_t lookupCount;
+        if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, lookupCount)) {
+            return false;
+        }
+        for (uint16_t i = 0; i < lookupCount; i++) {
+            uint16_t indexCount;
+            pos += SOLDUINO_PUBKEY_SIZE;
+            if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, indexCount)) {
+                return false;
+            }
+            pos += indexCount;
+            if (!TransactionSerializer::readCompactU16(msg, msgLen, pos, indexCount)) {
+                return false;
+            }
+            pos += indexCount;
+        }
+    }
+    return pos == msgLen;
+}
+
+int8_t TransactionTemplate::addField(const char* name, uint8_t instruction, uint16_t offset, uint16_t length) {
+    if (!name || wireLength == 0 || fieldCount >= SOLDUINO_TEMPLATE_MAX_FIELDS ||
+        instruction >= instructionCount || length == 0 ||
+        (uint32_t)offset + length > dataLengths[instruction]) {
+        return -1;
+    }
+    size_t nameLen = strlen(name);
+    if (nameLen == 0 || nameLen >= SOLDUINO_TEMPLATE_FIELD_NAME || findField(name) >= 0) {
+        return -1;
+    }
+    
+    Field& field = fields[fieldCount];
+    memcpy(field.name, name, nameLen + 1);
+    field.offset = dataOffsets[instruction] + offset;
+    field.length = length;
+    return fieldCount++;
+}
+
+int8_t TransactionTemplate::findField(const char* name) const {
+    if (!name) return -1;
+    
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        if (strcmp(fields[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool TransactionTemplate::patch(uint16_t offset, const uint8_t* bytes, uint16_t length) {
+    // Unchanged bytes keep existing signatures valid (e.g. a blockhash
+    // that has not rolled over since the last send)
+    if (memcmp(wire + offset, bytes, length) != 0) {
+        memcpy(wire + offset, bytes, length);
+        signedMask = 0;
+    }
+    return true;
+}
+
+bool TransactionTemplate::setBlockhash(const uint8_t* blockhash) {
+    if (!blockhash || wireLength == 0) {
+        return false;
+    }
+    return patch(blockhashOffset, blockhash, BLOCKHASH_SIZE);
+}
+
+bool TransactionTemplate::setField(int8_t field, const uint8_t* bytes, uint16_t length) {
+    if (!bytes || field < 0 || field >= fieldCount || fields[field].length != length) {
+        return false;
+    }
+    return patch(fields[field].offset, bytes, length);
+}
+
+bool TransactionTemplate::setField(const char* name, const uint8_t* bytes, uint16_t length) {
+    return setField(findField(name), bytes, length);
+}
+
+bool TransactionTemplate::setU64(const char* name, uint64_t value) {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (value >> (i * 8)) & 0xFF;
+    }
+    return setField(name, bytes, sizeof(bytes));
+}
+
+bool TransactionTemplate::setI64(const char* name, int64_t value) {
+    return setU64(name, (uint64_t)value);
+}
+
+bool TransactionTemplate::sign(const Keypair& signer) {
+    if (wireLength == 0 || !signer.isInitialized()) {
+        return false;
+    }
+    
+    uint8_t pub[SOLDUINO_PUBKEY_SIZE];
+    if (!signer.getPublicKey(pub)) {
+        return false;
+    }
+    
+    // Required signers are the first numRequiredSignatures account keys,
+    // and signature slot i belongs to key i
+    for (uint8_t slot = 0; slot < signerCount; slot++) {
+        if (memcmp(wire + keysOffset + slot * SOLDUINO_PUBKEY_SIZE, pub, SOLDUINO_PUBKEY_SIZE) != 0) {
+            continue;
+        }
+        uint8_t* signature = wire + messageOffset - (signerCount - slot) * SIGNATURE_SIZE;
+        if (!signer.sign(message(), messageLength(), signature)) {
+            return false;
+        }
+        signedMask |= (uint32_t)1 << slot;
+        return true;
+    }
+    return false;
+}
+
+bool TransactionTemplate::isSigned() const {
+    return wireLength != 0 && signedMask == (uint32_t)(((uint64_t)1 << signerCount) - 1);
+}
+
+const uint8_t* TransactionTemplate::data() const {
+    return isSigned() ? wire : nullptr;
+}
+
+bool TransactionTemplate::encode(char* output, size_t outputLen, TransactionEncoding encoding) const {
+    if (!output || outputLen == 0 || !isSigned()) {
+        return false;
+    }
+    
+    switch (encoding) {
+        case TX_ENCODING_BASE64:
+            return Base64::encode(wire, wireLength, output, outputLen) > 0;
+        case TX_ENCODING_BASE58:
+            return base58EncodeLarge(wire, wireLength, output, outputLen) > 0;
+    }
+    return false;
+}
@@ -0,0 +1,176 @@
+#ifndef SOLDUINO_TRANSACTION_TEMPLATE_H
+#define SOLDUINO_TRANSACTION_TEMPLATE_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "transaction.h"
+#include "serializer.h"
+
+// ============================================================================
+// Solduino Transaction Template Module
+// ============================================================================
+// Serializes a transaction once and re-sends it with new values:
+// - Blockhash and named instruction-data fields are patched in place
+// - Signing works directly on the serialized message bytes
+// - Encoding reads the prebuilt wire buffer, with no re-serialization
+// ============================================================================
+
+// Largest serialized transaction a template holds (Solana's packet limit)
+#ifndef SOLDUINO_TEMPLATE_MAX_SIZE
+#define SOLDUINO_TEMPLATE_MAX_SIZE 1232
+#endif
+
+// Named fields per template
+#ifndef SOLDUINO_TEMPLATE_MAX_FIELDS
+#define SOLDUINO_TEMPLATE_MAX_FIELDS 8
+#endif
+
+// Instructions a template indexes
+#ifndef SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS
+#define SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS 8
+#endif
+
+#define SOLDUINO_TEMPLATE_FIELD_NAME 16   // including the terminator
+
+class Keypair;
+
+/**
+ * Pre-compiled transaction.
+ *
+ * compile() serializes a message once into a wire buffer laid out as
+ * [signature count | signatures | message], and records where the
+ * blockhash and each instruction's data start. After that, every send is
+ * a few memcpy()s into the message plus one Ed25519 signature per signer.
+ * Patching bytes to a new value invalidates all signatures, and data() / encode()
+ * refuse to hand out a transaction with a missing signature.
+ *
+ * Usage:
+ *   Instruction ix;
+ *   ix.setProgram(programId);
+ *   ix.addKey(authorityPub, true, true);
+ *   ix.writeBytes(discriminator, 8);
+ *   ix.writeI64LE(0);                        // value, patched per reading
+ *   Transaction tx;
+ *   tx.add(ix);
+ *
+ *   TransactionTemplate tmpl;
+ *   tmpl.compile(tx);
+ *   tmpl.addField("value", 0, 8, 8);         // instruction 0, data bytes 8..15
+ *
+ *   tmpl.setBlockhash(blockhash);
+ *   tmpl.setI64("value", reading);
+ *   tmpl.sign(authorityKeypair);
+ *   tmpl.encode(out, sizeof(out), TX_ENCODING_BASE58);
+ */
+class TransactionTemplate {
+public:
+    TransactionTemplate();
+
+    /**
+     * Compile and serialize a message. Any blockhash already set is kept
+     * and can be replaced with setBlockhash(). Clears fields and signatures.
+     * @param message Message to serialize
+     * @return false if the message has no instructions or signers, more
+     *         than SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS, or does not fit in
+     *         SOLDUINO_TEMPLATE_MAX_SIZE
+     */
+    bool compile(const MessageBase& message);
+    bool compile(const TransactionBase& transaction) { return compile(transaction.getMessage()); }
+
+    /**
+     * Name a range of an instruction's data for later patching.
+     * @param name        Field name (up to SOLDUINO_TEMPLATE_FIELD_NAME - 1 characters)
+     * @param instruction Instruction index in the message
+     * @param offset      Byte offset within the instruction data
+     * @param length      Field length in bytes
+     * @return Field index, or -1 if the range lies outside the data, the
+     *         name is taken or too long, or the field table is full
+     */
+    int8_t addField(const char* name, uint8_t instruction, uint16_t offset, uint16_t length);
+
+    /**
+     * Look up a field by name.
+     * @return Field index, or -1 if not defined
+     */
+    int8_t findField(const char* name) const;
+
+    /**
+     * Patch the recent blockhash.
+     * @param blockhash Blockhash (32 bytes)
+     * @return true if successful
+     */
+    bool setBlockhash(const uint8_t* blockhash);
+
+    /**
+     * Patch a field with raw bytes.
+     * @param length Must equal the field length
+     * @return true if successful
+     */
+    bool setField(int8_t field, const uint8_t* bytes, uint16_t length);
+    bool setField(const char* name, const uint8_t* bytes, uint16_t length);
+
+    /**
+     * Patch an 8-byte field with a little-endian integer.
+     * @return true if successful
+     */
+    bool setI64(const char* name, int64_t value);
+    bool setU64(const char* name, uint64_t value);
+
+    /**
+     * Sign the current message bytes and place the signature in the
+     * signer's slot. Other signers' slots are left alone.
+     * @param signer Initialized keypair; must be a required signer
+     * @return true if successful
+     */
+    bool sign(const Keypair& signer);
+
+    /** @return true once every required signer has signed the current bytes */
+    bool isSigned() const;
+
+    /**
+     * Serialized transaction, or nullptr until compiled and fully signed.
+     */
+    const uint8_t* data() const;
+    uint16_t length() const { return wireLength; }
+
+    /**
+     * Serialized message (the bytes that get signed).
+     */
+    const uint8_t* message() const { return wire + messageOffset; }
+    uint16_t messageLength() const { return wireLength - messageOffset; }
+
+    /**
+     * Encode the signed transaction for sendTransaction.
+     * @param output    Output string buffer
+     * @param outputLen Maximum output length
+     * @param encoding  Base64 or Base58
+     * @return true if successful
+     */
+    bool encode(char* output, size_t outputLen, TransactionEncoding encoding = TX_ENCODING_BASE64) const;
+
+private:
+    struct Field {
+        char name[SOLDUINO_TEMPLATE_FIELD_NAME];
+        uint16_t offset;    // into wire
+        uint16_t length;
+    };
+
+    uint8_t wire[SOLDUINO_TEMPLATE_MAX_SIZE];
+    uint16_t wireLength;
+    uint16_t messageOffset;
+    uint16_t keysOffset;
+    uint16_t blockhashOffset;
+    uint16_t dataOffsets[SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS];   // into wire
+    uint16_t dataLengths[SOLDUINO_TEMPLATE_MAX_INSTRUCTIONS];
+    uint8_t instructionCount;
+    uint8_t signerCount;
+    uint32_t signedMask;                      // bit i: slot i signed the current bytes
+
+    Field fields[SOLDUINO_TEMPLATE_MAX_FIELDS];
+    uint8_t fieldCount;
+
+    bool locateMessageParts();
+    bool patch(uint16_t offset, const uint8_t* bytes, uint16_t length);
+};
+
+#endif // SOLDUINO_TRANSACTION_TEMPLATE_H
@@ -0,0 +1,279 @@
+#include "transaction_view.h"
+#include "serializer.h"
+#include "crypto.h"
+#include "keypair.h"
+#include <string.h>
+
+// ============================================================================
+// Wire Format Helpers
+// ============================================================================
+
+// Advance pos over count bytes, failing if they run past the end
+static bool skip(uint16_t inLen, uint16_t& pos, uint32_t count) {
+    if ((uint32_t)pos + count > inLen) {
+        return false;
+    }
+    pos += (uint16_t)count;
+    return true;
+}
+
+static bool isBlank(const uint8_t* signature) {
+    for (uint8_t i = 0; i < SIGNATURE_SIZE; i++) {
+        if (signature[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// TransactionView Implementation
+// ============================================================================
+
+TransactionView::TransactionView() {
+    clear();
+}
+
+void TransactionView::clear() {
+    wire = nullptr;
+    writable = nullptr;
+    wireLength = 0;
+    messageOffset = 0;
+    keysOffset = 0;
+    blockhashOffset = 0;
+    lookupsOffset = 0;
+    memset(&header, 0, sizeof(header));
+    keyCount = 0;
+    loadedCount = 0;
+    instructionCount = 0;
+    lookupCount = 0;
+    versioned = false;
+}
+
+bool TransactionView::parse(uint8_t* data, uint16_t length) {
+    if (!parse((const uint8_t*)data, length)) {
+        return false;
+    }
+    writable = data;
+    return true;
+}
+
+bool TransactionView::parse(const uint8_t* data, uint16_t length) {
+    clear();
+    if (!data || length == 0) {
+        return false;
+    }
+
+    // Signatures
+    uint16_t pos = 0;
+    uint16_t signatureCount;
+    if (!TransactionSerializer::readCompactU16(data, length, pos, signatureCount) ||
+        !skip(length, pos, (uint32_t)signatureCount * SIGNATURE_SIZE)) {
+        return false;
+    }
+    messageOffset = pos;
+
+    // Version prefix: high bit set, only version 0 is defined
+    if (pos < length && (data[pos] & MESSAGE_VERSION_PREFIX)) {
+        if ((data[pos] & ~MESSAGE_VERSION_PREFIX) != 0) {
+            return false;
+        }
+        versioned = true;
+        pos++;
+    }
+
+    // Header: one signature per required signer, and a writable fee payer
+    if (!skip(length, pos, 3)) {
+        return false;
+    }
+    header.numRequiredSignatures = data[pos - 3];
+    header.numReadonlySignedAccounts = data[pos - 2];
+    header.numReadonlyUnsignedAccounts = data[pos - 1];
+    if (header.numRequiredSignatures != signatureCount ||
+        header.numReadonlySignedAccounts >= header.numRequiredSignatures) {
+        return false;
+    }
+
+    // Static account keys and blockhash
+    if (!TransactionSerializer::readCompactU16(data, length, pos, keyCount)) {
+        return false;
+    }
+    keysOffset = pos;
+    if (!skip(length, pos, (uint32_t)keyCount * SOLDUINO_PUBKEY_SIZE) ||
+        (uint16_t)header.numRequiredSignatures + header.numReadonlyUnsignedAccounts > keyCount) {
+        return false;
+    }
+    blockhashOffset = pos;
+    if (!skip(length, pos, BLOCKHASH_SIZE)) {
+        return false;
+    }
+
+    // Instructions: program index, account indexes, data
+    if (!TransactionSerializer::readCompactU16(data, length, pos, instructionCount) ||
+        instructionCount > SOLDUINO_VIEW_MAX_INSTRUCTIONS) {
+        return false;
+    }
+    for (uint16_t i = 0; i < instructionCount; i++) {
+        instructionOffsets[i] = pos;
+        uint16_t count;
+        if (!skip(length, pos, 1) ||
+            !TransactionSerializer::readCompactU16(data, length, pos, count) || !skip(length, pos, count) ||
+            !TransactionSerializer::readCompactU16(data, length, pos, count) || !skip(length, pos, count)) {
+            return false;
+        }
+    }
+
+    // v0 address table lookups; each must load at least one key
+    if (versioned) {
+        if (!TransactionSerializer::readCompactU16(data, length, pos, lookupCount)) {
+            return false;
+        }
+        lookupsOffset = pos;
+        for (uint16_t i = 0; i < lookupCount; i++) {
+            uint16_t writableCount;
+            uint16_t readonlyCount;
+            if (!skip(length, pos, SOLDUINO_PUBKEY_SIZE) ||
+                !TransactionSerializer::readCompactU16(data, length, pos, writableCount) ||
+                !skip(length, pos, writableCount) ||
+                !TransactionSerializer::readCompactU16(data, length, pos, readonlyCount) ||
+                !skip(length, pos, readonlyCount) ||
+                writableCount + readonlyCount == 0) {
+                return false;
+            }
+            loadedCount += writableCount + readonlyCount;
+        }
+    }
+
+    // Nothing may follow the message, and message indexes are u8
+    if (pos != length || (uint32_t)keyCount + loadedCount > 256) {
+        return false;
+    }
+
+    // Programs are static keys other than the fee payer; accounts may be
+    // any key, loaded ones included
+    wire = data;
+    wireLength = length;
+    uint16_t totalAccounts = getTotalAccountCount();
+    for (uint16_t i = 0; i < instructionCount; i++) {
+        InstructionView ix;
+        getInstruction(i, ix);
+        if (ix.programIdIndex == 0 || ix.programIdIndex >= keyCount) {
+            clear();
+            return false;
+        }
+        for (uint16_t a = 0; a < ix.accountCount; a++) {
+            if (ix.accountIndices[a] >= totalAccounts) {
+                clear();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const uint8_t* TransactionView::getSignature(uint8_t index) const {
+    if (!wire || index >= header.numRequiredSignatures) {
+        return nullptr;
+    }
+    return wire + messageOffset - (uint16_t)(header.numRequiredSignatures - index) * SIGNATURE_SIZE;
+}
+
+bool TransactionView::hasSignature(uint8_t index) const {
+    const uint8_t* signature = getSignature(index);
+    return signature && !isBlank(signature);
+}
+
+const uint8_t* TransactionView::getAccountKey(uint16_t index) const {
+    if (!wire || index >= keyCount) {
+        return nullptr;
+    }
+    return wire + keysOffset + index * SOLDUINO_PUBKEY_SIZE;
+}
+
+bool TransactionView::getInstruction(uint16_t index, InstructionView& instruction) const {
+    if (!wire || index >= instructionCount) {
+        return false;
+    }
+
+    // Offsets were bounds-checked by parse()
+    uint16_t pos = instructionOffsets[index];
+    instruction.programIdIndex = wire[pos++];
+    TransactionSerializer::readCompactU16(wire, wireLength, pos, instruction.accountCount);
+    instruction.accountIndices = wire + pos;
+    pos += instruction.accountCount;
+    TransactionSerializer::readCompactU16(wire, wireLength, pos, instruction.dataLength);
+    instruction.data = wire + pos;
+    return true;
+}
+
+bool TransactionView::getAddressTableLookup(uint16_t index, AddressTableLookupView& lookup) const {
+    if (!wire || index >= lookupCount) {
+        return false;
+    }
+
+    uint16_t pos = lookupsOffset;
+    for (uint16_t i = 0;; i++) {
+        lookup.tableKey = wire + pos;
+        pos += SOLDUINO_PUBKEY_SIZE;
+        TransactionSerializer::readCompactU16(wire, wireLength, pos, lookup.writableCount);
+        lookup.writableIndexes = wire + pos;
+        pos += lookup.writableCount;
+        TransactionSerializer::readCompactU16(wire, wireLength, pos, lookup.readonlyCount);
+        lookup.readonlyIndexes = wire + pos;
+        pos += lookup.readonlyCount;
+        if (i == index) {
+            return true;
+        }
+    }
+}
+
+int16_t TransactionView::findSigner(const uint8_t* pubkey) const {
+    if (!wire || !pubkey) {
+        return -1;
+    }
+    for (uint8_t slot = 0; slot < header.numRequiredSignatures; slot++) {
+        if (memcmp(getAccountKey(slot), pubkey, SOLDUINO_PUBKEY_SIZE) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool TransactionView::verifyAll(bool* results) const {
+    if (!wire) {
+        return false;
+    }
+
+    // Each slot is checked with verifySignature(): the cofactored batch
+    // verifier may accept crafted signatures that it rejects
+    bool allValid = true;
+    for (uint8_t slot = 0; slot < header.numRequiredSignatures; slot++) {
+        bool valid = hasSignature(slot) &&
+                     verifySignature(getMessage(), getMessageLength(),
+                                     getSignature(slot), getAccountKey(slot));
+        if (!valid) {
+            allValid = false;
+        }
+        if (results) {
+            results[slot] = valid;
+        }
+    }
+    return allValid;
+}
+
+bool TransactionView::sign(const Keypair& signer) {
+    if (!writable || !signer.isInitialized()) {
+        return false;
+    }
+
+    uint8_t pub[SOLDUINO_PUBKEY_SIZE];
+    if (!signer.getPublicKey(pub)) {
+        return false;
+    }
+    int16_t slot = findSigner(pub);
+    if (slot < 0) {
+        return false;
+    }
+    uint8_t* signature = writable + (getSignature((uint8_t)slot) - wire);
+    return signer.sign(getMessage(), getMessageLength(), signature);
+}
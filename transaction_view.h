@@ -0,0 +1,185 @@
+#ifndef SOLDUINO_TRANSACTION_VIEW_H
+#define SOLDUINO_TRANSACTION_VIEW_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "transaction.h"
+
+// ============================================================================
+// Solduino Transaction View Module
+// ============================================================================
+// Reads serialized transactions in place:
+// - Validates legacy and v0 wire format in one pass, without copying
+// - Pointer access to signatures, keys, blockhash, instructions, lookups
+// - Batch-verifies every signature, and co-signs into the caller's buffer
+// ============================================================================
+
+// Instructions a view indexes
+#ifndef SOLDUINO_VIEW_MAX_INSTRUCTIONS
+#define SOLDUINO_VIEW_MAX_INSTRUCTIONS 64
+#endif
+
+/**
+ * One instruction inside a parsed transaction. Pointers refer to the
+ * parsed buffer.
+ */
+struct InstructionView {
+    uint8_t programIdIndex;
+    const uint8_t* accountIndices;
+    uint16_t accountCount;
+    const uint8_t* data;
+    uint16_t dataLength;
+};
+
+/**
+ * One address table lookup of a parsed v0 transaction
+ */
+struct AddressTableLookupView {
+    const uint8_t* tableKey;          // 32 bytes
+    const uint8_t* writableIndexes;
+    uint16_t writableCount;
+    const uint8_t* readonlyIndexes;
+    uint16_t readonlyCount;
+};
+
+class Keypair;
+
+/**
+ * Zero-copy transaction reader.
+ *
+ * parse() walks the wire format once, checks it the way a validator
+ * sanitizes it (canonical compact-u16s, one signature per required signer,
+ * header and index bounds, no trailing bytes), and records where each
+ * part starts. Every getter then returns pointers into the parsed buffer,
+ * which must outlive the view.
+ *
+ * Usage:
+ *   TransactionView view;
+ *   if (view.parse(wire, wireLen) && view.verifyAll()) {
+ *       InstructionView ix;
+ *       view.getInstruction(0, ix);
+ *   }
+ *
+ *   // Co-sign a partially signed transaction in place
+ *   if (view.parse(wire, wireLen) && view.sign(gatewayKeypair)) {
+ *       ...send wire...
+ *   }
+ */
+class TransactionView {
+public:
+    TransactionView();
+
+    /**
+     * Validate and index a serialized transaction.
+     * @param data   Wire-format transaction
+     * @param length Length of data
+     * @return false if the bytes are not a well-formed legacy or v0
+     *         transaction, or it has more than SOLDUINO_VIEW_MAX_INSTRUCTIONS
+     */
+    bool parse(const uint8_t* data, uint16_t length);
+
+    /**
+     * As parse(const uint8_t*, uint16_t), and allow sign() to write
+     * signatures into data.
+     */
+    bool parse(uint8_t* data, uint16_t length);
+
+    bool isValid() const { return wire != nullptr; }
+
+    /** @return true for v0 transactions */
+    bool isVersioned() const { return versioned; }
+
+    const uint8_t* data() const { return wire; }
+    uint16_t length() const { return wireLength; }
+
+    /** Serialized message (the bytes every signature covers) */
+    const uint8_t* getMessage() const { return wire + messageOffset; }
+    uint16_t getMessageLength() const { return wireLength - messageOffset; }
+
+    uint8_t getSignatureCount() const { return header.numRequiredSignatures; }
+
+    /**
+     * @return Signature in slot index (64 bytes), or nullptr if out of range
+     */
+    const uint8_t* getSignature(uint8_t index) const;
+
+    /** @return true if slot index holds a non-zero signature */
+    bool hasSignature(uint8_t index) const;
+
+    TransactionHeader getHeader() const { return header; }
+
+    /** Static account keys (keys loaded through lookups are not included) */
+    uint16_t getAccountKeyCount() const { return keyCount; }
+
+    /**
+     * @return Static account key (32 bytes), or nullptr if out of range
+     */
+    const uint8_t* getAccountKey(uint16_t index) const;
+
+    /** Static plus loaded keys; instruction indexes are below this */
+    uint16_t getTotalAccountCount() const { return keyCount + loadedCount; }
+
+    /** @return Recent blockhash (32 bytes) */
+    const uint8_t* getRecentBlockhash() const { return wire ? wire + blockhashOffset : nullptr; }
+
+    uint16_t getInstructionCount() const { return instructionCount; }
+
+    /**
+     * @param index       Instruction index
+     * @param instruction Output: pointers into the parsed buffer
+     * @return false if index is out of range
+     */
+    bool getInstruction(uint16_t index, InstructionView& instruction) const;
+
+    uint16_t getAddressTableLookupCount() const { return lookupCount; }
+
+    /**
+     * @param index  Lookup index (walked from the first lookup)
+     * @param lookup Output: pointers into the parsed buffer
+     * @return false if index is out of range
+     */
+    bool getAddressTableLookup(uint16_t index, AddressTableLookupView& lookup) const;
+
+    /**
+     * Signature slot of a required signer.
+     * @param pubkey Public key (32 bytes)
+     * @return Slot index, or -1 if pubkey is not a required signer
+     */
+    int16_t findSigner(const uint8_t* pubkey) const;
+
+    /**
+     * Verify every signature against the message with
+     * verifySignature(). Empty slots count as failures.
+     * @param results Optional output, one verdict per signature slot
+     * @return true if every required signature is present and valid
+     */
+    bool verifyAll(bool* results = nullptr) const;
+
+    /**
+     * Sign the message and write the signature into the signer's slot.
+     * Needs a view parsed over a writable buffer.
+     * @param signer Keypair of a required signer
+     * @return true if successful
+     */
+    bool sign(const Keypair& signer);
+
+private:
+    const uint8_t* wire;
+    uint8_t* writable;                // wire, when parsed over a writable buffer
+    uint16_t wireLength;
+    uint16_t messageOffset;
+    uint16_t keysOffset;
+    uint16_t blockhashOffset;
+    uint16_t lookupsOffset;
+    uint16_t instructionOffsets[SOLDUINO_VIEW_MAX_INSTRUCTIONS];
+    TransactionHeader header;
+    uint16_t keyCount;
+    uint16_t loadedCount;
+    uint16_t instructionCount;
+    uint16_t lookupCount;
+    bool versioned;
+
+    void clear();
+};
+
+#endif // SOLDUINO_TRANSACTION_VIEW_H
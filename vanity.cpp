@@ -0,0 +1,512 @@
+#include "vanity.h"
+#include "crypto_backend.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <initializer_list>
+
+#if SOLDUINO_VANITY_THREADS
+#include "worker_pool.h"
+#endif
+
+// Candidates each worker tries between checks of the shared counters
+#define VANITY_BATCH 64
+
+// Public keys with a non-zero first byte lie in [2^248, 2^256) and so
+// encode to 43 or 44 Base58 digits (58^42 < 2^248, 58^44 > 2^256)
+#define VANITY_MIN_DIGITS 43
+#define VANITY_MAX_DIGITS 44
+
+static int vanityDigit(char c) {
+    if (c == '\0') return -1;
+    const char* p = strchr(BASE58_ALPHABET, c);
+    return p ? (int)(p - BASE58_ALPHABET) : -1;
+}
+
+/**
+ * Allowed digits for one pattern character: the character itself and,
+ * with ignoreCase, its other case (when that is in the alphabet).
+ */
+static uint64_t vanityMask(char c, bool ignoreCase) {
+    uint64_t mask = 0;
+    int d = vanityDigit(c);
+    if (d >= 0) mask |= (uint64_t)1 << d;
+    if (ignoreCase && isalpha((unsigned char)c)) {
+        char other = islower((unsigned char)c) ? (char)toupper((unsigned char)c) : (char)tolower((unsigned char)c);
+        d = vanityDigit(other);
+        if (d >= 0) mask |= (uint64_t)1 << d;
+    }
+    return mask;
+}
+
+static void vanityWipe(void* buf, size_t len) {
+    volatile uint8_t* p = (volatile uint8_t*)buf;
+    while (len--) {
+        *p++ = 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 288-bit scratch integers for range bounds (58^44 < 2^258)
+// ----------------------------------------------------------------------------
+
+#define VANITY_BN_WORDS 9
+typedef uint32_t vanityBn[VANITY_BN_WORDS];   // little-endian words
+
+static void bnMulAdd(vanityBn a, uint32_t mul, uint32_t add) {
+    uint64_t carry = add;
+    for (int i = 0; i < VANITY_BN_WORDS; i++) {
+        uint64_t t = (uint64_t)a[i] * mul + carry;
+        a[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+}
+
+static void bnDecrement(vanityBn a) {
+    for (int i = 0; i < VANITY_BN_WORDS; i++) {
+        if (a[i]-- != 0) break;
+    }
+}
+
+// Big-endian bytes of min(a, 2^256 - 1)
+static void bnToBytes(uint8_t out[32], const vanityBn a) {
+    if (a[8] != 0) {
+        memset(out, 0xFF, 32);
+        return;
+    }
+    for (int i = 0; i < 8; i++) {
+        out[31 - 4 * i] = (uint8_t)a[i];
+        out[30 - 4 * i] = (uint8_t)(a[i] >> 8);
+        out[29 - 4 * i] = (uint8_t)(a[i] >> 16);
+        out[28 - 4 * i] = (uint8_t)(a[i] >> 24);
+    }
+}
+
+// ============================================================================
+// VanityGrinder
+// ============================================================================
+
+struct VanityGrinder::Job {
+    VanityGrinder* grinder;
+    uint8_t baseSeed[SOLDUINO_SEED_SIZE];
+    uint64_t maxAttempts;
+    uint8_t* publicKey;
+    uint8_t* privateKey;
+#if SOLDUINO_VANITY_THREADS
+    std::atomic<bool> found;
+#else
+    bool found;
+#endif
+};
+
+VanityGrinder::VanityGrinder()
+    : ranges(nullptr), rangeCount(0), prefixLen(0), suffixLen(0), suffixModulus(1),
+      progress(nullptr), progressContext(nullptr), progressIntervalMs(1000),
+      startMs(0), elapsedMs(0), attempts(0), stopRequested(false), running(false) {
+    memset(prefixMasks, 0, sizeof(prefixMasks));
+    memset(suffixMasks, 0, sizeof(suffixMasks));
+}
+
+VanityGrinder::~VanityGrinder() {
+    free(ranges);
+}
+
+bool VanityGrinder::setPattern(const char* prefix, const char* suffix, bool ignoreCase) {
+    size_t pLen = prefix ? strlen(prefix) : 0;
+    size_t sLen = suffix ? strlen(suffix) : 0;
+    if (pLen > SOLDUINO_VANITY_MAX_PREFIX || sLen > SOLDUINO_VANITY_MAX_SUFFIX) {
+        return false;
+    }
+
+    uint64_t pMasks[SOLDUINO_VANITY_MAX_PREFIX];
+    uint64_t sMasks[SOLDUINO_VANITY_MAX_SUFFIX];
+    for (size_t i = 0; i < pLen; i++) {
+        pMasks[i] = vanityMask(prefix[i], ignoreCase);
+        if (!pMasks[i]) return false;
+    }
+    for (size_t i = 0; i < sLen; i++) {
+        sMasks[i] = vanityMask(suffix[i], ignoreCase);
+        if (!sMasks[i]) return false;
+    }
+
+    memcpy(prefixMasks, pMasks, pLen * sizeof(uint64_t));
+    memcpy(suffixMasks, sMasks, sLen * sizeof(uint64_t));
+    prefixLen = (uint8_t)pLen;
+    suffixLen = (uint8_t)sLen;
+    suffixModulus = 1;
+    for (size_t i = 0; i < sLen; i++) {
+        suffixModulus *= 58;
+    }
+    return buildRanges();
+}
+
+/**
+ * One range per case variant of the prefix and per address length: the
+ * 43- and 44-digit numbers starting with digits P are exactly
+ * [P * 58^(L-k), (P+1) * 58^(L-k)). Variants are enumerated in digit
+ * order and lengths in increasing order, so the list comes out sorted.
+ */
+bool VanityGrinder::buildRanges() {
+    free(ranges);
+    ranges = nullptr;
+    rangeCount = 0;
+    if (prefixLen == 0) {
+        return true;
+    }
+
+    // A leading '1' is a zero byte, which only the encoding path sees
+    uint8_t options[SOLDUINO_VANITY_MAX_PREFIX][2];
+    uint8_t optionCount[SOLDUINO_VANITY_MAX_PREFIX];
+    size_t variants = 1;
+    for (uint8_t i = 0; i < prefixLen; i++) {
+        uint64_t mask = prefixMasks[i] & (i == 0 ? ~(uint64_t)1 : ~(uint64_t)0);
+        optionCount[i] = 0;
+        for (int d = 0; d < 58; d++) {
+            if (mask & ((uint64_t)1 << d)) {
+                options[i][optionCount[i]++] = (uint8_t)d;
+            }
+        }
+        variants *= optionCount[i];
+    }
+    if (variants == 0) {
+        return true;
+    }
+
+    ranges = (Range*)malloc(variants * (VANITY_MAX_DIGITS - VANITY_MIN_DIGITS + 1) * sizeof(Range));
+    if (!ranges) {
+        prefixLen = 0;
+        suffixLen = 0;
+        return false;
+    }
+
+    for (int digits = VANITY_MIN_DIGITS; digits <= VANITY_MAX_DIGITS; digits++) {
+        uint8_t pick[SOLDUINO_VANITY_MAX_PREFIX] = {0};
+        for (size_t v = 0; v < variants; v++) {
+            vanityBn low = {0}, high = {0};
+            for (uint8_t i = 0; i < prefixLen; i++) {
+                uint8_t d = options[i][pick[i]];
+                bnMulAdd(low, 58, d);
+                bnMulAdd(high, 58, i + 1 == prefixLen ? d + 1 : d);
+            }
+            for (int i = prefixLen; i < digits; i++) {
+                bnMulAdd(low, 58, 0);
+                bnMulAdd(high, 58, 0);
+            }
+            bnDecrement(high);
+
+            // Clip to [2^248, 2^256)
+            Range& r = ranges[rangeCount];
+            bnToBytes(r.low, low);
+            bnToBytes(r.high, high);
+            if (low[8] == 0 && (high[8] != 0 || high[7] >= 0x01000000)) {
+                if (r.low[0] == 0) {
+                    memset(r.low, 0, 32);
+                    r.low[0] = 1;
+                }
+                rangeCount++;
+            }
+
+            // Next variant, last position fastest
+            for (int i = prefixLen - 1; i >= 0; i--) {
+                if (++pick[i] < optionCount[i]) break;
+                pick[i] = 0;
+            }
+        }
+    }
+    return true;
+}
+
+bool VanityGrinder::matchesEncoded(const uint8_t* publicKey) const {
+    char address[64];
+    size_t len = base58Encode32(publicKey, address, sizeof(address));
+    if (len < prefixLen || len < suffixLen) {
+        return false;
+    }
+    for (uint8_t i = 0; i < prefixLen; i++) {
+        if (!(prefixMasks[i] & ((uint64_t)1 << vanityDigit(address[i])))) return false;
+    }
+    for (uint8_t i = 0; i < suffixLen; i++) {
+        if (!(suffixMasks[i] & ((uint64_t)1 << vanityDigit(address[len - suffixLen + i])))) return false;
+    }
+    return true;
+}
+
+bool VanityGrinder::matches(const uint8_t* publicKey) const {
+    if (!publicKey) return false;
+    if (publicKey[0] == 0) {
+        return matchesEncoded(publicKey);
+    }
+
+    if (prefixLen > 0) {
+        // Last range starting at or below the key
+        size_t lo = 0, hi = rangeCount;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (memcmp(ranges[mid].low, publicKey, 32) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0 || memcmp(publicKey, ranges[lo - 1].high, 32) > 0) {
+            return false;
+        }
+    }
+
+    if (suffixLen > 0) {
+        // The last k digits are the key mod 58^k; r < 2^56 so r * 256 fits
+        uint64_t r = 0;
+        for (int i = 0; i < 32; i++) {
+            r = ((r << 8) | publicKey[i]) % suffixModulus;
+        }
+        for (int i = suffixLen - 1; i >= 0; i--) {
+            if (!(suffixMasks[i] & ((uint64_t)1 << (r % 58)))) return false;
+            r /= 58;
+        }
+    }
+    return true;
+}
+
+void VanityGrinder::runWorker(void* context, unsigned index) {
+    Job* job = (Job*)context;
+    job->grinder->work(job, index);
+}
+
+void VanityGrinder::work(Job* job, unsigned index) {
+    // Each attempt XORs a counter into the low bytes of a random base
+    // seed; workers differ in byte 23
+    uint8_t seed[SOLDUINO_SEED_SIZE];
+    uint8_t publicKey[SOLDUINO_PUBKEY_SIZE];
+    uint8_t privateKey[SOLDUINO_SECRETKEY_SIZE];
+    memcpy(seed, job->baseSeed, sizeof(seed));
+    seed[23] ^= (uint8_t)index;
+
+    uint64_t counter = 0;
+    unsigned long lastReport = millis();
+    while (!stopRequested && !job->found) {
+        unsigned done = 0;
+        bool hit = false;
+        while (done < VANITY_BATCH && !hit) {
+            counter++;
+            for (int b = 0; b < 8; b++) {
+                seed[24 + b] = job->baseSeed[24 + b] ^ (uint8_t)(counter >> (8 * b));
+            }
+            if (!generateKeypairFromSeed(seed, publicKey, privateKey)) {
+                stopRequested = true;
+                break;
+            }
+            done++;
+            hit = matches(publicKey);
+        }
+        uint64_t total = (attempts += done);
+
+        if (hit) {
+#if SOLDUINO_VANITY_THREADS
+            bool first = !job->found.exchange(true);
+#else
+            bool first = !job->found;
+            job->found = true;
+#endif
+            if (first) {
+                memcpy(job->publicKey, publicKey, SOLDUINO_PUBKEY_SIZE);
+                memcpy(job->privateKey, privateKey, SOLDUINO_SECRETKEY_SIZE);
+            }
+            break;
+        }
+        if (job->maxAttempts && total >= job->maxAttempts) {
+            stopRequested = true;
+        }
+        if (index == 0 && progress && millis() - lastReport >= progressIntervalMs) {
+            lastReport = millis();
+            if (!progress(total, getKeysPerSecond(), progressContext)) {
+                stopRequested = true;
+            }
+        }
+    }
+
+    vanityWipe(seed, sizeof(seed));
+    vanityWipe(privateKey, sizeof(privateKey));
+}
+
+bool VanityGrinder::grind(uint8_t* publicKey, uint8_t* privateKey, unsigned threads, uint64_t maxAttempts) {
+    if (!publicKey || !privateKey || running) return false;
+
+    // Start the crypto backend here rather than racing on it in the workers
+    if (!cryptoBegin()) return false;
+
+    Job job;
+    job.grinder = this;
+    job.maxAttempts = maxAttempts;
+    job.publicKey = publicKey;
+    job.privateKey = privateKey;
+    job.found = false;
+    if (!cryptoBackend()->randomBytes(job.baseSeed, sizeof(job.baseSeed))) {
+        return false;
+    }
+
+    attempts = 0;
+    stopRequested = false;
+    running = true;
+    startMs = millis();
+
+#if SOLDUINO_VANITY_THREADS
+    runWorkers(runWorker, &job, threads, SOLDUINO_VANITY_MAX_THREADS, SOLDUINO_VANITY_STACK);
+#else
+    (void)threads;
+    work(&job, 0);
+#endif
+
+    elapsedMs = millis() - startMs;
+    running = false;
+    vanityWipe(job.baseSeed, sizeof(job.baseSeed));
+    return job.found;
+}
+
+void VanityGrinder::setProgressCallback(VanityProgressCallback callback, void* context, uint32_t intervalMs) {
+    progress = callback;
+    progressContext = context;
+    progressIntervalMs = intervalMs;
+}
+
+void VanityGrinder::cancel() {
+    stopRequested = true;
+}
+
+uint64_t VanityGrinder::getAttempts() const {
+    return attempts;
+}
+
+float VanityGrinder::getKeysPerSecond() const {
+    unsigned long elapsed = running ? millis() - startMs : elapsedMs;
+    if (elapsed == 0) return 0.0f;
+    return (float)((double)attempts * 1000.0 / elapsed);
+}
+
+// ============================================================================
+// Self-test
+// ============================================================================
+
+// Straightforward check on the encoded address
+static bool vanityReferenceMatch(const uint8_t* publicKey, const char* prefix, const char* suffix, bool ignoreCase) {
+    char address[64];
+    size_t len = base58Encode32(publicKey, address, sizeof(address));
+    size_t pLen = prefix ? strlen(prefix) : 0;
+    size_t sLen = suffix ? strlen(suffix) : 0;
+    if (len < pLen || len < sLen) return false;
+    for (size_t i = 0; i < pLen + sLen; i++) {
+        char a = i < pLen ? address[i] : address[len - sLen + (i - pLen)];
+        char p = i < pLen ? prefix[i] : suffix[i - pLen];
+        if (ignoreCase ? tolower((unsigned char)a) != tolower((unsigned char)p) : a != p) return false;
+    }
+    return true;
+}
+
+static void vanityAddOne(uint8_t key[32], int delta) {
+    for (int i = 31; i >= 0; i--) {
+        uint8_t before = key[i];
+        key[i] = (uint8_t)(key[i] + delta);
+        if (delta > 0 ? key[i] > before : key[i] < before) break;
+    }
+}
+
+bool testVanity() {
+    struct Pattern {
+        const char* prefix;
+        const char* suffix;
+        bool ignoreCase;
+    };
+    static const Pattern PATTERNS[] = {
+        {"A", nullptr, false},
+        {"z", nullptr, true},
+        {"1", nullptr, false},
+        {nullptr, "x", false},
+        {"So", "a", true},
+        {"9", "1", false},
+        {"Lo", nullptr, true},
+    };
+
+    bool ok = true;
+    VanityGrinder grinder;
+    for (size_t p = 0; p < sizeof(PATTERNS) / sizeof(PATTERNS[0]); p++) {
+        const Pattern& pat = PATTERNS[p];
+        if (!grinder.setPattern(pat.prefix, pat.suffix, pat.ignoreCase)) {
+            Serial.println("setPattern failed");
+            ok = false;
+            continue;
+        }
+
+        // Random keys, one in eight with a leading zero byte
+        size_t mismatches = 0;
+        for (int i = 0; i < 4000; i++) {
+            uint8_t key[32];
+            if (!cryptoBackend()->randomBytes(key, sizeof(key))) {
+                Serial.println("randomBytes failed");
+                return false;
+            }
+            if (i % 8 == 0) key[0] = 0;
+            if (grinder.matches(key) != vanityReferenceMatch(key, pat.prefix, pat.suffix, pat.ignoreCase)) {
+                mismatches++;
+            }
+        }
+
+        // Range edges: the smallest and largest 43/44-digit addresses with
+        // each case variant of the prefix, and their neighbours
+        size_t pLen = pat.prefix ? strlen(pat.prefix) : 0;
+        for (unsigned variant = 0; pLen && variant < (1u << pLen); variant++) {
+            char text[45];
+            for (size_t i = 0; i < pLen; i++) {
+                char c = pat.prefix[i];
+                if ((variant >> i) & 1) {
+                    if (!pat.ignoreCase) break;
+                    c = islower((unsigned char)c) ? (char)toupper((unsigned char)c) : (char)tolower((unsigned char)c);
+                }
+                text[i] = c;
+            }
+            for (int digits = VANITY_MIN_DIGITS; digits <= VANITY_MAX_DIGITS; digits++) {
+                for (char fill : {'1', 'z'}) {
+                    memset(text + pLen, fill, digits - pLen);
+                    text[digits] = '\0';
+                    uint8_t edge[32];
+                    if (!base58Decode32(text, edge)) continue;
+                    for (int delta = -1; delta <= 1; delta++) {
+                        uint8_t key[32];
+                        memcpy(key, edge, 32);
+                        if (delta) vanityAddOne(key, delta);
+                        if (grinder.matches(key) != vanityReferenceMatch(key, pat.prefix, pat.suffix, pat.ignoreCase)) {
+                            mismatches++;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (mismatches) {
+            Serial.print("Vanity mismatch for pattern ");
+            Serial.println((int)p);
+            ok = false;
+        }
+    }
+
+    // Invalid characters and over-long patterns are rejected
+    if (grinder.setPattern("0", nullptr) || grinder.setPattern("Ol", nullptr, false) ||
+        grinder.setPattern(nullptr, "abcdefghij")) {
+        Serial.println("Invalid vanity pattern accepted");
+        ok = false;
+    }
+
+    // A one-character grind yields a consistent keypair
+    uint8_t publicKey[32], privateKey[64], derived[32], derivedPrivate[64];
+    char address[64];
+    if (!grinder.setPattern("a", nullptr) || !grinder.grind(publicKey, privateKey, 0, 100000) ||
+        !generateKeypairFromSeed(privateKey, derived, derivedPrivate) ||
+        memcmp(derived, publicKey, 32) != 0 ||
+        !base58Encode32(publicKey, address, sizeof(address)) || address[0] != 'a') {
+        Serial.println("Vanity grind failed");
+        ok = false;
+    }
+    vanityWipe(privateKey, sizeof(privateKey));
+    vanityWipe(derivedPrivate, sizeof(derivedPrivate));
+
+    Serial.println(ok ? "All vanity tests passed" : "Vanity tests failed");
+    return ok;
+}
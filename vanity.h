@@ -0,0 +1,177 @@
+#ifndef SOLDUINO_VANITY_H
+#define SOLDUINO_VANITY_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "crypto.h"
+
+// ============================================================================
+// Solduino Vanity Module
+// ============================================================================
+// Grinds Ed25519 keypairs until the Base58 address has a chosen prefix
+// and/or suffix:
+// - Prefixes are matched as 256-bit ranges and suffixes as a residue
+//   mod 58^k, so candidates are never Base58-encoded
+// - Optional case-insensitive matching
+// - Work spread over std::thread workers, with keys/s reporting and
+//   early cancellation
+// ============================================================================
+
+// grind() spreads work over std::thread workers on ESP32 and hosted
+// builds; other boards grind on the calling thread
+#ifndef SOLDUINO_VANITY_THREADS
+#if defined(ESP32) || !defined(ARDUINO)
+#define SOLDUINO_VANITY_THREADS 1
+#else
+#define SOLDUINO_VANITY_THREADS 0
+#endif
+#endif
+
+// Upper bound on grind() worker threads
+#ifndef SOLDUINO_VANITY_MAX_THREADS
+#define SOLDUINO_VANITY_MAX_THREADS 16
+#endif
+
+// Stack of each grind() worker on ESP32; key generation needs more than
+// the 3 KB pthread default
+#ifndef SOLDUINO_VANITY_STACK
+#define SOLDUINO_VANITY_STACK 8192
+#endif
+
+// Longest supported prefix and suffix. Each extra character multiplies
+// the expected work by 58, so these are far beyond what is practical.
+#ifndef SOLDUINO_VANITY_MAX_PREFIX
+#define SOLDUINO_VANITY_MAX_PREFIX 8
+#endif
+#define SOLDUINO_VANITY_MAX_SUFFIX 9   // 58^9 < 2^56 keeps the residue in 64 bits
+
+#if SOLDUINO_VANITY_THREADS
+#include <atomic>
+#endif
+
+/**
+ * Progress report from grind(), called on the grinding thread.
+ * @param attempts      Candidates tried so far
+ * @param keysPerSecond Rate since grind() started
+ * @param context       Pointer given to setProgressCallback()
+ * @return false to stop grinding
+ */
+typedef bool (*VanityProgressCallback)(uint64_t attempts, float keysPerSecond, void* context);
+
+/**
+ * Vanity keypair grinder.
+ *
+ * setPattern() turns the prefix into a sorted list of [low, high] ranges
+ * of the big-endian public key (one per case variant and address length)
+ * and the suffix into one allowed-digit mask per position. Each candidate
+ * then costs a binary search over 32-byte compares and one reduction mod
+ * 58^k. Keys whose first byte is zero start with '1' and are checked by
+ * encoding them, which happens for 1 candidate in 256.
+ *
+ * Usage:
+ *   VanityGrinder grinder;
+ *   grinder.setPattern("sol", nullptr, true);
+ *   uint8_t pub[32], priv[64];
+ *   if (grinder.grind(pub, priv)) { ... }
+ *   Serial.println(grinder.getKeysPerSecond());
+ */
+class VanityGrinder {
+public:
+    VanityGrinder();
+    ~VanityGrinder();
+
+    VanityGrinder(const VanityGrinder&) = delete;
+    VanityGrinder& operator=(const VanityGrinder&) = delete;
+
+    /**
+     * Set the address pattern.
+     * @param prefix     Required leading characters, or nullptr/"" for none
+     * @param suffix     Required trailing characters, or nullptr/"" for none
+     * @param ignoreCase Match letters in either case
+     * @return false if a pattern is too long, contains characters that
+     *         cannot appear in an address, or memory ran out
+     */
+    bool setPattern(const char* prefix, const char* suffix, bool ignoreCase = false);
+
+    /**
+     * Test a public key against the pattern.
+     * @param publicKey 32-byte public key
+     * @return true if its address matches
+     */
+    bool matches(const uint8_t* publicKey) const;
+
+    /**
+     * Generate keypairs until one matches, cancel() is called, the progress
+     * callback returns false, or maxAttempts is reached.
+     * @param publicKey   Output public key (32 bytes)
+     * @param privateKey  Output private key (64 bytes, seed | public key)
+     * @param threads     Worker count including the caller; 0 = one per hardware thread
+     * @param maxAttempts Give up after about this many candidates; 0 = no limit
+     * @return true if a matching keypair was written
+     */
+    bool grind(uint8_t* publicKey, uint8_t* privateKey, unsigned threads = 0, uint64_t maxAttempts = 0);
+
+    /**
+     * Report progress every intervalMs while grinding.
+     */
+    void setProgressCallback(VanityProgressCallback callback, void* context, uint32_t intervalMs = 1000);
+
+    /**
+     * Stop a running grind() as soon as each worker finishes its current
+     * batch. Safe to call from another thread or from the progress callback.
+     */
+    void cancel();
+
+    /** @return candidates tried by the current or last grind() */
+    uint64_t getAttempts() const;
+
+    /** @return candidates per second of the current or last grind() */
+    float getKeysPerSecond() const;
+
+private:
+    struct Range {
+        uint8_t low[32];    // big-endian, inclusive
+        uint8_t high[32];   // big-endian, inclusive
+    };
+
+    Range* ranges;
+    size_t rangeCount;
+    uint64_t prefixMasks[SOLDUINO_VANITY_MAX_PREFIX];   // bit d: digit d allowed
+    uint64_t suffixMasks[SOLDUINO_VANITY_MAX_SUFFIX];
+    uint8_t prefixLen;
+    uint8_t suffixLen;
+    uint64_t suffixModulus;   // 58^suffixLen
+
+    VanityProgressCallback progress;
+    void* progressContext;
+    uint32_t progressIntervalMs;
+
+    unsigned long startMs;
+    unsigned long elapsedMs;
+#if SOLDUINO_VANITY_THREADS
+    std::atomic<uint64_t> attempts;
+    std::atomic<bool> stopRequested;
+    std::atomic<bool> running;
+#else
+    volatile uint64_t attempts;
+    volatile bool stopRequested;
+    volatile bool running;
+#endif
+
+    struct Job;
+
+    bool buildRanges();
+    bool matchesEncoded(const uint8_t* publicKey) const;
+    void work(Job* job, unsigned index);
+    static void runWorker(void* context, unsigned index);
+};
+
+/**
+ * Self-test: checks matches() against full Base58 encoding on random keys
+ * and on the edges of every prefix range, then grinds a short pattern.
+ * Prints mismatches to Serial.
+ * @return true if every check passes
+ */
+bool testVanity();
+
+#endif // SOLDUINO_VANITY_H
@@ -0,0 +1,90 @@
+#ifndef SOLDUINO_WORKER_POOL_H
+#define SOLDUINO_WORKER_POOL_H
+
+// Internal std::thread plumbing shared by Transaction::sign(),
+// findProgramAddresses(), VanityGrinder::grind() and RpcClient::connect().
+// Only included by builds that enable one of their *_THREADS switches.
+
+#include <stddef.h>
+#include <new>
+#include <thread>
+#ifdef ESP32
+#include <esp_pthread.h>
+#endif
+
+/**
+ * Sets the pthread stack size for std::threads started while in scope
+ * (ESP32 only; a no-op elsewhere) and then puts back the caller's own
+ * esp_pthread configuration, so a sketch's settings survive.
+ */
+class WorkerStack {
+public:
+    explicit WorkerStack(size_t stackSize) {
+#ifdef ESP32
+        // No config of its own means the thread was using the defaults
+        if (esp_pthread_get_cfg(&saved) != ESP_OK) {
+            saved = esp_pthread_get_default_config();
+        }
+        esp_pthread_cfg_t cfg = saved;
+        cfg.stack_size = stackSize;
+        esp_pthread_set_cfg(&cfg);
+#else
+        (void)stackSize;
+#endif
+    }
+
+    ~WorkerStack() {
+#ifdef ESP32
+        esp_pthread_set_cfg(&saved);
+#endif
+    }
+
+    WorkerStack(const WorkerStack&) = delete;
+    WorkerStack& operator=(const WorkerStack&) = delete;
+
+private:
+#ifdef ESP32
+    esp_pthread_cfg_t saved;
+#endif
+};
+
+typedef void (*WorkerFn)(void* context, unsigned worker);
+
+/**
+ * Run fn(context, i) for i = 0 .. workers - 1 and wait for all of them.
+ * The calling thread is worker 0; the rest are std::threads with the given
+ * stack on ESP32. fn usually pulls work items off a shared atomic counter.
+ * @param threads    Requested workers including the caller; 0 = one per
+ *                   hardware thread
+ * @param maxThreads Upper bound on workers (at least 1)
+ * @param stackSize  Stack of each extra worker on ESP32
+ * @return Number of workers that ran
+ */
+inline unsigned runWorkers(WorkerFn fn, void* context, unsigned threads, unsigned maxThreads, size_t stackSize) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads > maxThreads) threads = maxThreads;
+    if (threads == 0) threads = 1;
+
+    // Without room for the thread handles everything runs on the caller
+    std::thread* workers = nullptr;
+    if (threads > 1) {
+        workers = new (std::nothrow) std::thread[threads - 1];
+        if (!workers) threads = 1;
+    }
+    if (workers) {
+        WorkerStack stack(stackSize);
+        for (unsigned t = 1; t < threads; t++) {
+            workers[t - 1] = std::thread(fn, context, t);
+        }
+    }
+    fn(context, 0);
+    for (unsigned t = 1; t < threads; t++) {
+        workers[t - 1].join();
+    }
+    delete[] workers;
+    return threads;
+}
+
+#endif // SOLDUINO_WORKER_POOL_H